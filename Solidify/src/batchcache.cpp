@@ -0,0 +1,229 @@
+/*
+ * Solidify - texture push-pull processing utility
+ * Copyright (c) 2023-2026 Erium Vladlen.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pch.h"
+
+#include "batchcache.h"
+
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ull;
+static constexpr uint64_t kFnvPrime  = 0x100000001b3ull;
+
+static uint64_t
+fnv1a(uint64_t hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+uint64_t
+hashFileContents(const std::string& path, bool* ok)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        *ok = false;
+        return 0;
+    }
+
+    std::vector<char> chunk(1 << 20);
+    uint64_t hash = kFnvOffset;
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        hash = fnv1a(hash, chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+    *ok = file.eof();
+    return *ok ? hash : 0;
+}
+
+uint64_t
+combineHash(uint64_t seed, uint64_t value)
+{
+    return fnv1a(seed, &value, sizeof(value));
+}
+
+uint64_t
+hashString(const std::string& value)
+{
+    const uint64_t size = value.size();
+    return fnv1a(fnv1a(kFnvOffset, &size, sizeof(size)), value.data(), value.size());
+}
+
+template<typename T>
+static void
+hashValue(uint64_t* hash, const T& value)
+{
+    static_assert(std::is_arithmetic_v<T>);
+    *hash = fnv1a(*hash, &value, sizeof(value));
+}
+
+static void
+hashValue(uint64_t* hash, const std::string& value)
+{
+    *hash = combineHash(*hash, hashString(value));
+}
+
+static void
+hashValue(uint64_t* hash, const std::vector<std::string>& values)
+{
+    hashValue(hash, values.size());
+    for (const std::string& value : values) {
+        hashValue(hash, value);
+    }
+}
+
+uint64_t
+hashSettings(const Settings& cfg)
+{
+    uint64_t hash = kFnvOffset;
+    hashValue(&hash, cfg.isSolidify);
+    hashValue(&hash, cfg.useAlpha);
+    hashValue(&hash, cfg.premultiplyAlpha);
+    hashValue(&hash, cfg.normMode);
+    hashValue(&hash, cfg.rangeMode);
+    hashValue(&hash, cfg.repairMode);
+    hashValue(&hash, cfg.alphaMode);
+    hashValue(&hash, cfg.swapBasis);
+    hashValue(&hash, cfg.swapInvertMask);
+    hashValue(&hash, cfg.grayscaleMode);
+    hashValue(&hash, cfg.fileFormat);
+    hashValue(&hash, cfg.defFormat);
+    hashValue(&hash, cfg.bitDepth);
+    hashValue(&hash, cfg.defBDepth);
+    hashValue(&hash, cfg.outputScale);
+    hashValue(&hash, cfg.mipmapOutput);
+    hashValue(&hash, cfg.mipFilter);
+    hashValue(&hash, cfg.rawRot);
+    hashValue(&hash, cfg.alphaGamma);
+    hashValue(&hash, cfg.fillMargin);
+    hashValue(&hash, cfg.fillEngine);
+    hashValue(&hash, cfg.dilateRadius);
+    hashValue(&hash, cfg.dilateDistance);
+    for (float weight : cfg.grayscaleWeights) {
+        hashValue(&hash, weight);
+    }
+    hashValue(&hash, cfg.tiffCompression);
+    hashValue(&hash, cfg.tiffZipLevel);
+    hashValue(&hash, cfg.exrCompression);
+    hashValue(&hash, cfg.exrZipLevel);
+    hashValue(&hash, cfg.exrDwaLevel);
+    hashValue(&hash, cfg.pngStrategy);
+    hashValue(&hash, cfg.pngCompressionLevel);
+    hashValue(&hash, cfg.jpegQuality);
+    hashValue(&hash, cfg.jpegSubsampling);
+    hashValue(&hash, cfg.jpeg2000QStep);
+    hashValue(&hash, cfg.heicQuality);
+    hashValue(&hash, cfg.jpegxlQuality);
+    hashValue(&hash, cfg.jpegxlEffort);
+    hashValue(&hash, cfg.jpegxlSpeed);
+    hashValue(&hash, cfg.normNames);
+    hashValue(&hash, cfg.mask_substr);
+    hashValue(&hash, cfg.out_formats);
+    hashValue(&hash, cfg.outSuffix);
+    return hash;
+}
+
+BatchCache::Manifest&
+BatchCache::manifest(const fs::path& dir)
+{
+    auto found = m_manifests.find(dir);
+    if (found != m_manifests.end()) {
+        return found->second;
+    }
+
+    Manifest& loaded = m_manifests[dir];
+    std::ifstream file(dir / kManifestName);
+    std::string line;
+    while (std::getline(file, line)) {
+        // <key hex> <size> <file name>
+        std::istringstream fields(line);
+        Entry entry;
+        std::string name;
+        if (fields >> std::hex >> entry.key >> std::dec >> entry.size && std::getline(fields >> std::ws, name)
+            && !name.empty()) {
+            loaded.entries[name] = entry;
+        }
+    }
+    return loaded;
+}
+
+bool
+BatchCache::isCurrent(const std::string& outputFileName, uint64_t key)
+{
+    const fs::path outPath(outputFileName);
+    std::error_code ec;
+    const uint64_t size = fs::file_size(outPath, ec);
+    if (ec) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Manifest& entries = manifest(outPath.parent_path());
+    auto found              = entries.entries.find(outPath.filename().string());
+    return found != entries.entries.end() && found->second.key == key && found->second.size == size;
+}
+
+void
+BatchCache::record(const std::string& outputFileName, uint64_t key)
+{
+    const fs::path outPath(outputFileName);
+    std::error_code ec;
+    const uint64_t size = fs::file_size(outPath, ec);
+    if (ec) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Manifest& entries                            = manifest(outPath.parent_path());
+    entries.entries[outPath.filename().string()] = { key, size };
+    entries.dirty                                = true;
+}
+
+bool
+BatchCache::save()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool ok = true;
+    for (auto& [dir, entries] : m_manifests) {
+        if (!entries.dirty) {
+            continue;
+        }
+
+        const fs::path path = dir / kManifestName;
+        std::ofstream file(path, std::ios::trunc);
+        for (const auto& [name, entry] : entries.entries) {
+            file << std::hex << entry.key << ' ' << std::dec << entry.size << ' ' << name << '\n';
+        }
+        if (!file) {
+            spdlog::warn("Could not write batch cache {}", path.string());
+            ok = false;
+            continue;
+        }
+        entries.dirty = false;
+    }
+    return ok;
+}
@@ -0,0 +1,71 @@
+/*
+ * Solidify - texture push-pull processing utility
+ * Copyright (c) 2023-2026 Erium Vladlen.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "settings.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 64-bit FNV-1a hash of the bytes of path. Sets ok to false and returns 0 when the file can't be read.
+uint64_t
+hashFileContents(const std::string& path, bool* ok);
+
+// Hash of every Settings field that changes the pixels or encoding of an output. Threading, logging, memory and
+// fan-out fields are left out; each fan-out target is hashed on its own.
+uint64_t
+hashSettings(const Settings& cfg);
+
+uint64_t
+combineHash(uint64_t seed, uint64_t value);
+
+uint64_t
+hashString(const std::string& value);
+
+// Keys of finished outputs, kept in one manifest file per output directory. An output is current when its
+// manifest entry has the same key and the file on disk still has the recorded size. Safe to call from several
+// worker threads.
+class BatchCache {
+public:
+    static constexpr const char* kManifestName = ".sldf_cache";
+
+    bool isCurrent(const std::string& outputFileName, uint64_t key);
+    void record(const std::string& outputFileName, uint64_t key);
+    // Writes back every manifest that changed since it was loaded.
+    bool save();
+
+private:
+    struct Entry {
+        uint64_t key  = 0;
+        uint64_t size = 0;
+    };
+    struct Manifest {
+        std::unordered_map<std::string, Entry> entries;
+        bool dirty = false;
+    };
+
+    Manifest& manifest(const std::filesystem::path& dir);
+
+    std::mutex m_mutex;
+    std::map<std::filesystem::path, Manifest> m_manifests;
+};
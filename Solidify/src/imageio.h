@@ -19,7 +19,9 @@
 #pragma once
 
 #include "timer.h"
+#include "mappedimage.h"
 #include "processing.h"
+#include "pushpull.h"
 
 #include <OpenImageIO/half.h>
 #include <OpenImageIO/imagebuf.h>
@@ -27,6 +29,11 @@
 #include <OpenImageIO/imagebufalgo_util.h>
 #include <OpenImageIO/imageio.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
 using namespace OIIO;
 
 struct OIIOProgressContext {
@@ -36,10 +43,44 @@ struct OIIOProgressContext {
     float scale = 1.0f;
 };
 
+class MaskVariantCache;
+
+// External mask at full resolution. A mask with values between 0 and 1 keeps alpha in float, gamma-shaped, as the
+// push-pull coverage plane, and originalAlpha as the float mask before gamma, set only when an output keeps it.
+// A mask that is strictly 0 or 1 is packed into coverage, one bit per pixel, for the fill; alpha then holds it as
+// uint8 for everything else, and originalAlpha is left empty since gamma leaves 0 and 1 unchanged.
 struct MaskBuffers {
     ImageBuf alpha;
-    ImageBuf rgbAlpha;
     ImageBuf originalAlpha;
+    std::shared_ptr<const PushPullCoverageBits> coverage;
+    // Format and resolution variants of the buffers above, shared by every copy of this MaskBuffers.
+    std::shared_ptr<MaskVariantCache> variants;
+};
+
+// Mask buffers matching one image. Pointers stay valid as long as the MaskBuffers they came from.
+struct MaskView {
+    const ImageBuf* alpha         = nullptr;
+    const ImageBuf* originalAlpha = nullptr;  // Mask written back by alpha export; alpha when none was kept
+};
+
+// Mask variants keyed by pixel format and size, each built once and then shared read-only by every worker. Sizes
+// on the mask's pull pyramid (each level pulls the one above with pushPullPullPlane, the push-pull tent) come from
+// that pyramid; other sizes are resampled from the full-resolution mask.
+class MaskVariantCache {
+public:
+    bool get(const MaskBuffers& base, TypeDesc format, int width, int height, MaskView* view);
+
+private:
+    struct Variant {
+        ImageBuf alpha;
+        ImageBuf originalAlpha;
+    };
+
+    // Float variant at a size other than full resolution; m_mutex must be held.
+    const Variant* floatVariant(const MaskBuffers& base, int width, int height);
+
+    std::mutex m_mutex;
+    std::map<std::tuple<int, int, int>, std::unique_ptr<Variant>> m_variants;
 };
 
 bool
@@ -52,11 +93,19 @@ formatText(TypeDesc format);
 void
 formatFromBuff(ImageBuf& buf);
 
+// Loads the external mask. keepOriginal keeps the mask before gamma as originalAlpha, for outputs that write the
+// source alpha back.
 MaskBuffers
-mask_load(const std::string& mask_file, const SolidifyProgressCallback& progressCallback);
+mask_load(const std::string& mask_file, bool keepOriginal, const SolidifyProgressCallback& progressCallback);
+// Points view at the mask buffers for an image of width x height in format, building that variant on first use.
+bool
+maskVariant(const MaskBuffers& mask, TypeDesc format, int width, int height, MaskView* view);
+// Reads inputFileName into outBuf, applying alpha gamma and premultiplication to embedded alpha when solidifying.
+// originalAlpha, when not null, receives that alpha before gamma; callers pass it only when an output keeps it.
 bool
 img_load(ImageBuf& outBuf, const std::string& inputFileName, bool external_alpha,
-         ImageBuf* originalAlpha, const SolidifyProgressCallback& progressCallback);
+         ImageBuf* originalAlpha, const SolidifyProgressCallback& progressCallback,
+         std::unique_ptr<MappedImage>* mapping = nullptr);
 
 void
 debugImageBufWrite(const ImageBuf& buf, const std::string& filename);
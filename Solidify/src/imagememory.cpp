@@ -0,0 +1,124 @@
+/*
+ * Solidify - texture push-pull processing utility
+ * Copyright (c) 2023-2026 Erium Vladlen.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pch.h"
+
+#include "imagememory.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#    include <malloc.h>
+#    include <psapi.h>
+#else
+#    include <sys/mman.h>
+#    include <sys/resource.h>
+#endif
+
+void*
+allocateImageMemory(size_t bytes)
+{
+    const size_t alignment = bytes >= kImageHugePageSize ? kImageHugePageSize : kImageMemoryAlignment;
+    const size_t size      = std::max<size_t>(alignment, (bytes + alignment - 1) / alignment * alignment);
+#ifdef _WIN32
+    void* data = _aligned_malloc(size, alignment);
+#else
+    void* data = std::aligned_alloc(alignment, size);
+#endif
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+    if (alignment == kImageHugePageSize) {
+        adviseHugePages(data, size);
+    }
+    return data;
+}
+
+void
+freeImageMemory(void* data) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(data);
+#else
+    std::free(data);
+#endif
+}
+
+void
+adviseHugePages(void* data, size_t bytes)
+{
+#if defined(MADV_HUGEPAGE)
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + kImageHugePageSize - 1) & ~(kImageHugePageSize - 1);
+    const uintptr_t end   = (reinterpret_cast<uintptr_t>(data) + bytes) & ~(kImageHugePageSize - 1);
+    if (end > begin) {
+        // Only a hint: without transparent huge pages the range keeps regular pages.
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+    }
+#else
+    (void)data;
+    (void)bytes;
+#endif
+}
+
+void
+parallelZero(void* data, size_t bytes, int nthreads)
+{
+    const size_t chunks = (bytes + kImageHugePageSize - 1) / kImageHugePageSize;
+    if (chunks <= 1) {
+        std::memset(data, 0, bytes);
+        return;
+    }
+    OIIO::ROI roi(0, 1, 0, static_cast<int>(chunks), 0, 1, 0, 1);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        const size_t begin = static_cast<size_t>(chunk.ybegin) * kImageHugePageSize;
+        const size_t end   = std::min(bytes, static_cast<size_t>(chunk.yend) * kImageHugePageSize);
+        std::memset(static_cast<unsigned char*>(data) + begin, 0, end - begin);
+    });
+}
+
+bool
+resetUninitialized(OIIO::ImageBuf& dst, const OIIO::ImageSpec& spec)
+{
+    dst.reset(spec, OIIO::InitializePixels::No);
+    if (dst.localpixels() == nullptr) {
+        dst.errorfmt("could not allocate {}x{} image pixels", spec.width, spec.height);
+        return false;
+    }
+    adviseHugePages(dst.localpixels(), spec.image_bytes());
+    return true;
+}
+
+size_t
+processPageFaults()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PageFaultCount;
+#else
+    rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return static_cast<size_t>(usage.ru_minflt) + static_cast<size_t>(usage.ru_majflt);
+#endif
+}
@@ -0,0 +1,79 @@
+/*
+ * Solidify - texture push-pull processing utility
+ * Copyright (c) 2023-2026 Erium Vladlen.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <OpenImageIO/imagebuf.h>
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Alignment of every pixel buffer from allocateImageMemory: a cache line, and a whole vector on every SIMD target.
+constexpr size_t kImageMemoryAlignment = 64;
+// Buffers at least this large are aligned to it and advised as transparent huge pages.
+constexpr size_t kImageHugePageSize = size_t(2) << 20;
+
+// Storage for large pixel buffers, aligned and huge-page backed where the platform supports it. The pages are not
+// touched, so the first thread to write a page is the one it is faulted in on. Throws std::bad_alloc like new.
+void*
+allocateImageMemory(size_t bytes);
+void
+freeImageMemory(void* data) noexcept;
+
+// Advises the whole huge pages inside [data, data + bytes) as transparent huge pages. Only pages that have not
+// been touched yet are affected, so call it right after the allocation.
+void
+adviseHugePages(void* data, size_t bytes);
+
+// Zeroes bytes in huge-page sized chunks on nthreads threads, so the first touch is spread over the workers.
+void
+parallelZero(void* data, size_t bytes, int nthreads = 0);
+
+// Allocates dst for spec without zeroing its pixels and advises them as huge pages, for results whose every pixel
+// is written before it is read. False, with an error on dst, when OIIO could not allocate local pixels.
+bool
+resetUninitialized(OIIO::ImageBuf& dst, const OIIO::ImageSpec& spec);
+
+// Minor plus major page faults of this process so far, or 0 where the platform does not report them.
+size_t
+processPageFaults();
+
+// Allocator for pixel vectors: allocateImageMemory storage, and elements default-initialized rather than zeroed,
+// so resize() leaves the pages untouched for the kernel that writes every pixel.
+template<typename T> struct ImageAllocator {
+    using value_type = T;
+
+    ImageAllocator() noexcept = default;
+    template<typename U> ImageAllocator(const ImageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) { return static_cast<T*>(allocateImageMemory(n * sizeof(T))); }
+    void deallocate(T* data, size_t) noexcept { freeImageMemory(data); }
+
+    template<typename U> void construct(U* p) noexcept { ::new (static_cast<void*>(p)) U; }
+    template<typename U, typename... Args> void construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U> bool operator==(const ImageAllocator<U>&) const noexcept { return true; }
+    template<typename U> bool operator!=(const ImageAllocator<U>&) const noexcept { return false; }
+};
+
+template<typename T> using ImageVector = std::vector<T, ImageAllocator<T>>;
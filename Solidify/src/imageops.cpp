@@ -20,6 +20,8 @@
 
 #include "imageops.h"
 
+#include "imagememory.h"
+
 namespace solidify_hwy {
 
 enum SolidifyHwyPixelType {
@@ -30,6 +32,7 @@ enum SolidifyHwyPixelType {
     SolidifyHwyPixelType_U64,
     SolidifyHwyPixelType_F32,
     SolidifyHwyPixelType_F64,
+    SolidifyHwyPixelType_F16,
 };
 
 struct SolidifyHwyImageView {
@@ -42,6 +45,8 @@ struct SolidifyHwyImageView {
     ptrdiff_t srcRowStride = 0;
     ptrdiff_t dstRowStride = 0;
     int pixelType          = SolidifyHwyPixelType_Unsupported;
+    int x                  = 0;
+    int y                  = 0;
 };
 
 struct SolidifyHwySwapOp {
@@ -56,6 +61,67 @@ struct SolidifyHwyGrayscaleOp {
     uint32_t fixedWeights[3] = { 13933u, 46871u, 4732u };
 };
 
+struct SolidifyHwyNormalOp {
+    uint8_t recalc  = 0;
+    uint8_t channel = 2;
+    float sign      = 1.0f;
+    float inCenter  = 0.5f;
+    float outCenter = 0.5f;
+    float scale     = 0.5f;
+};
+
+struct SolidifyHwyRangeOp {
+    float scale  = 1.0f;
+    float offset = 0.0f;
+};
+
+enum SolidifyHwyPostFillKind {
+    SolidifyHwyPostFill_ReplaceAlpha = 0,
+    SolidifyHwyPostFill_Normal,
+    SolidifyHwyPostFill_Range,
+    SolidifyHwyPostFill_SwapInvert,
+    SolidifyHwyPostFill_Grayscale,
+};
+
+struct SolidifyHwyPostFillStep {
+    uint8_t kind        = SolidifyHwyPostFill_Range;
+    uint8_t outChannels = 0;
+    SolidifyHwyNormalOp normal;
+    SolidifyHwyRangeOp range;
+    SolidifyHwySwapOp swap;
+    SolidifyHwyGrayscaleOp gray;
+};
+
+struct SolidifyHwyPostFillPlan {
+    const SolidifyHwyPostFillStep* steps = nullptr;
+    int stepCount                        = 0;
+    const void* alpha                    = nullptr;
+    ptrdiff_t alphaRowStride             = 0;
+    int alphaXBegin                      = 0;
+    int alphaXEnd                        = 0;
+    int alphaYBegin                      = 0;
+    int alphaYEnd                        = 0;
+    uint8_t clearOutside                 = 0;
+};
+
+struct SolidifyHwyAlphaView {
+    void* pixels                = nullptr;
+    void* original              = nullptr;
+    int width                   = 0;
+    int height                  = 0;
+    int channels                = 0;
+    ptrdiff_t rowStride         = 0;
+    ptrdiff_t originalRowStride = 0;
+    int pixelType               = SolidifyHwyPixelType_Unsupported;
+};
+
+struct SolidifyHwyAlphaOp {
+    const void* gammaLut = nullptr;
+    float exponent       = 1.0f;
+    uint8_t shapeAlpha   = 0;
+    uint8_t premultiply  = 0;
+};
+
 }  // namespace solidify_hwy
 
 #undef HWY_TARGET_INCLUDE
@@ -69,6 +135,10 @@ namespace solidify_hwy {
 
 HWY_EXPORT(SwapInvertKernel);
 HWY_EXPORT(GrayscaleKernel);
+HWY_EXPORT(AlphaPreprocessKernel);
+HWY_EXPORT(NormalKernel);
+HWY_EXPORT(RangeKernel);
+HWY_EXPORT(PostFillKernel);
 
 static bool
 runSwapInvertHwy(const SolidifyHwyImageView* view, const SolidifyHwySwapOp* op)
@@ -82,6 +152,30 @@ runGrayscaleHwy(const SolidifyHwyImageView* view, const SolidifyHwyGrayscaleOp*
     return HWY_DYNAMIC_DISPATCH(GrayscaleKernel)(view, op);
 }
 
+static bool
+runAlphaPreprocessHwy(const SolidifyHwyAlphaView* view, const SolidifyHwyAlphaOp* op)
+{
+    return HWY_DYNAMIC_DISPATCH(AlphaPreprocessKernel)(view, op);
+}
+
+static bool
+runNormalHwy(const SolidifyHwyImageView* view, const SolidifyHwyNormalOp* op)
+{
+    return HWY_DYNAMIC_DISPATCH(NormalKernel)(view, op);
+}
+
+static bool
+runRangeHwy(const SolidifyHwyImageView* view, const SolidifyHwyRangeOp* op)
+{
+    return HWY_DYNAMIC_DISPATCH(RangeKernel)(view, op);
+}
+
+static bool
+runPostFillHwy(const SolidifyHwyImageView* view, const SolidifyHwyPostFillPlan* plan)
+{
+    return HWY_DYNAMIC_DISPATCH(PostFillKernel)(view, plan);
+}
+
 }  // namespace solidify_hwy
 #endif
 
@@ -99,6 +193,7 @@ pixelTypeFromFormat(const OIIO::TypeDesc format)
     case OIIO::TypeDesc::UINT16: return solidify_hwy::SolidifyHwyPixelType_U16;
     case OIIO::TypeDesc::UINT32: return solidify_hwy::SolidifyHwyPixelType_U32;
     case OIIO::TypeDesc::UINT64: return solidify_hwy::SolidifyHwyPixelType_U64;
+    case OIIO::TypeDesc::HALF: return solidify_hwy::SolidifyHwyPixelType_F16;
     case OIIO::TypeDesc::FLOAT: return solidify_hwy::SolidifyHwyPixelType_F32;
     case OIIO::TypeDesc::DOUBLE: return solidify_hwy::SolidifyHwyPixelType_F64;
     default: return solidify_hwy::SolidifyHwyPixelType_Unsupported;
@@ -134,9 +229,10 @@ findAlphaChannel(const OIIO::ImageBuf& src)
     return -1;
 }
 
+// Splits src into row bands and runs kernel on each band's packed view into dst. dst may be src itself.
+template<class Kernel>
 static bool
-runSwapInvertHwyParallel(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const solidify_hwy::SolidifyHwySwapOp& op,
-                         const int nthreads)
+runPackedHwyParallel(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const int nthreads, Kernel kernel)
 {
     if (!canUsePackedHwy(src, dst)) {
         return false;
@@ -162,42 +258,9 @@ runSwapInvertHwyParallel(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const s
         view.srcRowStride = src.scanline_stride();
         view.dstRowStride = dst.scanline_stride();
         view.pixelType    = pixelType;
-        if (!solidify_hwy::runSwapInvertHwy(&view, &op)) {
-            ok = false;
-        }
-    });
-    return ok.load();
-}
-
-static bool
-runGrayscaleHwyParallel(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const solidify_hwy::SolidifyHwyGrayscaleOp& op,
-                        const int nthreads)
-{
-    if (!canUsePackedHwy(src, dst)) {
-        return false;
-    }
-
-    std::atomic<bool> ok = true;
-    const int pixelType  = pixelTypeFromFormat(src.spec().format);
-    OIIO::ROI roi(src.xbegin(), src.xend(), src.ybegin(), src.yend(), src.zbegin(), src.zend(), 0, src.nchannels());
-    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
-        const ptrdiff_t srcPixelStride = src.pixel_stride();
-        const ptrdiff_t dstPixelStride = dst.pixel_stride();
-        const uint8_t* srcBase         = static_cast<const uint8_t*>(src.localpixels());
-        uint8_t* dstBase               = static_cast<uint8_t*>(dst.localpixels());
-        solidify_hwy::SolidifyHwyImageView view;
-        view.src = srcBase + static_cast<size_t>(chunk.ybegin - src.ybegin()) * src.scanline_stride()
-                   + static_cast<size_t>(chunk.xbegin - src.xbegin()) * srcPixelStride;
-        view.dst = dstBase + static_cast<size_t>(chunk.ybegin - dst.ybegin()) * dst.scanline_stride()
-                   + static_cast<size_t>(chunk.xbegin - dst.xbegin()) * dstPixelStride;
-        view.width        = chunk.width();
-        view.height       = chunk.height();
-        view.srcChannels  = src.nchannels();
-        view.dstChannels  = dst.nchannels();
-        view.srcRowStride = src.scanline_stride();
-        view.dstRowStride = dst.scanline_stride();
-        view.pixelType    = pixelType;
-        if (!solidify_hwy::runGrayscaleHwy(&view, &op)) {
+        view.x            = chunk.xbegin;
+        view.y            = chunk.ybegin;
+        if (!kernel(&view)) {
             ok = false;
         }
     });
@@ -259,6 +322,198 @@ setGraySpec(OIIO::ImageSpec* spec, const int outChannels)
     }
 }
 
+static bool
+runAlphaPreprocessHwyParallel(OIIO::ImageBuf& image, OIIO::ImageBuf* original,
+                              const solidify_hwy::SolidifyHwyAlphaOp& op, const int nthreads)
+{
+    std::atomic<bool> ok = true;
+    const int pixelType  = pixelTypeFromFormat(image.spec().format);
+    OIIO::ROI roi(image.xbegin(), image.xend(), image.ybegin(), image.yend(), image.zbegin(), image.zend(), 0,
+                  image.nchannels());
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        uint8_t* base = static_cast<uint8_t*>(image.localpixels());
+        solidify_hwy::SolidifyHwyAlphaView view;
+        view.pixels = base + static_cast<size_t>(chunk.ybegin - image.ybegin()) * image.scanline_stride()
+                      + static_cast<size_t>(chunk.xbegin - image.xbegin()) * image.pixel_stride();
+        if (original != nullptr) {
+            uint8_t* originalBase = static_cast<uint8_t*>(original->localpixels());
+            view.original         = originalBase
+                            + static_cast<size_t>(chunk.ybegin - original->ybegin()) * original->scanline_stride()
+                            + static_cast<size_t>(chunk.xbegin - original->xbegin()) * original->pixel_stride();
+            view.originalRowStride = original->scanline_stride();
+        }
+        view.width     = chunk.width();
+        view.height    = chunk.height();
+        view.channels  = image.nchannels();
+        view.rowStride = image.scanline_stride();
+        view.pixelType = pixelType;
+        if (!solidify_hwy::runAlphaPreprocessHwy(&view, &op)) {
+            ok = false;
+        }
+    });
+    return ok.load();
+}
+
+template<typename T>
+static std::vector<T>
+makeAlphaGammaLut(const float exponent)
+{
+    const double maxValue = static_cast<double>(std::numeric_limits<T>::max());
+    std::vector<T> lut(static_cast<size_t>(std::numeric_limits<T>::max()) + 1);
+    for (size_t i = 0; i < lut.size(); ++i) {
+        lut[i] = static_cast<T>(std::pow(static_cast<double>(i) / maxValue, exponent) * maxValue + 0.5);
+    }
+    return lut;
+}
+
+static bool
+isFloatMathPixelType(const int pixelType)
+{
+    return pixelType == solidify_hwy::SolidifyHwyPixelType_U8 || pixelType == solidify_hwy::SolidifyHwyPixelType_U16
+           || pixelType == solidify_hwy::SolidifyHwyPixelType_F16 || pixelType == solidify_hwy::SolidifyHwyPixelType_F32;
+}
+
+// Checks that src suits the float-math kernels and gives dst src's layout, leaving it alone for in-place runs.
+static bool
+prepareFloatMathDst(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const char* what, const bool normalChannels)
+{
+    if (!src.initialized()) {
+        dst.errorfmt("{} source image is not initialized", what);
+        return false;
+    }
+    if (normalChannels && src.nchannels() != 3 && src.nchannels() != 4) {
+        dst.errorfmt("{} requires RGB or RGBA images", what);
+        return false;
+    }
+    if (!canUsePackedHwy(src, src) || !isFloatMathPixelType(pixelTypeFromFormat(src.spec().format))) {
+        dst.errorfmt("{} requires packed uint8, uint16, half or float image data", what);
+        return false;
+    }
+    if (&dst != &src) {
+        OIIO::ImageSpec spec = src.spec();
+        spec.channelformats.clear();
+        return resetUninitialized(dst, spec);
+    }
+    return true;
+}
+
+// Lowers ops to kernel steps, checking each against the channel layout the steps before it leave behind.
+static bool
+planPostFill(const OIIO::ImageBuf& src, const std::vector<PostFillOp>& ops,
+             std::vector<solidify_hwy::SolidifyHwyPostFillStep>* steps, solidify_hwy::SolidifyHwyPostFillPlan* plan,
+             int* outChannels, std::string* error)
+{
+    int nchannels      = src.nchannels();
+    bool hasAlpha      = findAlphaChannel(src) == nchannels - 1 && (nchannels == 2 || nchannels == 4);
+    const bool intData = src.spec().format.basetype == OIIO::TypeDesc::UINT8
+                         || src.spec().format.basetype == OIIO::TypeDesc::UINT16;
+
+    for (const PostFillOp& op : ops) {
+        solidify_hwy::SolidifyHwyPostFillStep step;
+        switch (op.kind) {
+        case PostFillOp::ReplaceAlpha: {
+            const OIIO::ImageBuf* alpha = op.alpha;
+            if (!hasAlpha || plan->alpha != nullptr) {
+                *error = "alpha replacement requires one trailing alpha channel";
+                return false;
+            }
+            if (alpha == nullptr || !alpha->initialized() || alpha->nchannels() != 1
+                || alpha->spec().format != src.spec().format || !canUsePackedHwy(*alpha, *alpha)) {
+                *error = "alpha replacement requires a packed 1-channel alpha image in the source format";
+                return false;
+            }
+            step.kind            = solidify_hwy::SolidifyHwyPostFill_ReplaceAlpha;
+            plan->alpha          = alpha->localpixels();
+            plan->alphaRowStride = alpha->scanline_stride();
+            plan->alphaXBegin    = alpha->xbegin();
+            plan->alphaXEnd      = alpha->xend();
+            plan->alphaYBegin    = alpha->ybegin();
+            plan->alphaYEnd      = alpha->yend();
+            plan->clearOutside   = op.clearOutside ? 1 : 0;
+            break;
+        }
+        case PostFillOp::Normalize:
+        case PostFillOp::RecalcNormal:
+            if (nchannels != 3 && nchannels != 4) {
+                *error = "normal passes require RGB or RGBA images";
+                return false;
+            }
+            if (op.kind == PostFillOp::RecalcNormal && op.channel > 2) {
+                *error = "normal recalculation channel must be 0, 1 or 2";
+                return false;
+            }
+            step.kind             = solidify_hwy::SolidifyHwyPostFill_Normal;
+            step.normal.recalc    = op.kind == PostFillOp::RecalcNormal ? 1 : 0;
+            step.normal.channel   = static_cast<uint8_t>(op.channel);
+            step.normal.sign      = op.sign < 0 ? -1.0f : 1.0f;
+            step.normal.inCenter  = op.inCenter;
+            step.normal.outCenter = op.outCenter;
+            step.normal.scale     = op.scale;
+            break;
+        case PostFillOp::RangeRemap:
+            step.kind         = solidify_hwy::SolidifyHwyPostFill_Range;
+            step.range.scale  = op.scale;
+            step.range.offset = op.offset;
+            break;
+        case PostFillOp::SwapInvert: {
+            if (nchannels != 3 && nchannels != 4) {
+                *error = "swap/invert requires RGB or RGBA images";
+                return false;
+            }
+            const unsigned int basis      = std::clamp<unsigned int>(op.basis, 0, 5);
+            const unsigned int invertMask = std::clamp<unsigned int>(op.invertMask, 0, 7);
+            if (basis == 0 && invertMask == 0) {
+                continue;
+            }
+            step.kind             = solidify_hwy::SolidifyHwyPostFill_SwapInvert;
+            step.swap.order[0]    = static_cast<uint8_t>(kSwapOrders[basis][0]);
+            step.swap.order[1]    = static_cast<uint8_t>(kSwapOrders[basis][1]);
+            step.swap.order[2]    = static_cast<uint8_t>(kSwapOrders[basis][2]);
+            step.swap.invertMask  = static_cast<uint8_t>(invertMask);
+            step.swap.signedRange = op.signedRange ? 1 : 0;
+            break;
+        }
+        case PostFillOp::Grayscale: {
+            const unsigned int mode = std::clamp<unsigned int>(op.mode, 0, 7);
+            if (mode == 0) {
+                continue;
+            }
+            if (nchannels != 3 && nchannels != 4) {
+                *error = "fused grayscale requires RGB or RGBA images";
+                return false;
+            }
+            if (mode == 4 && !hasAlpha) {
+                *error = "selected grayscale mask mode requires an alpha channel";
+                return false;
+            }
+            step.kind            = solidify_hwy::SolidifyHwyPostFill_Grayscale;
+            step.gray.mode       = static_cast<uint8_t>(mode);
+            step.gray.weights[0] = op.weights[0];
+            step.gray.weights[1] = op.weights[1];
+            step.gray.weights[2] = op.weights[2];
+            setFixedWeights(&step.gray);
+            // Integer data uses the fixed-point weights applyGrayscale rounds to, so both paths agree.
+            if (intData) {
+                for (int i = 0; i < 3; ++i) {
+                    step.gray.weights[i] = static_cast<float>(step.gray.fixedWeights[i]) / 65536.0f;
+                }
+            }
+            nchannels        = op.preserveAlpha && hasAlpha && mode != 4 ? 2 : 1;
+            hasAlpha         = nchannels == 2;
+            step.outChannels = static_cast<uint8_t>(nchannels);
+            break;
+        }
+        default: *error = "unknown post-fill operation"; return false;
+        }
+        steps->push_back(step);
+    }
+
+    plan->steps     = steps->data();
+    plan->stepCount = static_cast<int>(steps->size());
+    *outChannels    = nchannels;
+    return true;
+}
+
 }  // namespace
 
 bool
@@ -289,7 +544,9 @@ applyChannelSwapInvert(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, unsigned
 
     OIIO::ImageSpec spec = src.spec();
     spec.channelformats.clear();
-    dst.reset(spec);
+    if (!resetUninitialized(dst, spec)) {
+        return false;
+    }
 
     solidify_hwy::SolidifyHwySwapOp op;
     op.order[0]    = static_cast<uint8_t>(kSwapOrders[basis][0]);
@@ -298,7 +555,10 @@ applyChannelSwapInvert(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, unsigned
     op.invertMask  = static_cast<uint8_t>(invertMask);
     op.signedRange = signedRange ? 1 : 0;
 
-    if (!runSwapInvertHwyParallel(dst, src, op, nthreads)) {
+    const bool ok = runPackedHwyParallel(dst, src, nthreads, [&](const solidify_hwy::SolidifyHwyImageView* view) {
+        return solidify_hwy::runSwapInvertHwy(view, &op);
+    });
+    if (!ok) {
         dst.errorfmt("swap/invert requires packed RGB/RGBA uint or float image data");
         return false;
     }
@@ -341,7 +601,9 @@ applyGrayscale(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, unsigned int mode
     const int outChannels = preserveAlpha && alphaChannel >= 0 && mode != 4 ? 2 : 1;
     OIIO::ImageSpec spec  = src.spec();
     setGraySpec(&spec, outChannels);
-    dst.reset(spec);
+    if (!resetUninitialized(dst, spec)) {
+        return false;
+    }
 
     solidify_hwy::SolidifyHwyGrayscaleOp op;
     op.mode       = static_cast<uint8_t>(mode);
@@ -350,9 +612,200 @@ applyGrayscale(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, unsigned int mode
     op.weights[2] = weights != nullptr ? weights[2] : 0.0722f;
     setFixedWeights(&op);
 
-    if (!runGrayscaleHwyParallel(dst, src, op, nthreads)) {
+    const bool ok = runPackedHwyParallel(dst, src, nthreads, [&](const solidify_hwy::SolidifyHwyImageView* view) {
+        return solidify_hwy::runGrayscaleHwy(view, &op);
+    });
+    if (!ok) {
         dst.errorfmt("grayscale requires packed RGB/RGBA uint or float image data");
         return false;
     }
     return true;
 }
+
+bool
+applyAlphaPreprocess(OIIO::ImageBuf& image, const float gamma, const bool premultiply, OIIO::ImageBuf* originalAlpha,
+                     const int nthreads)
+{
+    if (!image.initialized()) {
+        image.errorfmt("alpha preprocess image is not initialized");
+        return false;
+    }
+    const int nchannels = image.nchannels();
+    if ((nchannels != 2 && nchannels != 4) || findAlphaChannel(image) != nchannels - 1) {
+        image.errorfmt("alpha preprocess requires gray+alpha or RGBA images with trailing alpha");
+        return false;
+    }
+    const int pixelType = pixelTypeFromFormat(image.spec().format);
+    if (!canUsePackedHwy(image, image)
+        || (pixelType != solidify_hwy::SolidifyHwyPixelType_U8 && pixelType != solidify_hwy::SolidifyHwyPixelType_U16
+            && pixelType != solidify_hwy::SolidifyHwyPixelType_F32)) {
+        image.errorfmt("alpha preprocess requires packed uint8, uint16 or float image data");
+        return false;
+    }
+
+    if (originalAlpha != nullptr) {
+        OIIO::ImageSpec spec = image.spec();
+        spec.nchannels       = 1;
+        spec.channelnames.assign(1, "A");
+        spec.channelformats.clear();
+        spec.alpha_channel = 0;
+        spec.z_channel     = -1;
+        if (!resetUninitialized(*originalAlpha, spec)) {
+            image.errorfmt("{}", originalAlpha->geterror());
+            return false;
+        }
+    }
+
+    solidify_hwy::SolidifyHwyAlphaOp op;
+    op.shapeAlpha  = std::abs(gamma - 1.0f) > 0.000001f ? 1 : 0;
+    op.premultiply = premultiply ? 1 : 0;
+    op.exponent    = 1.0f / std::max(gamma, 0.01f);
+
+    // Integer alpha has few enough code values that shaping is a table lookup.
+    std::vector<uint8_t> lut8;
+    std::vector<uint16_t> lut16;
+    if (op.shapeAlpha != 0 && pixelType == solidify_hwy::SolidifyHwyPixelType_U8) {
+        lut8        = makeAlphaGammaLut<uint8_t>(op.exponent);
+        op.gammaLut = lut8.data();
+    } else if (op.shapeAlpha != 0 && pixelType == solidify_hwy::SolidifyHwyPixelType_U16) {
+        lut16       = makeAlphaGammaLut<uint16_t>(op.exponent);
+        op.gammaLut = lut16.data();
+    }
+
+    if (!runAlphaPreprocessHwyParallel(image, originalAlpha, op, nthreads)) {
+        image.errorfmt("alpha preprocess failed");
+        return false;
+    }
+    return true;
+}
+
+bool
+applyNormalize(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const float inCenter, const float outCenter,
+               const float scale, const int nthreads)
+{
+    if (!prepareFloatMathDst(dst, src, "normalize", true)) {
+        return false;
+    }
+
+    solidify_hwy::SolidifyHwyNormalOp op;
+    op.recalc    = 0;
+    op.inCenter  = inCenter;
+    op.outCenter = outCenter;
+    op.scale     = scale;
+
+    const bool ok = runPackedHwyParallel(dst, src, nthreads, [&](const solidify_hwy::SolidifyHwyImageView* view) {
+        return solidify_hwy::runNormalHwy(view, &op);
+    });
+    if (!ok) {
+        dst.errorfmt("normalize kernel failed");
+        return false;
+    }
+    return true;
+}
+
+bool
+applyNormalRecalc(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const unsigned int channel, const int sign,
+                  const float inCenter, const float outCenter, const float scale, const int nthreads)
+{
+    if (channel > 2) {
+        dst.errorfmt("normal recalculation channel must be 0, 1 or 2");
+        return false;
+    }
+    if (!prepareFloatMathDst(dst, src, "normal recalculation", true)) {
+        return false;
+    }
+
+    solidify_hwy::SolidifyHwyNormalOp op;
+    op.recalc    = 1;
+    op.channel   = static_cast<uint8_t>(channel);
+    op.sign      = sign < 0 ? -1.0f : 1.0f;
+    op.inCenter  = inCenter;
+    op.outCenter = outCenter;
+    op.scale     = scale;
+
+    const bool ok = runPackedHwyParallel(dst, src, nthreads, [&](const solidify_hwy::SolidifyHwyImageView* view) {
+        return solidify_hwy::runNormalHwy(view, &op);
+    });
+    if (!ok) {
+        dst.errorfmt("normal recalculation kernel failed");
+        return false;
+    }
+    return true;
+}
+
+bool
+applyRangeRemap(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const float scale, const float offset,
+                const int nthreads)
+{
+    if (!prepareFloatMathDst(dst, src, "range conversion", false)) {
+        return false;
+    }
+
+    solidify_hwy::SolidifyHwyRangeOp op;
+    op.scale  = scale;
+    op.offset = offset;
+
+    const bool ok = runPackedHwyParallel(dst, src, nthreads, [&](const solidify_hwy::SolidifyHwyImageView* view) {
+        return solidify_hwy::runRangeHwy(view, &op);
+    });
+    if (!ok) {
+        dst.errorfmt("range conversion kernel failed");
+        return false;
+    }
+    return true;
+}
+
+bool
+applyPostFillOps(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const std::vector<PostFillOp>& ops,
+                 const int nthreads)
+{
+    if (!src.initialized()) {
+        dst.errorfmt("post-fill source image is not initialized");
+        return false;
+    }
+    if (!canUsePackedHwy(src, src) || !isFloatMathPixelType(pixelTypeFromFormat(src.spec().format))) {
+        dst.errorfmt("post-fill ops require packed uint8, uint16, half or float image data");
+        return false;
+    }
+
+    std::vector<solidify_hwy::SolidifyHwyPostFillStep> steps;
+    solidify_hwy::SolidifyHwyPostFillPlan plan;
+    int outChannels = src.nchannels();
+    std::string error;
+    if (!planPostFill(src, ops, &steps, &plan, &outChannels, &error)) {
+        dst.errorfmt("{}", error);
+        return false;
+    }
+    if (steps.empty()) {
+        return &dst == &src || dst.copy(src);
+    }
+
+    // Steps that keep the channel count write straight into dst, even when it is src; a grayscale step needs a
+    // differently shaped buffer, which replaces dst only once it is complete.
+    OIIO::ImageBuf tmp;
+    const bool inPlace  = &dst == &src && outChannels == src.nchannels();
+    OIIO::ImageBuf& out = &dst == &src && !inPlace ? tmp : dst;
+    if (!inPlace) {
+        OIIO::ImageSpec spec = src.spec();
+        if (outChannels != src.nchannels()) {
+            setGraySpec(&spec, outChannels);
+        }
+        spec.channelformats.clear();
+        if (!resetUninitialized(out, spec)) {
+            dst.errorfmt("{}", out.geterror());
+            return false;
+        }
+    }
+
+    const bool ok = runPackedHwyParallel(out, src, nthreads, [&](const solidify_hwy::SolidifyHwyImageView* view) {
+        return solidify_hwy::runPostFillHwy(view, &plan);
+    });
+    if (!ok) {
+        dst.errorfmt("post-fill kernel failed");
+        return false;
+    }
+    if (&out == &tmp) {
+        dst = std::move(tmp);
+    }
+    return true;
+}
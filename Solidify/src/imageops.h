@@ -20,6 +20,8 @@
 
 #include <OpenImageIO/imagebuf.h>
 
+#include <vector>
+
 bool
 applyChannelSwapInvert(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, unsigned int basis, unsigned int invertMask,
                        bool signedRange, int nthreads = 0);
@@ -27,3 +29,59 @@ applyChannelSwapInvert(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, unsigned
 bool
 applyGrayscale(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, unsigned int mode, const float weights[3],
                bool preserveAlpha, int nthreads = 0);
+
+// Normal-map passes on packed uint8/uint16/half/float RGB or RGBA images, with the math of
+// ImageBufAlgo::normalize, recalc_normal and ImageBufAlgo::mad. dst may be src to run in place.
+bool
+applyNormalize(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, float inCenter, float outCenter, float scale,
+               int nthreads = 0);
+
+bool
+applyNormalRecalc(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, unsigned int channel, int sign, float inCenter,
+                  float outCenter, float scale, int nthreads = 0);
+
+bool
+applyRangeRemap(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, float scale, float offset, int nthreads = 0);
+
+// Shapes alpha by 1/gamma, premultiplies color by it and optionally captures the
+// unshaped alpha, all in one pass over a packed uint8/uint16/float gray+alpha or
+// RGBA image. Returns false for other layouts so callers can fall back.
+bool
+applyAlphaPreprocess(OIIO::ImageBuf& image, float gamma, bool premultiply, OIIO::ImageBuf* originalAlpha = nullptr,
+                     int nthreads = 0);
+
+// One step of the chain writeSolidifyTarget runs on the fill result. Only the fields of the step's kind are read.
+struct PostFillOp {
+    enum Kind {
+        ReplaceAlpha,  // alpha: 1-channel image pasted over the trailing alpha channel at its own origin
+        Normalize,     // inCenter, outCenter, scale
+        RecalcNormal,  // channel, sign, inCenter, outCenter, scale
+        RangeRemap,    // scale, offset
+        SwapInvert,    // basis, invertMask, signedRange
+        Grayscale,     // mode, weights, preserveAlpha
+    };
+
+    Kind kind                   = RangeRemap;
+    const OIIO::ImageBuf* alpha = nullptr;
+    bool clearOutside           = false;  // ReplaceAlpha zeroes alpha outside the alpha image's window
+    unsigned int channel        = 2;
+    int sign                    = 1;
+    float inCenter              = 0.5f;
+    float outCenter             = 0.5f;
+    float scale                 = 0.5f;
+    float offset                = 0.0f;
+    unsigned int basis          = 0;
+    unsigned int invertMask     = 0;
+    bool signedRange            = false;
+    unsigned int mode           = 0;
+    float weights[3]            = { 0.2126f, 0.7152f, 0.0722f };
+    bool preserveAlpha          = false;
+};
+
+// Runs ops in one pass over src, keeping intermediate values in registers instead of a buffer per step. Results
+// match running the single-step functions in order to within one integer code. dst may be src. Returns false
+// without touching dst's pixels when an op or the image layout is not supported, so callers can run the steps
+// one by one instead.
+bool
+applyPostFillOps(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const std::vector<PostFillOp>& ops,
+                 int nthreads = 0);
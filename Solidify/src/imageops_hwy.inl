@@ -25,7 +25,10 @@
 
 #    include <hwy/highway.h>
 
+#    include <algorithm>
+#    include <cmath>
 #    include <cstdint>
+#    include <cstring>
 #    include <limits>
 #    include <type_traits>
 
@@ -308,6 +311,593 @@ namespace HWY_NAMESPACE {
             return true;
         }
 
+        template<typename T, typename WideT>
+        HWY_ATTR hn::VFromD<hn::ScalableTag<T>> premultiplyFixed(const hn::ScalableTag<T> d,
+                                                                 const hn::VFromD<hn::ScalableTag<T>> v,
+                                                                 const hn::VFromD<hn::ScalableTag<T>> a)
+        {
+            // round(v * a / max) without a divide: t = v * a + half, (t + (t >> bits)) >> bits.
+            constexpr int kBits = static_cast<int>(sizeof(T) * 8);
+            const hn::Repartition<WideT, decltype(d)> dw;
+            const auto round = hn::Set(dw, static_cast<WideT>(WideT(1) << (kBits - 1)));
+
+            auto lo = hn::MulAdd(hn::PromoteLowerTo(dw, v), hn::PromoteLowerTo(dw, a), round);
+            lo      = hn::ShiftRight<kBits>(hn::Add(lo, hn::ShiftRight<kBits>(lo)));
+            auto hi = hn::MulAdd(hn::PromoteUpperTo(dw, v), hn::PromoteUpperTo(dw, a), round);
+            hi      = hn::ShiftRight<kBits>(hn::Add(hi, hn::ShiftRight<kBits>(hi)));
+            return hn::OrderedDemote2To(d, lo, hi);
+        }
+
+        template<typename T, typename WideT> HWY_ATTR T premultiplyScalar(const T v, const T a)
+        {
+            if constexpr (std::is_floating_point_v<T>) {
+                return v * a;
+            } else {
+                constexpr int kBits = static_cast<int>(sizeof(T) * 8);
+                const WideT t       = static_cast<WideT>(v) * a + (WideT(1) << (kBits - 1));
+                return static_cast<T>((t + (t >> kBits)) >> kBits);
+            }
+        }
+
+        template<typename T> HWY_ATTR T shapeAlphaScalar(const T a, const SolidifyHwyAlphaOp* op)
+        {
+            if constexpr (std::is_floating_point_v<T>) {
+                const T clamped = std::min(std::max(a, static_cast<T>(0)), static_cast<T>(1));
+                return static_cast<T>(std::pow(clamped, static_cast<T>(op->exponent)));
+            } else {
+                return static_cast<const T*>(op->gammaLut)[a];
+            }
+        }
+
+        template<typename T, typename WideT>
+        HWY_ATTR bool alphaPreprocessTyped(const SolidifyHwyAlphaView* view, const SolidifyHwyAlphaOp* op)
+        {
+            const hn::ScalableTag<T> d;
+            using V             = hn::VFromD<decltype(d)>;
+            const int lanes     = static_cast<int>(hn::Lanes(d));
+            const int nch       = view->channels;
+            const int alpha     = nch - 1;
+            const bool shape    = op->shapeAlpha != 0;
+            const bool perPixel = shape || view->original != nullptr;
+
+            if constexpr (!std::is_floating_point_v<T>) {
+                if (shape && op->gammaLut == nullptr) {
+                    return false;
+                }
+            }
+
+            // Capture and shaping touch one vector block of alpha at a time, right before the same
+            // block is loaded for premultiplication, so every pixel is read from memory once.
+            for (int y = 0; y < view->height; ++y) {
+                T* row  = reinterpret_cast<T*>(static_cast<uint8_t*>(view->pixels)
+                                              + static_cast<size_t>(y) * view->rowStride);
+                T* orig = view->original != nullptr
+                              ? reinterpret_cast<T*>(static_cast<uint8_t*>(view->original)
+                                                     + static_cast<size_t>(y) * view->originalRowStride)
+                              : nullptr;
+
+                for (int x = 0; x < view->width; x += lanes) {
+                    const int count = std::min(lanes, view->width - x);
+                    T* block        = row + static_cast<size_t>(x) * nch;
+                    if (perPixel) {
+                        for (int i = 0; i < count; ++i) {
+                            T& a = block[static_cast<size_t>(i) * nch + alpha];
+                            if (orig != nullptr) {
+                                orig[x + i] = a;
+                            }
+                            if (shape) {
+                                a = shapeAlphaScalar<T>(a, op);
+                            }
+                        }
+                    }
+                    if (op->premultiply == 0) {
+                        continue;
+                    }
+
+                    if (count == lanes) {
+                        if (nch == 4) {
+                            V r, g, b, a;
+                            hn::LoadInterleaved4(d, block, r, g, b, a);
+                            if constexpr (std::is_floating_point_v<T>) {
+                                r = hn::Mul(r, a);
+                                g = hn::Mul(g, a);
+                                b = hn::Mul(b, a);
+                            } else {
+                                r = premultiplyFixed<T, WideT>(d, r, a);
+                                g = premultiplyFixed<T, WideT>(d, g, a);
+                                b = premultiplyFixed<T, WideT>(d, b, a);
+                            }
+                            hn::StoreInterleaved4(r, g, b, a, d, block);
+                        } else {
+                            V v, a;
+                            hn::LoadInterleaved2(d, block, v, a);
+                            if constexpr (std::is_floating_point_v<T>) {
+                                v = hn::Mul(v, a);
+                            } else {
+                                v = premultiplyFixed<T, WideT>(d, v, a);
+                            }
+                            hn::StoreInterleaved2(v, a, d, block);
+                        }
+                    } else {
+                        for (int i = 0; i < count; ++i) {
+                            T* p = block + static_cast<size_t>(i) * nch;
+                            for (int c = 0; c < alpha; ++c) {
+                                p[c] = premultiplyScalar<T, WideT>(p[c], p[alpha]);
+                            }
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Packed storage of each supported channel type; half is moved around as its bit pattern.
+        template<typename T> using StorageT = std::conditional_t<std::is_same_v<T, hwy::float16_t>, uint16_t, T>;
+
+        // Channel values as float: unsigned integers are scaled to 0..1 and half is widened.
+        template<typename T, class DF, class VS> HWY_ATTR hn::VFromD<DF> toFloat(const DF df, const VS v)
+        {
+            if constexpr (std::is_same_v<T, float>) {
+                return v;
+            } else if constexpr (std::is_same_v<T, hwy::float16_t>) {
+                const hn::Rebind<hwy::float16_t, DF> dh;
+                return hn::PromoteTo(df, hn::BitCast(dh, v));
+            } else {
+                const hn::Rebind<int32_t, DF> di;
+                constexpr float kScale = 1.0f / static_cast<float>(std::numeric_limits<T>::max());
+                return hn::Mul(hn::ConvertTo(df, hn::PromoteTo(di, v)), hn::Set(df, kScale));
+            }
+        }
+
+        // Back to storage with OIIO's conversion rules: integers are clamped and rounded half up.
+        template<typename T, class DF>
+        HWY_ATTR hn::VFromD<hn::Rebind<StorageT<T>, DF>> fromFloat(const DF df, const hn::VFromD<DF> v)
+        {
+            const hn::Rebind<StorageT<T>, DF> ds;
+            if constexpr (std::is_same_v<T, float>) {
+                (void)ds;
+                return v;
+            } else if constexpr (std::is_same_v<T, hwy::float16_t>) {
+                const hn::Rebind<hwy::float16_t, DF> dh;
+                return hn::BitCast(ds, hn::DemoteTo(dh, v));
+            } else {
+                const hn::Rebind<int32_t, DF> di;
+                const auto maxValue = hn::Set(df, static_cast<float>(std::numeric_limits<T>::max()));
+                const auto scaled   = hn::MulAdd(v, maxValue, hn::Set(df, 0.5f));
+                return hn::DemoteTo(ds, hn::ConvertTo(di, hn::Min(hn::Max(scaled, hn::Zero(df)), maxValue)));
+            }
+        }
+
+        template<typename T> HWY_ATTR float toFloatScalar(const StorageT<T> v)
+        {
+            if constexpr (std::is_same_v<T, float>) {
+                return v;
+            } else if constexpr (std::is_same_v<T, hwy::float16_t>) {
+                hwy::float16_t h;
+                std::memcpy(&h, &v, sizeof(h));
+                return hwy::F32FromF16(h);
+            } else {
+                return static_cast<float>(v) * (1.0f / static_cast<float>(std::numeric_limits<T>::max()));
+            }
+        }
+
+        template<typename T> HWY_ATTR StorageT<T> fromFloatScalar(const float v)
+        {
+            if constexpr (std::is_same_v<T, float>) {
+                return v;
+            } else if constexpr (std::is_same_v<T, hwy::float16_t>) {
+                const hwy::float16_t h = hwy::F16FromF32(v);
+                uint16_t bits;
+                std::memcpy(&bits, &h, sizeof(bits));
+                return bits;
+            } else {
+                const float maxValue = static_cast<float>(std::numeric_limits<T>::max());
+                return static_cast<T>(std::min(std::max(v * maxValue + 0.5f, 0.0f), maxValue));
+            }
+        }
+
+        // Same math as ImageBufAlgo::normalize (recalc == 0) and recalc_normal (recalc != 0).
+        HWY_ATTR void normalScalar(float c[3], const SolidifyHwyNormalOp* op)
+        {
+            if (op->recalc == 0) {
+                const float x      = c[0] - op->inCenter;
+                const float y      = c[1] - op->inCenter;
+                const float z      = c[2] - op->inCenter;
+                const float length = std::sqrt(x * x + y * y + z * z);
+                const float s      = length > 0.0f ? op->scale / length : 0.0f;
+                c[0]               = x * s + op->outCenter;
+                c[1]               = y * s + op->outCenter;
+                c[2]               = z * s + op->outCenter;
+                return;
+            }
+
+            float t[3];
+            for (int i = 0; i < 3; ++i) {
+                t[i] = op->channel == i ? 0.0f : (c[i] - op->inCenter) / op->scale;
+            }
+            const bool isZero  = (std::abs(t[0]) + std::abs(t[1]) + std::abs(t[2])) == 0.0f;
+            const float lenSq  = t[0] * t[0] + t[1] * t[1] + t[2] * t[2];
+            const float recomp = isZero ? 0.0f : std::sqrt(std::max(0.0f, 1.0f - lenSq));
+            t[op->channel]     = op->sign * recomp;
+
+            const float length = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+            const float s      = length > 0.0f ? op->scale / length : op->scale;
+            for (int i = 0; i < 3; ++i) {
+                c[i] = t[i] * s + op->outCenter;
+            }
+        }
+
+        template<class DF>
+        HWY_ATTR void normalVec(const DF df, hn::VFromD<DF>& c0, hn::VFromD<DF>& c1, hn::VFromD<DF>& c2,
+                                const SolidifyHwyNormalOp* op)
+        {
+            const auto zero      = hn::Zero(df);
+            const auto inCenter  = hn::Set(df, op->inCenter);
+            const auto outCenter = hn::Set(df, op->outCenter);
+            const auto scale     = hn::Set(df, op->scale);
+
+            if (op->recalc == 0) {
+                const auto x      = hn::Sub(c0, inCenter);
+                const auto y      = hn::Sub(c1, inCenter);
+                const auto z      = hn::Sub(c2, inCenter);
+                const auto length = hn::Sqrt(hn::MulAdd(z, z, hn::MulAdd(y, y, hn::Mul(x, x))));
+                const auto s      = hn::IfThenElseZero(hn::Gt(length, zero), hn::Div(scale, length));
+                c0                = hn::MulAdd(x, s, outCenter);
+                c1                = hn::MulAdd(y, s, outCenter);
+                c2                = hn::MulAdd(z, s, outCenter);
+                return;
+            }
+
+            auto t0 = op->channel == 0 ? zero : hn::Div(hn::Sub(c0, inCenter), scale);
+            auto t1 = op->channel == 1 ? zero : hn::Div(hn::Sub(c1, inCenter), scale);
+            auto t2 = op->channel == 2 ? zero : hn::Div(hn::Sub(c2, inCenter), scale);
+
+            const auto isZero = hn::Eq(hn::Add(hn::Add(hn::Abs(t0), hn::Abs(t1)), hn::Abs(t2)), zero);
+            const auto lenSq  = hn::MulAdd(t2, t2, hn::MulAdd(t1, t1, hn::Mul(t0, t0)));
+            auto recomp       = hn::IfThenZeroElse(isZero, hn::Sqrt(hn::Max(zero, hn::Sub(hn::Set(df, 1.0f), lenSq))));
+            recomp            = hn::Mul(recomp, hn::Set(df, op->sign));
+            switch (op->channel) {
+            case 0: t0 = recomp; break;
+            case 1: t1 = recomp; break;
+            default: t2 = recomp; break;
+            }
+
+            const auto length = hn::Sqrt(hn::MulAdd(t2, t2, hn::MulAdd(t1, t1, hn::Mul(t0, t0))));
+            const auto s      = hn::IfThenElse(hn::Gt(length, zero), hn::Div(scale, length), scale);
+            c0                = hn::MulAdd(t0, s, outCenter);
+            c1                = hn::MulAdd(t1, s, outCenter);
+            c2                = hn::MulAdd(t2, s, outCenter);
+        }
+
+        template<typename T>
+        HWY_ATTR bool normalTyped(const SolidifyHwyImageView* view, const SolidifyHwyNormalOp* op)
+        {
+            using S = StorageT<T>;
+            const hn::ScalableTag<float> df;
+            const hn::Rebind<S, decltype(df)> ds;
+            using VS        = hn::VFromD<decltype(ds)>;
+            const int lanes = static_cast<int>(hn::Lanes(df));
+            const int nch   = view->srcChannels;
+
+            for (int y = 0; y < view->height; ++y) {
+                const S* src = reinterpret_cast<const S*>(static_cast<const uint8_t*>(view->src)
+                                                          + static_cast<size_t>(y) * view->srcRowStride);
+                S* dst       = reinterpret_cast<S*>(static_cast<uint8_t*>(view->dst)
+                                              + static_cast<size_t>(y) * view->dstRowStride);
+
+                int x = 0;
+                for (; x + lanes <= view->width; x += lanes) {
+                    const S* in = src + static_cast<size_t>(x) * nch;
+                    S* out      = dst + static_cast<size_t>(x) * nch;
+                    VS s0, s1, s2, s3;
+                    if (nch == 4) {
+                        hn::LoadInterleaved4(ds, in, s0, s1, s2, s3);
+                    } else {
+                        hn::LoadInterleaved3(ds, in, s0, s1, s2);
+                        s3 = hn::Zero(ds);
+                    }
+
+                    auto c0 = toFloat<T>(df, s0);
+                    auto c1 = toFloat<T>(df, s1);
+                    auto c2 = toFloat<T>(df, s2);
+                    normalVec(df, c0, c1, c2, op);
+
+                    // Alpha is passed through in its stored form.
+                    s0 = fromFloat<T>(df, c0);
+                    s1 = fromFloat<T>(df, c1);
+                    s2 = fromFloat<T>(df, c2);
+                    if (nch == 4) {
+                        hn::StoreInterleaved4(s0, s1, s2, s3, ds, out);
+                    } else {
+                        hn::StoreInterleaved3(s0, s1, s2, ds, out);
+                    }
+                }
+
+                for (; x < view->width; ++x) {
+                    const S* in = src + static_cast<size_t>(x) * nch;
+                    S* out      = dst + static_cast<size_t>(x) * nch;
+                    float c[3]  = { toFloatScalar<T>(in[0]), toFloatScalar<T>(in[1]), toFloatScalar<T>(in[2]) };
+                    normalScalar(c, op);
+                    const S alpha = nch == 4 ? in[3] : S {};
+                    out[0]        = fromFloatScalar<T>(c[0]);
+                    out[1]        = fromFloatScalar<T>(c[1]);
+                    out[2]        = fromFloatScalar<T>(c[2]);
+                    if (nch == 4) {
+                        out[3] = alpha;
+                    }
+                }
+            }
+            return true;
+        }
+
+        template<typename T>
+        HWY_ATTR bool rangeTyped(const SolidifyHwyImageView* view, const SolidifyHwyRangeOp* op)
+        {
+            using S = StorageT<T>;
+            const hn::ScalableTag<float> df;
+            const hn::Rebind<S, decltype(df)> ds;
+            const int lanes   = static_cast<int>(hn::Lanes(df));
+            const int count   = view->width * view->srcChannels;
+            const auto scale  = hn::Set(df, op->scale);
+            const auto offset = hn::Set(df, op->offset);
+
+            // Every channel is remapped, alpha included, as ImageBufAlgo::mad does.
+            for (int y = 0; y < view->height; ++y) {
+                const S* src = reinterpret_cast<const S*>(static_cast<const uint8_t*>(view->src)
+                                                          + static_cast<size_t>(y) * view->srcRowStride);
+                S* dst       = reinterpret_cast<S*>(static_cast<uint8_t*>(view->dst)
+                                              + static_cast<size_t>(y) * view->dstRowStride);
+
+                int i = 0;
+                for (; i + lanes <= count; i += lanes) {
+                    const auto v = hn::MulAdd(toFloat<T>(df, hn::LoadU(ds, src + i)), scale, offset);
+                    hn::StoreU(fromFloat<T>(df, v), ds, dst + i);
+                }
+                for (; i < count; ++i) {
+                    dst[i] = fromFloatScalar<T>(toFloatScalar<T>(src[i]) * op->scale + op->offset);
+                }
+            }
+            return true;
+        }
+
+        // Integer storage cannot hold values outside 0..1, so they are clamped after every post-fill step, exactly
+        // where writing each step's own buffer used to clamp them.
+        template<typename T, class DF> HWY_ATTR hn::VFromD<DF> settleVec(const DF df, const hn::VFromD<DF> v)
+        {
+            if constexpr (std::is_same_v<T, float> || std::is_same_v<T, hwy::float16_t>) {
+                (void)df;
+                return v;
+            } else {
+                return hn::Min(hn::Max(v, hn::Zero(df)), hn::Set(df, 1.0f));
+            }
+        }
+
+        template<typename T> HWY_ATTR float settleScalar(const float v)
+        {
+            if constexpr (std::is_same_v<T, float> || std::is_same_v<T, hwy::float16_t>) {
+                return v;
+            } else {
+                return std::min(std::max(v, 0.0f), 1.0f);
+            }
+        }
+
+        template<typename T, class DF>
+        HWY_ATTR void postFillVec(const DF df, hn::VFromD<DF>& c0, hn::VFromD<DF>& c1, hn::VFromD<DF>& c2,
+                                  hn::VFromD<DF>& c3, const bool alphaValid, const hn::VFromD<DF> alpha,
+                                  const SolidifyHwyPostFillPlan* plan, int nch)
+        {
+            constexpr bool kFloat = std::is_same_v<T, float> || std::is_same_v<T, hwy::float16_t>;
+            const auto one        = hn::Set(df, 1.0f);
+            for (int i = 0; i < plan->stepCount; ++i) {
+                const SolidifyHwyPostFillStep& step = plan->steps[i];
+                switch (step.kind) {
+                case SolidifyHwyPostFill_ReplaceAlpha:
+                    if (alphaValid) {
+                        (nch == 4 ? c3 : c1) = alpha;
+                    }
+                    break;
+                case SolidifyHwyPostFill_Normal: normalVec(df, c0, c1, c2, &step.normal); break;
+                case SolidifyHwyPostFill_Range: {
+                    const auto scale  = hn::Set(df, step.range.scale);
+                    const auto offset = hn::Set(df, step.range.offset);
+                    c0                = hn::MulAdd(c0, scale, offset);
+                    c1                = hn::MulAdd(c1, scale, offset);
+                    c2                = hn::MulAdd(c2, scale, offset);
+                    c3                = hn::MulAdd(c3, scale, offset);
+                    break;
+                }
+                case SolidifyHwyPostFill_SwapInvert: {
+                    const auto r = c0;
+                    const auto g = c1;
+                    const auto b = c2;
+                    c0           = selectRgb(r, g, b, step.swap.order[0]);
+                    c1           = selectRgb(r, g, b, step.swap.order[1]);
+                    c2           = selectRgb(r, g, b, step.swap.order[2]);
+                    // Integers invert as max - v, which is 1 - v here; signed float data negates instead.
+                    const bool negate = kFloat && step.swap.signedRange != 0;
+                    if ((step.swap.invertMask & 1u) != 0) {
+                        c0 = negate ? hn::Neg(c0) : hn::Sub(one, c0);
+                    }
+                    if ((step.swap.invertMask & 2u) != 0) {
+                        c1 = negate ? hn::Neg(c1) : hn::Sub(one, c1);
+                    }
+                    if ((step.swap.invertMask & 4u) != 0) {
+                        c2 = negate ? hn::Neg(c2) : hn::Sub(one, c2);
+                    }
+                    break;
+                }
+                case SolidifyHwyPostFill_Grayscale: {
+                    auto gray = c0;
+                    switch (step.gray.mode) {
+                    case 2: gray = c1; break;
+                    case 3: gray = c2; break;
+                    case 4: gray = nch == 4 ? c3 : c0; break;
+                    case 5:
+                    case 6:
+                    case 7:
+                        gray = hn::MulAdd(c2, hn::Set(df, step.gray.weights[2]),
+                                          hn::MulAdd(c1, hn::Set(df, step.gray.weights[1]),
+                                                     hn::Mul(c0, hn::Set(df, step.gray.weights[0]))));
+                        break;
+                    default: break;
+                    }
+                    c1  = nch == 4 ? c3 : c0;
+                    c0  = gray;
+                    nch = step.outChannels;
+                    break;
+                }
+                default: break;
+                }
+                c0 = settleVec<T>(df, c0);
+                c1 = settleVec<T>(df, c1);
+                c2 = settleVec<T>(df, c2);
+                c3 = settleVec<T>(df, c3);
+            }
+        }
+
+        template<typename T>
+        HWY_ATTR void postFillScalar(float c[4], const bool alphaValid, const float alpha,
+                                     const SolidifyHwyPostFillPlan* plan, int nch)
+        {
+            constexpr bool kFloat = std::is_same_v<T, float> || std::is_same_v<T, hwy::float16_t>;
+            for (int i = 0; i < plan->stepCount; ++i) {
+                const SolidifyHwyPostFillStep& step = plan->steps[i];
+                switch (step.kind) {
+                case SolidifyHwyPostFill_ReplaceAlpha:
+                    if (alphaValid) {
+                        c[nch == 4 ? 3 : 1] = alpha;
+                    }
+                    break;
+                case SolidifyHwyPostFill_Normal: normalScalar(c, &step.normal); break;
+                case SolidifyHwyPostFill_Range:
+                    for (int ch = 0; ch < 4; ++ch) {
+                        c[ch] = c[ch] * step.range.scale + step.range.offset;
+                    }
+                    break;
+                case SolidifyHwyPostFill_SwapInvert: {
+                    const float rgb[3] = { c[0], c[1], c[2] };
+                    const bool negate  = kFloat && step.swap.signedRange != 0;
+                    for (int ch = 0; ch < 3; ++ch) {
+                        c[ch] = rgb[step.swap.order[ch]];
+                        if ((step.swap.invertMask & (1u << ch)) != 0) {
+                            c[ch] = negate ? -c[ch] : 1.0f - c[ch];
+                        }
+                    }
+                    break;
+                }
+                case SolidifyHwyPostFill_Grayscale: {
+                    float gray = c[0];
+                    switch (step.gray.mode) {
+                    case 2: gray = c[1]; break;
+                    case 3: gray = c[2]; break;
+                    case 4: gray = nch == 4 ? c[3] : c[0]; break;
+                    case 5:
+                    case 6:
+                    case 7:
+                        gray = c[0] * step.gray.weights[0] + c[1] * step.gray.weights[1]
+                               + c[2] * step.gray.weights[2];
+                        break;
+                    default: break;
+                    }
+                    c[1] = nch == 4 ? c[3] : c[0];
+                    c[0] = gray;
+                    nch  = step.outChannels;
+                    break;
+                }
+                default: break;
+                }
+                for (int ch = 0; ch < 4; ++ch) {
+                    c[ch] = settleScalar<T>(c[ch]);
+                }
+            }
+        }
+
+        template<typename T>
+        HWY_ATTR bool postFillTyped(const SolidifyHwyImageView* view, const SolidifyHwyPostFillPlan* plan)
+        {
+            using S = StorageT<T>;
+            const hn::ScalableTag<float> df;
+            const hn::Rebind<S, decltype(df)> ds;
+            using VS        = hn::VFromD<decltype(ds)>;
+            const int lanes = static_cast<int>(hn::Lanes(df));
+            const int inCh  = view->srcChannels;
+            const int outCh = view->dstChannels;
+
+            for (int y = 0; y < view->height; ++y) {
+                const int py = view->y + y;
+                const S* src = reinterpret_cast<const S*>(static_cast<const uint8_t*>(view->src)
+                                                          + static_cast<size_t>(y) * view->srcRowStride);
+                S* dst       = reinterpret_cast<S*>(static_cast<uint8_t*>(view->dst)
+                                              + static_cast<size_t>(y) * view->dstRowStride);
+                const S* alphaRow = nullptr;
+                if (plan->alpha != nullptr && py >= plan->alphaYBegin && py < plan->alphaYEnd) {
+                    alphaRow = reinterpret_cast<const S*>(static_cast<const uint8_t*>(plan->alpha)
+                                                          + static_cast<size_t>(py - plan->alphaYBegin)
+                                                                * plan->alphaRowStride);
+                }
+
+                for (int x = 0; x < view->width; x += lanes) {
+                    const int px      = view->x + x;
+                    const int count   = std::min(lanes, view->width - x);
+                    const bool inside = alphaRow != nullptr && px >= plan->alphaXBegin
+                                        && px + count <= plan->alphaXEnd;
+                    const bool outside = alphaRow == nullptr || px + count <= plan->alphaXBegin
+                                         || px >= plan->alphaXEnd;
+                    const S* in = src + static_cast<size_t>(x) * inCh;
+                    S* out      = dst + static_cast<size_t>(x) * outCh;
+
+                    // Row tails and blocks cut by the alpha window edge go pixel by pixel.
+                    if (count < lanes || (!inside && !outside)) {
+                        for (int i = 0; i < count; ++i) {
+                            float c[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                            for (int ch = 0; ch < inCh; ++ch) {
+                                c[ch] = toFloatScalar<T>(in[static_cast<size_t>(i) * inCh + ch]);
+                            }
+                            const int ax        = px + i;
+                            const bool inWindow = alphaRow != nullptr && ax >= plan->alphaXBegin
+                                                  && ax < plan->alphaXEnd;
+                            const float alpha = inWindow ? toFloatScalar<T>(alphaRow[ax - plan->alphaXBegin]) : 0.0f;
+                            postFillScalar<T>(c, inWindow || plan->clearOutside != 0, alpha, plan, inCh);
+                            for (int ch = 0; ch < outCh; ++ch) {
+                                out[static_cast<size_t>(i) * outCh + ch] = fromFloatScalar<T>(c[ch]);
+                            }
+                        }
+                        continue;
+                    }
+
+                    VS s0 = hn::Zero(ds), s1 = hn::Zero(ds), s2 = hn::Zero(ds), s3 = hn::Zero(ds);
+                    switch (inCh) {
+                    case 1: s0 = hn::LoadU(ds, in); break;
+                    case 2: hn::LoadInterleaved2(ds, in, s0, s1); break;
+                    case 3: hn::LoadInterleaved3(ds, in, s0, s1, s2); break;
+                    default: hn::LoadInterleaved4(ds, in, s0, s1, s2, s3); break;
+                    }
+                    auto c0 = toFloat<T>(df, s0);
+                    auto c1 = toFloat<T>(df, s1);
+                    auto c2 = toFloat<T>(df, s2);
+                    auto c3 = toFloat<T>(df, s3);
+
+                    auto alpha = hn::Zero(df);
+                    if (inside) {
+                        alpha = toFloat<T>(df, hn::LoadU(ds, alphaRow + (px - plan->alphaXBegin)));
+                    }
+                    postFillVec<T>(df, c0, c1, c2, c3, inside || plan->clearOutside != 0, alpha, plan, inCh);
+
+                    s0 = fromFloat<T>(df, c0);
+                    s1 = fromFloat<T>(df, c1);
+                    s2 = fromFloat<T>(df, c2);
+                    s3 = fromFloat<T>(df, c3);
+                    switch (outCh) {
+                    case 1: hn::StoreU(s0, ds, out); break;
+                    case 2: hn::StoreInterleaved2(s0, s1, ds, out); break;
+                    case 3: hn::StoreInterleaved3(s0, s1, s2, ds, out); break;
+                    default: hn::StoreInterleaved4(s0, s1, s2, s3, ds, out); break;
+                    }
+                }
+            }
+            return true;
+        }
+
         bool SwapInvertKernel(const SolidifyHwyImageView* view, const SolidifyHwySwapOp* op)
         {
             if (view->srcChannels != view->dstChannels || (view->srcChannels != 3 && view->srcChannels != 4)) {
@@ -343,6 +933,66 @@ namespace HWY_NAMESPACE {
             }
         }
 
+        bool AlphaPreprocessKernel(const SolidifyHwyAlphaView* view, const SolidifyHwyAlphaOp* op)
+        {
+            if (view->channels != 2 && view->channels != 4) {
+                return false;
+            }
+
+            switch (view->pixelType) {
+            case SolidifyHwyPixelType_U8: return alphaPreprocessTyped<uint8_t, uint16_t>(view, op);
+            case SolidifyHwyPixelType_U16: return alphaPreprocessTyped<uint16_t, uint32_t>(view, op);
+            case SolidifyHwyPixelType_F32: return alphaPreprocessTyped<float, float>(view, op);
+            default: return false;
+            }
+        }
+
+        bool NormalKernel(const SolidifyHwyImageView* view, const SolidifyHwyNormalOp* op)
+        {
+            if (view->srcChannels != view->dstChannels || (view->srcChannels != 3 && view->srcChannels != 4)
+                || op->channel > 2) {
+                return false;
+            }
+
+            switch (view->pixelType) {
+            case SolidifyHwyPixelType_U8: return normalTyped<uint8_t>(view, op);
+            case SolidifyHwyPixelType_U16: return normalTyped<uint16_t>(view, op);
+            case SolidifyHwyPixelType_F16: return normalTyped<hwy::float16_t>(view, op);
+            case SolidifyHwyPixelType_F32: return normalTyped<float>(view, op);
+            default: return false;
+            }
+        }
+
+        bool RangeKernel(const SolidifyHwyImageView* view, const SolidifyHwyRangeOp* op)
+        {
+            if (view->srcChannels != view->dstChannels || view->srcChannels <= 0) {
+                return false;
+            }
+
+            switch (view->pixelType) {
+            case SolidifyHwyPixelType_U8: return rangeTyped<uint8_t>(view, op);
+            case SolidifyHwyPixelType_U16: return rangeTyped<uint16_t>(view, op);
+            case SolidifyHwyPixelType_F16: return rangeTyped<hwy::float16_t>(view, op);
+            case SolidifyHwyPixelType_F32: return rangeTyped<float>(view, op);
+            default: return false;
+            }
+        }
+
+        bool PostFillKernel(const SolidifyHwyImageView* view, const SolidifyHwyPostFillPlan* plan)
+        {
+            if (view->srcChannels < 1 || view->srcChannels > 4 || view->dstChannels < 1 || view->dstChannels > 4) {
+                return false;
+            }
+
+            switch (view->pixelType) {
+            case SolidifyHwyPixelType_U8: return postFillTyped<uint8_t>(view, plan);
+            case SolidifyHwyPixelType_U16: return postFillTyped<uint16_t>(view, plan);
+            case SolidifyHwyPixelType_F16: return postFillTyped<hwy::float16_t>(view, plan);
+            case SolidifyHwyPixelType_F32: return postFillTyped<float>(view, plan);
+            default: return false;
+            }
+        }
+
     }  // namespace
 }  // namespace HWY_NAMESPACE
 }  // namespace solidify_hwy
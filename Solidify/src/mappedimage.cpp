@@ -0,0 +1,515 @@
+/*
+ * Solidify - texture push-pull processing utility
+ * Copyright (c) 2023-2026 Erium Vladlen.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pch.h"
+
+#include "mappedimage.h"
+
+#include <bit>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+    }
+    if (m_file != nullptr) {
+        CloseHandle(static_cast<HANDLE>(m_file));
+    }
+#else
+    if (m_data != nullptr) {
+        munmap(m_data, m_size);
+    }
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+#endif
+}
+
+std::unique_ptr<MappedFile>
+MappedFile::openRead(const std::string& path)
+{
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+#ifdef _WIN32
+    HANDLE file = CreateFileW(std::filesystem::path(path).wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    mapped->m_file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        return nullptr;
+    }
+    mapped->m_size = static_cast<size_t>(size.QuadPart);
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+    mapped->m_mapping = mapping;
+    mapped->m_data    = static_cast<unsigned char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+#else
+    mapped->m_fd = open(path.c_str(), O_RDONLY);
+    if (mapped->m_fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(mapped->m_fd, &st) != 0 || st.st_size <= 0) {
+        return nullptr;
+    }
+    mapped->m_size = static_cast<size_t>(st.st_size);
+    void* data     = mmap(nullptr, mapped->m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, mapped->m_fd, 0);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    mapped->m_data = static_cast<unsigned char*>(data);
+#endif
+    if (mapped->m_data == nullptr) {
+        return nullptr;
+    }
+    return mapped;
+}
+
+std::unique_ptr<MappedFile>
+MappedFile::createWrite(const std::string& path, const size_t size)
+{
+    if (size == 0) {
+        return nullptr;
+    }
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+    mapped->m_size = size;
+#ifdef _WIN32
+    HANDLE file = CreateFileW(std::filesystem::path(path).wstring().c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    mapped->m_file = file;
+    LARGE_INTEGER mappingSize;
+    mappingSize.QuadPart = static_cast<LONGLONG>(size);
+    HANDLE mapping       = CreateFileMappingW(file, nullptr, PAGE_READWRITE, mappingSize.HighPart, mappingSize.LowPart,
+                                              nullptr);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+    mapped->m_mapping = mapping;
+    mapped->m_data    = static_cast<unsigned char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0));
+#else
+    mapped->m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (mapped->m_fd < 0) {
+        return nullptr;
+    }
+    if (ftruncate(mapped->m_fd, static_cast<off_t>(size)) != 0) {
+        return nullptr;
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, mapped->m_fd, 0);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    mapped->m_data = static_cast<unsigned char*>(data);
+#endif
+    if (mapped->m_data == nullptr) {
+        return nullptr;
+    }
+    return mapped;
+}
+
+namespace {
+
+struct MappedLayout {
+    int width             = 0;
+    int height            = 0;
+    int channels          = 0;
+    OIIO::TypeDesc format = OIIO::TypeDesc::UNKNOWN;
+    size_t offset         = 0;
+};
+
+static std::string
+lowerExtension(const std::string& path)
+{
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext;
+}
+
+static size_t
+layoutBytes(const MappedLayout& layout)
+{
+    return static_cast<size_t>(layout.width) * static_cast<size_t>(layout.height)
+           * static_cast<size_t>(layout.channels) * layout.format.size();
+}
+
+// Cursor over a text PNM/PFM header.
+class HeaderReader {
+public:
+    HeaderReader(const unsigned char* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    bool token(std::string* out)
+    {
+        skipSpaceAndComments();
+        out->clear();
+        while (m_pos < m_size && !std::isspace(m_data[m_pos]) && out->size() < 32) {
+            out->push_back(static_cast<char>(m_data[m_pos++]));
+        }
+        return !out->empty();
+    }
+
+    bool integer(int* out)
+    {
+        std::string text;
+        if (!token(&text)) {
+            return false;
+        }
+        char* end = nullptr;
+        long v    = std::strtol(text.c_str(), &end, 10);
+        if (end == nullptr || *end != '\0' || v <= 0 || v > 1000000) {
+            return false;
+        }
+        *out = static_cast<int>(v);
+        return true;
+    }
+
+    // Exactly one whitespace byte separates the header from the raster.
+    bool endOfHeader(size_t* offset)
+    {
+        if (m_pos >= m_size || !std::isspace(m_data[m_pos])) {
+            return false;
+        }
+        *offset = m_pos + 1;
+        return true;
+    }
+
+private:
+    void skipSpaceAndComments()
+    {
+        while (m_pos < m_size) {
+            if (std::isspace(m_data[m_pos])) {
+                ++m_pos;
+            } else if (m_data[m_pos] == '#') {
+                while (m_pos < m_size && m_data[m_pos] != '\n') {
+                    ++m_pos;
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    const unsigned char* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+};
+
+static bool
+parsePnm(const MappedFile& file, MappedLayout* layout)
+{
+    HeaderReader reader(file.data(), file.size());
+    std::string magic;
+    int maxval = 0;
+    if (!reader.token(&magic) || (magic != "P5" && magic != "P6")) {
+        return false;
+    }
+    if (!reader.integer(&layout->width) || !reader.integer(&layout->height) || !reader.integer(&maxval)
+        || !reader.endOfHeader(&layout->offset)) {
+        return false;
+    }
+    // Only full-range samples map onto OIIO's normalized integer types without rescaling.
+    if (maxval != 255 && maxval != 65535) {
+        return false;
+    }
+    // 16-bit samples are big-endian on disk and only wrap as they are on a big-endian host.
+    if (maxval == 65535 && std::endian::native != std::endian::big) {
+        return false;
+    }
+    layout->channels = magic == "P5" ? 1 : 3;
+    layout->format   = maxval == 255 ? OIIO::TypeDesc::UINT8 : OIIO::TypeDesc::UINT16;
+    return true;
+}
+
+class TiffReader {
+public:
+    explicit TiffReader(const MappedFile& file)
+        : m_data(file.data())
+        , m_size(file.size())
+    {
+    }
+
+    bool u16(size_t offset, uint32_t* out) const
+    {
+        if (offset + 2 > m_size) {
+            return false;
+        }
+        uint16_t v;
+        std::memcpy(&v, m_data + offset, 2);
+        *out = v;
+        return true;
+    }
+
+    bool u32(size_t offset, uint32_t* out) const
+    {
+        if (offset + 4 > m_size) {
+            return false;
+        }
+        std::memcpy(out, m_data + offset, 4);
+        return true;
+    }
+
+    // Reads element index of a SHORT or LONG entry, inline or at its value offset.
+    bool value(size_t entry, uint32_t index, uint32_t* out) const
+    {
+        uint32_t type  = 0;
+        uint32_t count = 0;
+        if (!u16(entry + 2, &type) || !u32(entry + 4, &count) || index >= count) {
+            return false;
+        }
+        const size_t size = type == 3 ? 2u : (type == 4 ? 4u : 0u);
+        if (size == 0) {
+            return false;
+        }
+        size_t offset = entry + 8;
+        if (static_cast<size_t>(count) * size > 4) {
+            uint32_t pointer = 0;
+            if (!u32(entry + 8, &pointer)) {
+                return false;
+            }
+            offset = pointer;
+        }
+        offset += static_cast<size_t>(index) * size;
+        return size == 2 ? u16(offset, out) : u32(offset, out);
+    }
+
+    bool count(size_t entry, uint32_t* out) const { return u32(entry + 4, out); }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+};
+
+static bool
+parseTiff(const MappedFile& file, MappedLayout* layout)
+{
+    // Little-endian classic TIFF only; wrapped pixels are used in host byte order.
+    if (std::endian::native != std::endian::little || file.size() < 8
+        || std::memcmp(file.data(), "II*\0", 4) != 0) {
+        return false;
+    }
+    TiffReader tiff(file);
+    uint32_t ifd     = 0;
+    uint32_t entries = 0;
+    if (!tiff.u32(4, &ifd) || !tiff.u16(ifd, &entries)) {
+        return false;
+    }
+
+    uint32_t width = 0, height = 0, bits = 0, compression = 1, samples = 1, planar = 1, predictor = 1;
+    uint32_t sampleFormat = 1, photometric = 1, rowsPerStrip = 0;
+    size_t stripOffsets = 0, stripCounts = 0;
+    for (uint32_t i = 0; i < entries; ++i) {
+        const size_t entry = ifd + 2u + static_cast<size_t>(i) * 12u;
+        uint32_t tag       = 0;
+        if (!tiff.u16(entry, &tag)) {
+            return false;
+        }
+        bool ok = true;
+        switch (tag) {
+        case 256: ok = tiff.value(entry, 0, &width); break;
+        case 257: ok = tiff.value(entry, 0, &height); break;
+        case 258: ok = tiff.value(entry, 0, &bits); break;
+        case 259: ok = tiff.value(entry, 0, &compression); break;
+        case 262: ok = tiff.value(entry, 0, &photometric); break;
+        case 273: stripOffsets = entry; break;
+        case 277: ok = tiff.value(entry, 0, &samples); break;
+        case 278: ok = tiff.value(entry, 0, &rowsPerStrip); break;
+        case 279: stripCounts = entry; break;
+        case 284: ok = tiff.value(entry, 0, &planar); break;
+        case 317: ok = tiff.value(entry, 0, &predictor); break;
+        case 322:
+        case 323: return false;  // tiled
+        case 339: ok = tiff.value(entry, 0, &sampleFormat); break;
+        default: break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    if (compression != 1 || planar != 1 || predictor != 1 || stripOffsets == 0 || stripCounts == 0) {
+        return false;
+    }
+    if (photometric != 1 && photometric != 2) {
+        return false;
+    }
+    if (width == 0 || height == 0 || samples == 0 || samples > 4) {
+        return false;
+    }
+
+    layout->width    = static_cast<int>(width);
+    layout->height   = static_cast<int>(height);
+    layout->channels = static_cast<int>(samples);
+    if (sampleFormat == 1 && bits == 8) {
+        layout->format = OIIO::TypeDesc::UINT8;
+    } else if (sampleFormat == 1 && bits == 16) {
+        layout->format = OIIO::TypeDesc::UINT16;
+    } else if (sampleFormat == 3 && bits == 16) {
+        layout->format = OIIO::TypeDesc::HALF;
+    } else if (sampleFormat == 3 && bits == 32) {
+        layout->format = OIIO::TypeDesc::FLOAT;
+    } else {
+        return false;
+    }
+
+    // The strips must form one contiguous raster for a single wrap.
+    uint32_t strips = 0;
+    uint32_t first  = 0;
+    if (!tiff.count(stripOffsets, &strips) || !tiff.value(stripOffsets, 0, &first)) {
+        return false;
+    }
+    size_t expected = first;
+    for (uint32_t s = 0; s < strips; ++s) {
+        uint32_t offset = 0;
+        uint32_t bytes  = 0;
+        if (!tiff.value(stripOffsets, s, &offset) || !tiff.value(stripCounts, s, &bytes) || offset != expected) {
+            return false;
+        }
+        expected += bytes;
+    }
+    layout->offset = first;
+    return expected - first == layoutBytes(*layout);
+}
+
+static void
+swapBytes16(unsigned char* data, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        std::swap(data[i * 2], data[i * 2 + 1]);
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<MappedImage>
+mapImageFile(const std::string& path, const OIIO::ImageSpec& expected)
+{
+    const std::string ext = lowerExtension(path);
+    const bool isPnm      = ext == ".ppm" || ext == ".pgm" || ext == ".pnm";
+    const bool isTiff     = ext == ".tif" || ext == ".tiff";
+    if (!isPnm && !isTiff) {
+        return nullptr;
+    }
+
+    std::unique_ptr<MappedFile> file = MappedFile::openRead(path);
+    if (!file) {
+        return nullptr;
+    }
+    MappedLayout layout;
+    const bool parsed = isPnm ? parsePnm(*file, &layout) : parseTiff(*file, &layout);
+    if (!parsed || layout.offset + layoutBytes(layout) > file->size()) {
+        return nullptr;
+    }
+    // OIIO has already parsed the header; only wrap when both readers agree on the raster.
+    if (expected.width != layout.width || expected.height != layout.height || expected.nchannels != layout.channels
+        || expected.format != layout.format || expected.depth != 1 || !expected.channelformats.empty()) {
+        return nullptr;
+    }
+
+    unsigned char* pixels = file->data() + layout.offset;
+
+    OIIO::ImageSpec spec = expected;
+    spec.x = spec.y = spec.z = 0;
+    auto mapped          = std::make_unique<MappedImage>();
+    mapped->buf          = OIIO::ImageBuf(spec, pixels);
+    mapped->file         = std::move(file);
+    return mapped;
+}
+
+bool
+canWriteMappedImage(const std::string& outputFileName, int nchannels, OIIO::TypeDesc format)
+{
+    const std::string ext = lowerExtension(outputFileName);
+    if (nchannels != 1 && nchannels != 3) {
+        return false;
+    }
+    if (ext == ".ppm" || ext == ".pgm" || ext == ".pnm") {
+        return (ext != ".ppm" || nchannels == 3) && (ext != ".pgm" || nchannels == 1)
+               && (format == OIIO::TypeDesc::UINT8 || format == OIIO::TypeDesc::UINT16);
+    }
+    return ext == ".pfm" && format == OIIO::TypeDesc::FLOAT && std::endian::native == std::endian::little;
+}
+
+bool
+writeMappedImage(const std::string& outputFileName, int width, int height, int nchannels, OIIO::TypeDesc format,
+                 OIIO::TypeDesc srcFormat, const void* src, OIIO::stride_t xstride, OIIO::stride_t ystride,
+                 int nthreads)
+{
+    if (!canWriteMappedImage(outputFileName, nchannels, format) || width <= 0 || height <= 0) {
+        return false;
+    }
+    const bool isPfm = format == OIIO::TypeDesc::FLOAT;
+    std::string header;
+    if (isPfm) {
+        header = std::string(nchannels == 3 ? "PF" : "Pf") + "\n" + std::to_string(width) + " "
+                 + std::to_string(height) + "\n-1.0\n";
+    } else {
+        header = std::string(nchannels == 3 ? "P6" : "P5") + "\n" + std::to_string(width) + " "
+                 + std::to_string(height) + "\n" + (format == OIIO::TypeDesc::UINT8 ? "255" : "65535") + "\n";
+    }
+    const size_t rowBytes = static_cast<size_t>(width) * static_cast<size_t>(nchannels) * format.size();
+    std::unique_ptr<MappedFile> file = MappedFile::createWrite(outputFileName,
+                                                               header.size() + rowBytes * static_cast<size_t>(height));
+    if (!file) {
+        return false;
+    }
+    std::memcpy(file->data(), header.data(), header.size());
+    unsigned char* raster = file->data() + header.size();
+
+    const bool swap16    = format == OIIO::TypeDesc::UINT16 && std::endian::native == std::endian::little;
+    std::atomic<bool> ok = true;
+    OIIO::ROI roi(0, width, 0, height, 0, 1, 0, nchannels);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        for (int y = chunk.ybegin; y < chunk.yend; ++y) {
+            // PFM stores rows bottom to top.
+            const int row      = isPfm ? height - 1 - y : y;
+            unsigned char* dst = raster + static_cast<size_t>(row) * rowBytes;
+            const char* srcRow = static_cast<const char*>(src) + static_cast<ptrdiff_t>(y) * ystride;
+            if (!OIIO::convert_image(nchannels, width, 1, 1, srcRow, srcFormat, xstride, ystride, OIIO::AutoStride,
+                                     dst, format, OIIO::AutoStride, OIIO::AutoStride, OIIO::AutoStride)) {
+                ok = false;
+                return;
+            }
+            if (swap16) {
+                swapBytes16(dst, rowBytes / 2);
+            }
+        }
+    });
+    return ok.load();
+}
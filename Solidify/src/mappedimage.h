@@ -0,0 +1,78 @@
+/*
+ * Solidify - texture push-pull processing utility
+ * Copyright (c) 2023-2026 Erium Vladlen.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <OpenImageIO/imagebuf.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// File mapped into memory. Read mappings are private copy-on-write views, so wrapped pixels can be modified in
+// place without touching the file on disk. Write mappings are shared views of a file pre-sized on creation.
+class MappedFile {
+public:
+    ~MappedFile();
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    static std::unique_ptr<MappedFile> openRead(const std::string& path);
+    static std::unique_ptr<MappedFile> createWrite(const std::string& path, size_t size);
+
+    unsigned char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    MappedFile() = default;
+
+    unsigned char* m_data = nullptr;
+    size_t m_size         = 0;
+#ifdef _WIN32
+    void* m_file    = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+// Mapped input whose pixels are wrapped by buf without a copy. The mapping must outlive buf and every ImageBuf
+// that wraps its pixels.
+struct MappedImage {
+    std::unique_ptr<MappedFile> file;
+    OIIO::ImageBuf buf;
+};
+
+// Maps a binary PGM/PPM or little-endian uncompressed strip TIFF and wraps its pixels with expected, the spec OIIO
+// reported for the file, so metadata is kept. Returns nullptr when the file is anything else, its layout does not
+// match expected, or its raster is not usable as stored, such as 16-bit PNM samples, which are big-endian, on a
+// little-endian host; callers then fall back to a regular read. PFM is never mapped since its rows are bottom-up.
+std::unique_ptr<MappedImage>
+mapImageFile(const std::string& path, const OIIO::ImageSpec& expected);
+
+// True when writeMappedImage can produce outputFileName: binary PGM/PPM with uint8 or uint16 samples, or PFM with
+// float samples, in one or three channels.
+bool
+canWriteMappedImage(const std::string& outputFileName, int nchannels, OIIO::TypeDesc format);
+
+// Writes width x height pixels of nchannels from src (in srcFormat with the given strides) by converting them
+// straight into a pre-sized mapped output file.
+bool
+writeMappedImage(const std::string& outputFileName, int width, int height, int nchannels, OIIO::TypeDesc format,
+                 OIIO::TypeDesc srcFormat, const void* src, OIIO::stride_t xstride, OIIO::stride_t ystride,
+                 int nthreads = 0);
@@ -20,6 +20,7 @@
 
 #include "processing.h"
 
+#include "batchcache.h"
 #include "imageio.h"
 #include "solidify.h"
 #include "threadpool.h"
@@ -56,17 +57,26 @@ checkAlpha(const std::vector<std::string>& fileNames)
 void
 getWritableExt(std::string* ext, Settings* settings)
 {
-    std::unique_ptr<ImageOutput> probe;
-    std::string fn = "probename" + *ext;
-    probe          = ImageOutput::create(fn);
-    if (probe) {
-        spdlog::info("{} is writable", *ext);
-    } else {
-        spdlog::info("{} is readonly", *ext);
-        spdlog::info("Output format changed to {}", settings->out_formats[settings->defFormat]);
+    // ImageOutput::create looks the plugin up on every call, so the answer is kept per extension.
+    static std::mutex writableMutex;
+    static std::unordered_map<std::string, bool> writable;
+
+    bool canWrite = false;
+    {
+        std::lock_guard<std::mutex> lock(writableMutex);
+        auto found = writable.find(*ext);
+        if (found == writable.end()) {
+            const bool probed = ImageOutput::create("probename" + *ext) != nullptr;
+            spdlog::info("{} is {}", *ext, probed ? "writable" : "readonly");
+            found = writable.emplace(*ext, probed).first;
+        }
+        canWrite = found->second;
+    }
+
+    if (!canWrite) {
+        spdlog::debug("Output format changed to {}", settings->out_formats[settings->defFormat]);
         *ext = "." + settings->out_formats[settings->defFormat];
     }
-    probe.reset();
 }
 
 std::string
@@ -96,6 +106,19 @@ getExtension(const std::string& fileName, Settings* settings)
     return extension;
 }
 
+// True when the file name contains one of the normal map substrings used by smart normalization.
+static bool
+hasNormalName(const std::string& fileName, const Settings& cfg)
+{
+    const std::string lowName = toLower(fs::path(fileName).stem().string());
+    for (const std::string& name : cfg.normNames) {
+        if (lowName.find(name) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::string
 getOutName(const std::string& fileName, Settings* settings)
 {
@@ -103,19 +126,13 @@ getOutName(const std::string& fileName, Settings* settings)
     std::string baseName = inPath.stem().string();
     std::string proc_sfx;
 
-    if (settings->isSolidify) {
+    if (!settings->outSuffix.empty()) {
+        proc_sfx = settings->outSuffix;
+    } else if (settings->isSolidify) {
         proc_sfx = "_fill";
     } else if (settings->normMode > 0) {
-        if (settings->normMode == 2) {
+        if (settings->normMode == 2 || hasNormalName(fileName, *settings)) {
             proc_sfx = "_norm";
-        } else {
-            const std::string lowName = toLower(baseName);
-            for (const std::string& name : settings->normNames) {
-                if (lowName.find(name) != std::string::npos) {
-                    proc_sfx = "_norm";
-                    break;
-                }
-            }
         }
     } else if (settings->repairMode > 0) {
         proc_sfx = "_rep";
@@ -137,9 +154,51 @@ getOutName(const std::string& fileName, Settings* settings)
     return outPath.string();
 }
 
+// Runs fn(i) for every i in [0, count) on pool and waits for all of them.
+template<typename Fn>
+static void
+parallelEach(ThreadPool* pool, size_t count, Fn&& fn)
+{
+    std::vector<std::future<void>> done;
+    done.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        done.push_back(pool->enqueue([&fn, i]() { fn(i); }));
+    }
+    for (std::future<void>& task : done) {
+        task.get();
+    }
+}
+
+struct DirectoryListing {
+    std::vector<std::string> files;
+    std::vector<fs::path> dirs;
+};
+
+static DirectoryListing
+listDirectory(const fs::path& dir)
+{
+    DirectoryListing listing;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        std::error_code typeEc;
+        if (it->is_directory(typeEc) && !it->is_symlink(typeEc)) {
+            listing.dirs.push_back(it->path());
+        } else if (it->is_regular_file(typeEc)) {
+            listing.files.push_back(it->path().string());
+        }
+    }
+    if (ec) {
+        spdlog::warn("Directory traversal warning for {}: {}", dir.string(), ec.message());
+    }
+    return listing;
+}
+
+// Walks the input directories one depth level at a time, listing every directory of a level on the pool.
 static void
-collectInputFiles(const std::vector<std::string>& inputs, std::vector<std::string>* fileNames)
+collectInputFiles(const std::vector<std::string>& inputs, ThreadPool* pool, std::vector<std::string>* fileNames)
 {
+    std::vector<fs::path> level;
     for (const std::string& input : inputs) {
         if (input.empty()) {
             continue;
@@ -148,23 +207,82 @@ collectInputFiles(const std::vector<std::string>& inputs, std::vector<std::strin
         std::error_code ec;
         fs::path p(input);
         if (fs::is_directory(p, ec)) {
-            for (const fs::directory_entry& entry :
-                 fs::recursive_directory_iterator(p, fs::directory_options::skip_permission_denied, ec)) {
-                if (ec) {
-                    spdlog::warn("Directory traversal warning for {}: {}", p.string(), ec.message());
-                    ec.clear();
-                    continue;
-                }
-                if (entry.is_regular_file(ec)) {
-                    fileNames->push_back(entry.path().string());
-                }
-            }
+            level.push_back(p);
         } else if (fs::is_regular_file(p, ec)) {
             fileNames->push_back(p.string());
         } else {
             spdlog::warn("Skipping non-file input: {}", input);
         }
     }
+
+    while (!level.empty()) {
+        std::vector<DirectoryListing> listings(level.size());
+        parallelEach(pool, level.size(), [&](size_t i) { listings[i] = listDirectory(level[i]); });
+
+        level.clear();
+        for (DirectoryListing& listing : listings) {
+            fileNames->insert(fileNames->end(), listing.files.begin(), listing.files.end());
+            level.insert(level.end(), listing.dirs.begin(), listing.dirs.end());
+        }
+    }
+    std::sort(fileNames->begin(), fileNames->end());
+}
+
+// Lower-case extensions, with the dot, of every format OIIO has a plugin for, from its "extension_list"
+// attribute ("tiff:tif,tiff;openexr:exr;...").
+static const std::unordered_set<std::string>&
+readableExtensions()
+{
+    static const std::unordered_set<std::string> extensions = [] {
+        std::unordered_set<std::string> result;
+        std::stringstream formats(OIIO::get_string_attribute("extension_list"));
+        std::string format;
+        while (std::getline(formats, format, ';')) {
+            const size_t colon = format.find(':');
+            std::stringstream list(colon == std::string::npos ? format : format.substr(colon + 1));
+            std::string ext;
+            while (std::getline(list, ext, ',')) {
+                if (!ext.empty()) {
+                    result.insert("." + toLower(ext));
+                }
+            }
+        }
+        return result;
+    }();
+    return extensions;
+}
+
+// Drops files no worker could read: extensions without an OIIO plugin right away, then every remaining candidate
+// is opened on the pool to check that its header parses.
+static std::vector<std::string>
+filterInputFiles(const std::vector<std::string>& fileNames, ThreadPool* pool)
+{
+    const std::unordered_set<std::string>& readable = readableExtensions();
+    std::vector<std::string> candidates;
+    candidates.reserve(fileNames.size());
+    for (const std::string& fileName : fileNames) {
+        if (readable.count(toLower(fs::path(fileName).extension().string())) != 0) {
+            candidates.push_back(fileName);
+        } else {
+            spdlog::debug("Skipping {}, not an image extension", fileName);
+        }
+    }
+
+    std::vector<char> headerOk(candidates.size(), 0);
+    parallelEach(pool, candidates.size(),
+                 [&](size_t i) { headerOk[i] = ImageInput::open(candidates[i]) != nullptr ? 1 : 0; });
+
+    std::vector<std::string> images;
+    images.reserve(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (headerOk[i]) {
+            images.push_back(candidates[i]);
+        } else {
+            spdlog::warn("Skipping {}, its header can't be read", candidates[i]);
+        }
+    }
+    spdlog::info("Found {} files, {} readable images.", fileNames.size(), images.size());
+    return images;
 }
 
 static std::string
@@ -173,13 +291,254 @@ fileNameOnly(const std::string& path)
     return fs::path(path).filename().string();
 }
 
+struct BatchJob {
+    std::string infile;
+    std::string outfile;                  // Single output, when targets is empty
+    std::vector<SolidifyTarget> targets;  // Fan-out outputs
+    std::vector<uint64_t> keys;           // Incremental cache key per output, empty when not cached
+    bool upToDate      = false;
+    bool collides      = false;     // Output shared with another job or named like an input; not processed
+    size_t duplicateOf = SIZE_MAX;  // Earlier job with the same keys whose outputs are copied
+};
+
+// The fill runs once with the global settings, and a dilation fill asked for its distance field writes one next to
+// every output.
+static bool
+writesDistanceFields()
+{
+    return settings.isSolidify && settings.fillEngine == FillEngine_Dilate && settings.dilateDistance;
+}
+
+// Every file a job writes: its outputs, followed by their distance fields when the fill writes them.
+static std::vector<std::string>
+jobOutputs(const BatchJob& job)
+{
+    std::vector<std::string> outputs;
+    if (job.targets.empty()) {
+        outputs.push_back(job.outfile);
+    }
+    for (const SolidifyTarget& target : job.targets) {
+        outputs.push_back(target.outputFileName);
+    }
+    if (writesDistanceFields()) {
+        const size_t count = outputs.size();
+        for (size_t o = 0; o < count; ++o) {
+            outputs.push_back(distanceFieldFileName(outputs[o]));
+        }
+    }
+    return outputs;
+}
+
+// Cache key of one output. The output name only enters through the part that follows the input stem, so identical
+// inputs under different names share a key; the normal-name match is kept because smart normalization reads it.
+static uint64_t
+outputKey(uint64_t inputHash, uint64_t maskHash, const std::string& infile, const std::string& outfile,
+          const Settings& cfg)
+{
+    const std::string stem    = fs::path(infile).stem().string();
+    const std::string outName = fileNameOnly(outfile);
+    const std::string tail    = outName.compare(0, stem.size(), stem) == 0 ? outName.substr(stem.size()) : outName;
+
+    uint64_t key = combineHash(inputHash, maskHash);
+    key          = combineHash(key, hashSettings(cfg));
+    key          = combineHash(key, hashString(fs::path(infile).extension().string() + '|' + tail));
+    return combineHash(key, hasNormalName(infile, cfg) ? 1u : 0u);
+}
+
+static std::string
+pathKey(const std::string& path)
+{
+    const std::string normal = fs::path(path).lexically_normal().string();
+#ifdef _WIN32
+    return toLower(normal);
+#else
+    return normal;
+#endif
+}
+
+// Outputs sit next to their inputs, so a directory processed before lists last run's outputs among its inputs. Jobs
+// reading a file this batch writes are dropped: the file is regenerated from its own input instead.
+static void
+dropOwnOutputs(std::vector<BatchJob>* jobs)
+{
+    std::unordered_map<std::string, size_t> writers;
+    for (size_t i = 0; i < jobs->size(); ++i) {
+        for (const std::string& output : jobOutputs((*jobs)[i])) {
+            writers.emplace(pathKey(output), i);
+        }
+    }
+
+    // A job writing over its own input is left to markCollisions.
+    std::vector<char> dropped(jobs->size(), 0);
+    for (size_t i = 0; i < jobs->size(); ++i) {
+        auto writer = writers.find(pathKey((*jobs)[i].infile));
+        if (writer != writers.end() && writer->second != i) {
+            spdlog::info("Skipping {}, it is an output of {}", (*jobs)[i].infile, (*jobs)[writer->second].infile);
+            dropped[i] = 1;
+        }
+    }
+
+    std::vector<BatchJob> kept;
+    kept.reserve(jobs->size());
+    for (size_t i = 0; i < jobs->size(); ++i) {
+        if (!dropped[i]) {
+            kept.push_back(std::move((*jobs)[i]));
+        }
+    }
+    jobs->swap(kept);
+}
+
+// Marks jobs whose outputs would overwrite an input, or an output of an earlier job, as colliding.
+static void
+markCollisions(std::vector<BatchJob>* jobs)
+{
+    std::unordered_set<std::string> inputs;
+    for (const BatchJob& job : *jobs) {
+        inputs.insert(pathKey(job.infile));
+    }
+
+    std::unordered_map<std::string, size_t> owners;
+    for (size_t i = 0; i < jobs->size(); ++i) {
+        BatchJob& job = (*jobs)[i];
+        for (const std::string& output : jobOutputs(job)) {
+            const std::string key = pathKey(output);
+            if (inputs.count(key) != 0) {
+                spdlog::error("Output {} of {} would overwrite an input", output, job.infile);
+                job.collides = true;
+                continue;
+            }
+            auto [owner, inserted] = owners.emplace(key, i);
+            if (!inserted) {
+                spdlog::error("{} and {} both write {}", (*jobs)[owner->second].infile, job.infile, output);
+                job.collides = true;
+            }
+        }
+    }
+}
+
+// Names the outputs of every input and, in incremental mode, keys them on the input bytes, the mask bytes and the
+// effective settings. Jobs whose outputs all match the manifest are marked up to date; a job with the same keys as
+// an earlier one is marked as its duplicate and gets that job's outputs copied instead of being processed again.
+static std::vector<BatchJob>
+planBatch(const std::vector<std::string>& processFiles, const std::string& mask_file, ThreadPool* pool,
+          BatchCache* cache)
+{
+    std::vector<BatchJob> jobs(processFiles.size());
+    parallelEach(pool, jobs.size(), [&](size_t i) {
+        BatchJob& job = jobs[i];
+        job.infile    = processFiles[i];
+        job.outfile   = getOutName(job.infile, &settings);
+        if (!settings.outputs.empty()
+            && solidify_single_output(job.infile, job.outfile, !settings.useAlpha && !mask_file.empty())) {
+            return;
+        }
+        job.targets.reserve(settings.outputs.size());
+        for (Settings& target : settings.outputs) {
+            job.targets.push_back({ getOutName(job.infile, &target), target });
+        }
+    });
+    dropOwnOutputs(&jobs);
+    markCollisions(&jobs);
+
+    if (!settings.incremental) {
+        return jobs;
+    }
+
+    bool maskOk             = true;
+    const uint64_t maskHash = mask_file.empty() ? 0 : hashFileContents(mask_file, &maskOk);
+    if (!maskOk) {
+        spdlog::warn("Could not hash mask {}, incremental cache disabled", mask_file);
+        return jobs;
+    }
+
+    parallelEach(pool, jobs.size(), [&](size_t i) {
+        BatchJob& job            = jobs[i];
+        bool inputOk             = true;
+        const uint64_t inputHash = job.collides ? 0 : hashFileContents(job.infile, &inputOk);
+        if (job.collides || !inputOk) {
+            return;
+        }
+
+        if (job.targets.empty()) {
+            job.keys.push_back(outputKey(inputHash, maskHash, job.infile, job.outfile, settings));
+        }
+        for (const SolidifyTarget& target : job.targets) {
+            job.keys.push_back(outputKey(inputHash, maskHash, job.infile, target.outputFileName, target.settings));
+        }
+
+        // Distance fields follow the outputs in jobOutputs and depend on the fill settings alone.
+        const std::vector<std::string> outputs = jobOutputs(job);
+        for (size_t o = job.keys.size(); o < outputs.size(); ++o) {
+            job.keys.push_back(outputKey(inputHash, maskHash, job.infile, outputs[o], settings));
+        }
+        job.upToDate                           = true;
+        for (size_t o = 0; o < outputs.size(); ++o) {
+            job.upToDate = job.upToDate && cache->isCurrent(outputs[o], job.keys[o]);
+        }
+    });
+
+    std::map<std::vector<uint64_t>, size_t> firstJob;
+    size_t upToDate = 0, duplicates = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        BatchJob& job = jobs[i];
+        if (job.keys.empty()) {
+            continue;
+        }
+        if (job.upToDate) {
+            ++upToDate;
+            continue;
+        }
+
+        auto [found, inserted] = firstJob.emplace(job.keys, i);
+        if (!inserted) {
+            job.duplicateOf = found->second;
+            ++duplicates;
+        }
+    }
+
+    spdlog::info("Incremental: {} unchanged, {} duplicate, {} to process.", upToDate, duplicates,
+                 jobs.size() - upToDate - duplicates);
+    return jobs;
+}
+
+// Copies the outputs of the job that processed the same content to the outputs of duplicate.
+static bool
+copyDuplicateOutputs(const BatchJob& source, const BatchJob& duplicate, BatchCache* cache)
+{
+    const std::vector<std::string> from = jobOutputs(source);
+    const std::vector<std::string> to   = jobOutputs(duplicate);
+    for (size_t o = 0; o < to.size(); ++o) {
+        std::error_code ec;
+        // Fill paths without a distance field, such as multi-page inputs, leave those names unwritten.
+        if (writesDistanceFields() && o >= to.size() / 2 && !fs::exists(from[o], ec)) {
+            continue;
+        }
+        fs::copy_file(from[o], to[o], fs::copy_options::overwrite_existing, ec);
+        if (ec) {
+            spdlog::error("Could not copy {} to {}: {}", from[o], to[o], ec.message());
+            return false;
+        }
+        spdlog::info("Copied {} to {}, same content as {}", fileNameOnly(from[o]), fileNameOnly(to[o]),
+                     fileNameOnly(source.infile));
+        cache->record(to[o], duplicate.keys[o]);
+    }
+    return true;
+}
+
 bool
 doProcessing(const std::vector<std::string>& filePaths, SolidifyProgressCallback progressCallback)
 {
     std::vector<std::string> fileNames;
     VTimer f_timer;
 
-    collectInputFiles(filePaths, &fileNames);
+    const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t threadCount           = settings.numThreads > 0 ? settings.numThreads : hardwareThreads;
+    const size_t queueLimit            = settings.queueLimit > 0 ? settings.queueLimit : threadCount;
+
+    // The pool plans the batch first (directory walk, header probes, output names, hashes), then runs the jobs.
+    ThreadPool pool(threadCount, queueLimit);
+    collectInputFiles(filePaths, &pool, &fileNames);
+    fileNames = filterInputFiles(fileNames, &pool);
 
     if (fileNames.empty()) {
         if (progressCallback) {
@@ -194,8 +553,13 @@ doProcessing(const std::vector<std::string>& filePaths, SolidifyProgressCallback
     MaskBuffers maskBuffers;
     if (!mask_file.empty()) {
         spdlog::info("Mask file: {} will be used.", mask_file);
-        maskBuffers = mask_load(mask_file, progressCallback);
-        if (!maskBuffers.alpha.initialized() || !maskBuffers.rgbAlpha.initialized()) {
+        // Every output that writes alpha back takes the mask before gamma.
+        bool keepOriginal = settings.alphaMode != 0;
+        for (const Settings& target : settings.outputs) {
+            keepOriginal = keepOriginal || target.alphaMode != 0;
+        }
+        maskBuffers = mask_load(mask_file, keepOriginal, progressCallback);
+        if (!maskBuffers.alpha.initialized()) {
             spdlog::error("Mask load failed: {}", mask_file);
             return false;
         }
@@ -218,15 +582,14 @@ doProcessing(const std::vector<std::string>& filePaths, SolidifyProgressCallback
         return false;
     }
 
-    const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
-    const size_t threadCount           = settings.numThreads > 0 ? settings.numThreads : hardwareThreads;
-    const size_t queueLimit            = settings.queueLimit > 0 ? settings.queueLimit : threadCount;
+    BatchCache cache;
+    const std::vector<BatchJob> jobs = planBatch(processFiles, mask_file, &pool, &cache);
 
-    ThreadPool pool(threadCount, queueLimit);
     std::vector<std::future<bool>> results;
-    results.reserve(processFiles.size());
+    results.reserve(jobs.size());
+    std::vector<char> jobOk(jobs.size(), 0);
 
-    std::vector<std::atomic<float>> fileProgress(processFiles.size());
+    std::vector<std::atomic<float>> fileProgress(jobs.size());
     for (std::atomic<float>& value : fileProgress) {
         value.store(0.0f);
     }
@@ -248,15 +611,33 @@ doProcessing(const std::vector<std::string>& filePaths, SolidifyProgressCallback
         progressCallback(total, std::move(status));
     };
 
-    spdlog::info("Processing {} files with {} threads and queue limit {}.", processFiles.size(), threadCount,
-                 queueLimit);
+    // Colliding, unchanged and duplicate jobs never reach the pool.
+    size_t skipped = 0;
+    for (const BatchJob& job : jobs) {
+        skipped += job.collides || job.upToDate || job.duplicateOf != SIZE_MAX ? 1 : 0;
+    }
+    spdlog::info("Processing {} files, skipping {}, with {} threads and queue limit {}.", jobs.size() - skipped,
+                 skipped, threadCount, queueLimit);
 
-    for (size_t i = 0; i < processFiles.size(); ++i) {
-        const std::string infile  = processFiles[i];
-        const std::string outfile = getOutName(infile, &settings);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const BatchJob& job = jobs[i];
+        if (job.collides) {
+            updateProgress(i, 1.0f, "Failed: " + fileNameOnly(job.infile));
+            continue;
+        }
+        if (job.upToDate) {
+            spdlog::info("Unchanged, skipping {}", job.infile);
+            updateProgress(i, 1.0f, "Unchanged: " + fileNameOnly(job.infile));
+            continue;
+        }
+        if (job.duplicateOf != SIZE_MAX) {
+            continue;
+        }
 
-        results.emplace_back(pool.enqueue([&, i, infile, outfile]() mutable {
-            const std::string debugText = "Source: " + fileNameOnly(infile) + "\nTarget: " + fileNameOnly(outfile)
+        results.emplace_back(pool.enqueue([&, i]() mutable {
+            const BatchJob& job         = jobs[i];
+            const std::string debugText = "Source: " + fileNameOnly(job.infile)
+                                          + "\nTarget: " + fileNameOnly(job.outfile)
                                           + "\nMask:   " + fileNameOnly(mask_file);
             updateProgress(i, 0.0f, debugText);
 
@@ -265,8 +646,18 @@ doProcessing(const std::vector<std::string>& filePaths, SolidifyProgressCallback
                 updateProgress(i, p, std::move(status));
             };
 
-            const bool ok = solidify_main(infile, outfile, maskBuffers, fileCallback);
-            updateProgress(i, 1.0f, ok ? ("Done: " + fileNameOnly(outfile)) : ("Failed: " + fileNameOnly(infile)));
+            const bool ok = job.targets.empty()
+                                ? solidify_main(job.infile, job.outfile, maskBuffers, fileCallback)
+                                : solidify_outputs(job.infile, job.targets, maskBuffers, fileCallback);
+            if (ok && !job.keys.empty()) {
+                const std::vector<std::string> outputs = jobOutputs(job);
+                for (size_t o = 0; o < outputs.size(); ++o) {
+                    cache.record(outputs[o], job.keys[o]);
+                }
+            }
+            jobOk[i] = ok ? 1 : 0;
+            updateProgress(i, 1.0f, ok ? ("Done: " + fileNameOnly(job.targets.empty() ? job.outfile : job.infile))
+                                       : ("Failed: " + fileNameOnly(job.infile)));
             return ok;
         }));
     }
@@ -283,6 +674,22 @@ doProcessing(const std::vector<std::string>& filePaths, SolidifyProgressCallback
         }
     }
 
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const BatchJob& job = jobs[i];
+        allOk               = allOk && !job.collides;
+        if (job.duplicateOf == SIZE_MAX) {
+            continue;
+        }
+        if (!jobOk[job.duplicateOf]) {
+            spdlog::error("No output for {}, its duplicate {} failed", job.infile, jobs[job.duplicateOf].infile);
+        }
+        const bool ok = jobOk[job.duplicateOf] && copyDuplicateOutputs(jobs[job.duplicateOf], job, &cache);
+        allOk         = ok && allOk;
+        updateProgress(i, 1.0f,
+                       ok ? ("Copied: " + fileNameOnly(job.infile)) : ("Failed: " + fileNameOnly(job.infile)));
+    }
+    cache.save();
+
     if (progressCallback) {
         progressCallback(allOk ? 1.0f : 0.0f, allOk ? "Everything Done!" : "Finished with errors.");
     }
@@ -20,6 +20,9 @@
 
 #include "pushpull.h"
 
+#include "imagememory.h"
+
+#include <bit>
 #include <cmath>
 #include <cstdint>
 
@@ -47,8 +50,12 @@ struct PushPullPullView {
     int dstWidth                            = 0;
     int dstHeight                           = 0;
     int channels                            = 0;
+    int xBegin                              = 0;
+    int xEnd                                = 0;
     int yBegin                              = 0;
     int yEnd                                = 0;
+    int srcYOffset                          = 0;  // Source row held at src
+    int dstYOffset                          = 0;  // Destination row held at dst
 };
 
 struct PushPullPullTiledView {
@@ -111,6 +118,7 @@ struct PushPullPullHalfTiledView {
     int tileYEnd     = 0;
 };
 
+// fine is null for a level without pixels of its own, which then takes the upsampled coarse level alone.
 struct PushPullPushView {
     const float* fine                       = nullptr;
     const float* coarse                     = nullptr;
@@ -126,6 +134,8 @@ struct PushPullPushView {
     int xEnd                                = 0;
     int yBegin                              = 0;
     int yEnd                                = 0;
+    int rowOffset                           = 0;  // Row held at fine and dst
+    int coarseYOffset                       = 0;  // Coarse row held at coarse
 };
 
 struct PushPullNormalizeView {
@@ -137,6 +147,7 @@ struct PushPullNormalizeView {
     int yEnd         = 0;
 };
 
+// fine is null as for PushPullPushView.
 struct PushPullFinalView {
     const float* fine                       = nullptr;
     const float* coarse                     = nullptr;
@@ -152,6 +163,8 @@ struct PushPullFinalView {
     int xEnd                                = 0;
     int yBegin                              = 0;
     int yEnd                                = 0;
+    int rowOffset                           = 0;
+    int coarseYOffset                       = 0;  // Coarse row held at coarse
 };
 
 struct PushPullNormalizeU16View {
@@ -266,6 +279,75 @@ struct PushPullFinalFromHalfView {
     int yEnd                                = 0;
 };
 
+enum PushPullNormalStorage {
+    PushPullNormalStorage_F32 = 0,
+    PushPullNormalStorage_U16,
+    PushPullNormalStorage_F16,
+};
+
+// coarse is null when fine is the coarsest level. dst holds four channels per pixel in storage's type.
+struct PushPullFinalNormalView {
+    const float* fine                       = nullptr;
+    const float* coarse                     = nullptr;
+    void* dst                               = nullptr;
+    const PushPullBilinearWeights* xWeights = nullptr;
+    const PushPullBilinearWeights* yWeights = nullptr;
+    int fineWidth                           = 0;
+    int fineHeight                          = 0;
+    int coarseWidth                         = 0;
+    int coarseHeight                        = 0;
+    int xBegin                              = 0;
+    int xEnd                                = 0;
+    int yBegin                              = 0;
+    int yEnd                                = 0;
+    int storage                             = PushPullNormalStorage_F32;
+    float outCenter                         = 0.5f;
+    float scale                             = 0.5f;
+};
+
+// One red-black Gauss-Seidel half sweep of the membrane solve over rows [yBegin, yEnd): every free pixel whose x + y
+// has the parity's oddness becomes rhs plus the sum of its in-image four-neighbours, over their count. rhs is null
+// for a zero right-hand side. The kernel visits the pixels of one color one at a time and vectorizes across the
+// channels of each pixel only.
+struct PushPullSmoothView {
+    float* u             = nullptr;
+    const float* rhs     = nullptr;
+    const uint8_t* fixed = nullptr;
+    int width            = 0;
+    int height           = 0;
+    int channels         = 0;
+    int parity           = 0;
+    int yBegin           = 0;
+    int yEnd             = 0;
+};
+
+// Membrane residual rhs + neighbour sum - count * u of rows [yBegin, yEnd), zero at fixed pixels. dst row 0 is yBegin.
+struct PushPullResidualView {
+    const float* u       = nullptr;
+    const float* rhs     = nullptr;
+    const uint8_t* fixed = nullptr;
+    float* dst           = nullptr;
+    int width            = 0;
+    int height           = 0;
+    int channels         = 0;
+    int yBegin           = 0;
+    int yEnd             = 0;
+};
+
+// One jump-flood pass over rows [yBegin, yEnd): every pixel keeps the closest of its own seed and the seeds of the
+// eight pixels step away in src. Seed planes hold the seed's pixel coordinates, far off the image for no seed.
+struct PushPullJumpFloodView {
+    const float* srcX = nullptr;
+    const float* srcY = nullptr;
+    float* dstX       = nullptr;
+    float* dstY       = nullptr;
+    int width         = 0;
+    int height        = 0;
+    int step          = 0;
+    int yBegin        = 0;
+    int yEnd          = 0;
+};
+
 }  // namespace solidify_pushpull_hwy
 
 #undef HWY_TARGET_INCLUDE
@@ -293,6 +375,10 @@ HWY_EXPORT(PushPullNormalizeHalfKernel);
 HWY_EXPORT(PushPullFinalHalfKernel);
 HWY_EXPORT(PushPullNormalizeFromHalfKernel);
 HWY_EXPORT(PushPullFinalFromHalfKernel);
+HWY_EXPORT(PushPullFinalNormalKernel);
+HWY_EXPORT(PushPullSmoothKernel);
+HWY_EXPORT(PushPullResidualKernel);
+HWY_EXPORT(PushPullJumpFloodKernel);
 
 static bool
 runPullHwy(const PushPullPullView* view)
@@ -390,16 +476,60 @@ runFinalFromHalfHwy(const PushPullFinalFromHalfView* view)
     return HWY_DYNAMIC_DISPATCH(PushPullFinalFromHalfKernel)(view);
 }
 
+static bool
+runFinalNormalHwy(const PushPullFinalNormalView* view)
+{
+    return HWY_DYNAMIC_DISPATCH(PushPullFinalNormalKernel)(view);
+}
+
+static bool
+runSmoothHwy(const PushPullSmoothView* view)
+{
+    return HWY_DYNAMIC_DISPATCH(PushPullSmoothKernel)(view);
+}
+
+static bool
+runResidualHwy(const PushPullResidualView* view)
+{
+    return HWY_DYNAMIC_DISPATCH(PushPullResidualKernel)(view);
+}
+
+static bool
+runJumpFloodHwy(const PushPullJumpFloodView* view)
+{
+    return HWY_DYNAMIC_DISPATCH(PushPullJumpFloodKernel)(view);
+}
+
 }  // namespace solidify_pushpull_hwy
 #endif
 
 namespace {
 
+static constexpr float kPushPullAlphaEpsilon = 1.0e-6f;
+
 struct PushPullLevel {
     int width    = 0;
     int height   = 0;
     int channels = 0;
-    std::vector<float> pixels;
+    ImageVector<float> pixels;
+};
+
+// Side of the square tiles a sparse top level is stored in. Even, so each tile pulls to a whole half-size tile.
+static constexpr int kPushPullSparseTile = 64;
+// A top level is stored sparse when at most this share of its tiles hold data.
+static constexpr float kPushPullSparseMaxOccupancy = 0.5f;
+
+// Top level of a mostly empty region. Tiles whose pixels are all zero are implicit; slots holds, per tile in raster
+// order, the index of the tile's pixels among the stored tiles, or -1. Stored tiles are full kPushPullSparseTile
+// squares, of which edge tiles use only the part inside width x height.
+struct PushPullSparseLevel {
+    int width    = 0;
+    int height   = 0;
+    int channels = 0;
+    int tileCols = 0;
+    int tileRows = 0;
+    std::vector<int> slots;
+    ImageVector<float> pixels;
 };
 
 static float
@@ -507,30 +637,411 @@ validatePushPullSource(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src)
     return true;
 }
 
+// Allocates a level the caller writes in full without zeroing it, so its pages are first touched by the kernel
+// threads that write them.
 static void
 resetLevel(PushPullLevel* level, const int width, const int height, const int channels)
 {
     level->width    = width;
     level->height   = height;
     level->channels = channels;
-    level->pixels.assign(static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(channels),
-                         0.0f);
+    ImageVector<float>(static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(channels))
+        .swap(level->pixels);
+}
+
+// Allocates a zeroed level for kernels that may leave pixels unwritten, zeroing it on nthreads threads.
+static void
+resetLevelZeroed(PushPullLevel* level, const int width, const int height, const int channels, const int nthreads)
+{
+    resetLevel(level, width, height, channels);
+    parallelZero(level->pixels.data(), level->pixels.size() * sizeof(float), nthreads);
+}
+
+static OIIO::ROI
+fillRegion(const OIIO::ImageSpec& spec, const PushPullOptions& options)
+{
+    const OIIO::ROI bounds = OIIO::roi_union(spec.roi(), spec.roi_full());
+    OIIO::ROI region       = options.roi.defined() ? options.roi : spec.roi();
+    if (options.margin < 0) {
+        region = bounds;
+    } else {
+        region.xbegin -= options.margin;
+        region.xend += options.margin;
+        region.ybegin -= options.margin;
+        region.yend += options.margin;
+    }
+    region         = OIIO::roi_intersection(region, bounds);
+    region.zbegin  = spec.z;
+    region.zend    = spec.z + spec.depth;
+    region.chbegin = 0;
+    region.chend   = spec.nchannels;
+    return region;
 }
 
 static bool
-readTopLevel(PushPullLevel* level, OIIO::ImageBuf& dst, const OIIO::ImageBuf& src)
+readTopLevel(PushPullLevel* level, OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const OIIO::ROI& region)
 {
-    const OIIO::ImageSpec& spec = src.spec();
-    resetLevel(level, spec.width, spec.height, spec.nchannels);
-    const OIIO::ROI roi(src.xbegin(), src.xend(), src.ybegin(), src.yend(), src.zbegin(), src.zend(), 0,
-                        spec.nchannels);
-    if (!src.get_pixels(roi, OIIO::TypeDesc::FLOAT, level->pixels.data())) {
+    resetLevel(level, region.width(), region.height(), src.nchannels());
+    if (!src.get_pixels(region, OIIO::TypeDesc::FLOAT, level->pixels.data())) {
+        dst.errorfmt("push-pull could not read source pixels as float");
+        return false;
+    }
+    return true;
+}
+
+// True when every channel of tile (tx, ty) of region is zero. Rows are read one at a time and the scan stops at the
+// first non-zero value, so a covered tile usually costs a single row read. Unreadable tiles count as holding data.
+static bool
+sparseTileEmpty(const OIIO::ImageBuf& src, const OIIO::ROI& region, const int tx, const int ty,
+                std::vector<float>* row)
+{
+    const int x0 = region.xbegin + tx * kPushPullSparseTile;
+    const int x1 = std::min(region.xend, x0 + kPushPullSparseTile);
+    const int y0 = region.ybegin + ty * kPushPullSparseTile;
+    const int y1 = std::min(region.yend, y0 + kPushPullSparseTile);
+    row->resize(static_cast<size_t>(x1 - x0) * static_cast<size_t>(region.nchannels()));
+    for (int y = y0; y < y1; ++y) {
+        OIIO::ROI rowRoi(x0, x1, y, y + 1, region.zbegin, region.zend, region.chbegin, region.chend);
+        if (!src.get_pixels(rowRoi, OIIO::TypeDesc::FLOAT, row->data())) {
+            return false;
+        }
+        for (const float value : *row) {
+            if (value != 0.0f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Finds the tiles of region that hold data. False, leaving level empty, when the fill does not qualify for a sparse
+// top level or more than kPushPullSparseMaxOccupancy of the tiles hold data; the scan stops as soon as that is known.
+static bool
+planSparseTopLevel(PushPullSparseLevel* level, const OIIO::ImageBuf& src, const OIIO::ROI& region,
+                   const PushPullOptions& options)
+{
+    *level             = {};
+    const int width    = region.width();
+    const int height   = region.height();
+    const int channels = region.nchannels();
+    // The sparse pull is the exact 2x one, the sparse final pass writes interleaved alpha results and the membrane
+    // solve reads the whole top level.
+    if (!options.sparseTopLevel || options.engine != FillEngine::PushPull || options.normalMap || options.level > 0
+        || width % 2 != 0 || height % 2 != 0 || (channels != 2 && channels != 4)) {
+        return false;
+    }
+    const int tileCols = (width + kPushPullSparseTile - 1) / kPushPullSparseTile;
+    const int tileRows = (height + kPushPullSparseTile - 1) / kPushPullSparseTile;
+    if (tileCols < 2 || tileRows < 2) {
+        return false;
+    }
+
+    std::vector<int> slots(static_cast<size_t>(tileCols) * static_cast<size_t>(tileRows), -1);
+    const size_t maxOccupied = static_cast<size_t>(kPushPullSparseMaxOccupancy * static_cast<float>(slots.size()));
+
+    std::atomic<size_t> occupied = 0;
+    OIIO::ROI tileRoi(0, tileCols, 0, tileRows, 0, 1, 0, 1);
+    OIIO::ImageBufAlgo::parallel_image(tileRoi, options.nthreads, [&](OIIO::ROI chunk) {
+        std::vector<float> row;
+        for (int ty = chunk.ybegin; ty < chunk.yend; ++ty) {
+            for (int tx = chunk.xbegin; tx < chunk.xend; ++tx) {
+                if (occupied.load(std::memory_order_relaxed) > maxOccupied) {
+                    return;
+                }
+                if (!sparseTileEmpty(src, region, tx, ty, &row)) {
+                    slots[static_cast<size_t>(ty) * tileCols + tx] = 0;
+                    ++occupied;
+                }
+            }
+        }
+    });
+    if (occupied.load() > maxOccupied) {
+        return false;
+    }
+
+    int next = 0;
+    for (int& slot : slots) {
+        if (slot == 0) {
+            slot = next++;
+        }
+    }
+    level->width    = width;
+    level->height   = height;
+    level->channels = channels;
+    level->tileCols = tileCols;
+    level->tileRows = tileRows;
+    level->slots    = std::move(slots);
+    return true;
+}
+
+// Reads the tiles planSparseTopLevel found holding data into their slots.
+static bool
+readSparseTopLevel(PushPullSparseLevel* level, OIIO::ImageBuf& dst, const OIIO::ImageBuf& src,
+                   const OIIO::ROI& region, const int nthreads)
+{
+    const size_t tileFloats = static_cast<size_t>(kPushPullSparseTile) * kPushPullSparseTile * level->channels;
+    const size_t stored     = static_cast<size_t>(
+        std::count_if(level->slots.begin(), level->slots.end(), [](const int slot) { return slot >= 0; }));
+    ImageVector<float>(stored * tileFloats).swap(level->pixels);
+
+    const OIIO::stride_t xstride = static_cast<OIIO::stride_t>(level->channels) * sizeof(float);
+    const OIIO::stride_t ystride = xstride * kPushPullSparseTile;
+    std::atomic<bool> ok         = true;
+    OIIO::ROI tileRoi(0, level->tileCols, 0, level->tileRows, 0, 1, 0, 1);
+    OIIO::ImageBufAlgo::parallel_image(tileRoi, nthreads, [&](OIIO::ROI chunk) {
+        for (int ty = chunk.ybegin; ty < chunk.yend; ++ty) {
+            for (int tx = chunk.xbegin; tx < chunk.xend; ++tx) {
+                const int slot = level->slots[static_cast<size_t>(ty) * level->tileCols + tx];
+                if (slot < 0) {
+                    continue;
+                }
+                const int x0 = region.xbegin + tx * kPushPullSparseTile;
+                const int y0 = region.ybegin + ty * kPushPullSparseTile;
+                OIIO::ROI pixelRoi(x0, std::min(region.xend, x0 + kPushPullSparseTile), y0,
+                                   std::min(region.yend, y0 + kPushPullSparseTile), region.zbegin, region.zend,
+                                   region.chbegin, region.chend);
+                float* pixels = level->pixels.data() + static_cast<size_t>(slot) * tileFloats;
+                if (!src.get_pixels(pixelRoi, OIIO::TypeDesc::FLOAT, pixels, xstride, ystride)) {
+                    ok = false;
+                    return;
+                }
+            }
+        }
+    });
+    if (!ok.load()) {
         dst.errorfmt("push-pull could not read source pixels as float");
         return false;
     }
     return true;
 }
 
+// Copies rows [ybegin, yend) of a sparse level into rows, width * channels floats per row, with zeros for the
+// implicit tiles.
+static void
+gatherSparseRows(const PushPullSparseLevel& level, const int ybegin, const int yend, float* rows)
+{
+    const size_t rowFloats  = static_cast<size_t>(level.width) * level.channels;
+    const size_t tileFloats = static_cast<size_t>(kPushPullSparseTile) * kPushPullSparseTile * level.channels;
+    for (int y = ybegin; y < yend; ++y) {
+        const int ty = y / kPushPullSparseTile;
+        float* row   = rows + static_cast<size_t>(y - ybegin) * rowFloats;
+        for (int tx = 0; tx < level.tileCols; ++tx) {
+            const int x0      = tx * kPushPullSparseTile;
+            const size_t span = static_cast<size_t>(std::min(level.width - x0, kPushPullSparseTile)) * level.channels;
+            float* out        = row + static_cast<size_t>(x0) * level.channels;
+            const int slot    = level.slots[static_cast<size_t>(ty) * level.tileCols + tx];
+            if (slot < 0) {
+                std::fill_n(out, span, 0.0f);
+                continue;
+            }
+            const float* tile = level.pixels.data() + static_cast<size_t>(slot) * tileFloats;
+            std::copy_n(tile + static_cast<size_t>(y - ty * kPushPullSparseTile) * kPushPullSparseTile * level.channels,
+                        span, out);
+        }
+    }
+}
+
+// Up to 64 coverage bits of row y from column x on, bit i for column x + i. Columns past count and pixels outside
+// bits read as uncovered.
+static uint64_t
+coverageWord(const PushPullCoverageBits& bits, const int x, const int y, const int count)
+{
+    const int begin = std::max(x, bits.x);
+    const int end   = std::min(x + count, bits.x + bits.width);
+    if (y < bits.y || y >= bits.y + bits.height || begin >= end) {
+        return 0;
+    }
+    const uint64_t* row = bits.words.data() + static_cast<size_t>(y - bits.y) * bits.wordsPerRow;
+    const size_t index  = static_cast<size_t>(begin - bits.x) / 64u;
+    const int shift     = (begin - bits.x) % 64;
+    uint64_t word       = row[index] >> shift;
+    if (shift != 0 && index + 1 < bits.wordsPerRow) {
+        word |= row[index + 1] << (64 - shift);
+    }
+    const int bitCount = end - begin;
+    if (bitCount < 64) {
+        word &= (uint64_t(1) << bitCount) - 1u;
+    }
+    return word << (begin - x);
+}
+
+// Sets the coverage channel of rows read from color to the binary coverage in bits, clearing the color of
+// uncovered pixels when premultiply is set. Whole runs of 64 covered pixels only get their coverage set, and
+// premultiplied uncovered runs are cleared with one fill; only mixed runs test their bits one by one.
+static void
+applyCoverageBits(float* rows, const OIIO::ROI& rowRoi, const int channels, const PushPullCoverageBits& bits,
+                  const bool premultiply)
+{
+    const int colorChannels = channels - 1;
+    const int width         = rowRoi.width();
+    for (int y = rowRoi.ybegin; y < rowRoi.yend; ++y) {
+        float* row = rows + static_cast<size_t>(y - rowRoi.ybegin) * static_cast<size_t>(width) * channels;
+        for (int x0 = 0; x0 < width; x0 += 64) {
+            const int count     = std::min(64, width - x0);
+            const uint64_t word = coverageWord(bits, rowRoi.xbegin + x0, y, count);
+            const int covered   = std::popcount(word);
+            float* pixels       = row + static_cast<size_t>(x0) * channels;
+            if (covered == 0 && premultiply) {
+                std::fill_n(pixels, static_cast<size_t>(count) * channels, 0.0f);
+                continue;
+            }
+            if (covered == 0 || covered == count) {
+                const float coverage = covered == 0 ? 0.0f : 1.0f;
+                for (int i = 0; i < count; ++i) {
+                    pixels[static_cast<size_t>(i) * channels + colorChannels] = coverage;
+                }
+                continue;
+            }
+            for (int i = 0; i < count; ++i) {
+                float* pixel         = pixels + static_cast<size_t>(i) * channels;
+                const bool isCovered = ((word >> i) & 1u) != 0;
+                pixel[colorChannels] = isCovered ? 1.0f : 0.0f;
+                if (!isCovered && premultiply) {
+                    for (int c = 0; c < colorChannels; ++c) {
+                        pixel[c] = 0.0f;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Builds the top level from color and a separate one-channel coverage plane, or the binary coverage in bits when
+// set, interleaving coverage as the last channel and premultiplying color by it in the same row-band pass, so no
+// RGBA copy of the source is made.
+static bool
+readTopLevelWithCoverage(PushPullLevel* level, OIIO::ImageBuf& dst, const OIIO::ImageBuf& color,
+                         const OIIO::ImageBuf* coverage, const PushPullCoverageBits* bits, const OIIO::ROI& region,
+                         const bool premultiply, const int nthreads)
+{
+    const int colorChannels = color.nchannels();
+    resetLevel(level, region.width(), region.height(), colorChannels + 1);
+    const OIIO::stride_t xstride = static_cast<OIIO::stride_t>(level->channels) * sizeof(float);
+    const OIIO::stride_t ystride = xstride * level->width;
+
+    std::atomic<bool> ok = true;
+    OIIO::ImageBufAlgo::parallel_image(region, nthreads, [&](OIIO::ROI chunk) {
+        chunk.xbegin = region.xbegin;
+        chunk.xend   = region.xend;
+        float* rows  = level->pixels.data()
+                      + static_cast<size_t>(chunk.ybegin - region.ybegin) * static_cast<size_t>(level->width)
+                            * static_cast<size_t>(level->channels);
+
+        OIIO::ROI colorRoi(chunk.xbegin, chunk.xend, chunk.ybegin, chunk.yend, chunk.zbegin, chunk.zend, 0,
+                           colorChannels);
+        OIIO::ROI coverageRoi(chunk.xbegin, chunk.xend, chunk.ybegin, chunk.yend, chunk.zbegin, chunk.zend, 0, 1);
+        if (!color.get_pixels(colorRoi, OIIO::TypeDesc::FLOAT, rows, xstride, ystride)) {
+            ok = false;
+            return;
+        }
+        if (bits) {
+            applyCoverageBits(rows, colorRoi, level->channels, *bits, premultiply);
+            return;
+        }
+        if (!coverage->get_pixels(coverageRoi, OIIO::TypeDesc::FLOAT, rows + colorChannels, xstride, ystride)) {
+            ok = false;
+            return;
+        }
+        if (!premultiply) {
+            return;
+        }
+
+        const size_t count = static_cast<size_t>(chunk.height()) * static_cast<size_t>(level->width);
+        for (size_t i = 0; i < count; ++i) {
+            float* pixel      = rows + i * static_cast<size_t>(level->channels);
+            const float alpha = pixel[colorChannels];
+            for (int c = 0; c < colorChannels; ++c) {
+                pixel[c] *= alpha;
+            }
+        }
+    });
+    if (!ok.load()) {
+        dst.errorfmt("push-pull could not read source and coverage pixels as float");
+        return false;
+    }
+    return true;
+}
+
+// Octahedral encoding of a vector of any length: its projection onto the unit octahedron, with the lower half folded
+// over the upper one, in [-1, 1]. The zero vector encodes as +Z.
+static void
+octahedralEncode(const float x, const float y, const float z, float* u, float* v)
+{
+    const float l1 = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    if (!(l1 > 0.0f)) {
+        *u = 0.0f;
+        *v = 0.0f;
+        return;
+    }
+    const float px = x / l1;
+    const float py = y / l1;
+    if (z < 0.0f) {
+        *u = (1.0f - std::fabs(py)) * (px >= 0.0f ? 1.0f : -1.0f);
+        *v = (1.0f - std::fabs(px)) * (py >= 0.0f ? 1.0f : -1.0f);
+    } else {
+        *u = px;
+        *v = py;
+    }
+}
+
+// Normal-map top level: reads RGBA, or RGB and a one-channel coverage plane, in row bands and keeps each pixel as
+// its octahedral (u, v) premultiplied by alpha, plus alpha, so the pyramid carries three channels instead of four.
+// RGBA color is taken as premultiplied like the rest of the fill; RGB color is straight when premultiply is set.
+static bool
+readTopLevelNormals(PushPullLevel* level, OIIO::ImageBuf& dst, const OIIO::ImageBuf& color,
+                    const OIIO::ImageBuf* coverage, const OIIO::ROI& region, const bool premultiply,
+                    const float inCenter, const int nthreads)
+{
+    resetLevel(level, region.width(), region.height(), 3);
+    const OIIO::stride_t xstride = static_cast<OIIO::stride_t>(4 * sizeof(float));
+    const OIIO::stride_t ystride = xstride * level->width;
+    const bool straight          = coverage != nullptr && premultiply;
+
+    std::atomic<bool> ok = true;
+    OIIO::ImageBufAlgo::parallel_image(region, nthreads, [&](OIIO::ROI chunk) {
+        chunk.xbegin       = region.xbegin;
+        chunk.xend         = region.xend;
+        const size_t count = static_cast<size_t>(chunk.height()) * static_cast<size_t>(level->width);
+        std::vector<float> band(count * 4u);
+
+        OIIO::ROI colorRoi(chunk.xbegin, chunk.xend, chunk.ybegin, chunk.yend, chunk.zbegin, chunk.zend, 0,
+                           coverage != nullptr ? 3 : 4);
+        OIIO::ROI coverageRoi(chunk.xbegin, chunk.xend, chunk.ybegin, chunk.yend, chunk.zbegin, chunk.zend, 0, 1);
+        if (!color.get_pixels(colorRoi, OIIO::TypeDesc::FLOAT, band.data(), xstride, ystride)
+            || (coverage != nullptr
+                && !coverage->get_pixels(coverageRoi, OIIO::TypeDesc::FLOAT, band.data() + 3, xstride, ystride))) {
+            ok = false;
+            return;
+        }
+
+        float* rows = level->pixels.data()
+                      + static_cast<size_t>(chunk.ybegin - region.ybegin) * static_cast<size_t>(level->width) * 3u;
+        for (size_t i = 0; i < count; ++i) {
+            const float* pixel = band.data() + i * 4u;
+            float* out          = rows + i * 3u;
+            const float alpha   = pixel[3];
+            out[2]              = alpha;
+            if (!(alpha > kPushPullAlphaEpsilon)) {
+                out[0] = 0.0f;
+                out[1] = 0.0f;
+                continue;
+            }
+            const float invAlpha = straight ? 1.0f : 1.0f / alpha;
+            float u              = 0.0f;
+            float v              = 0.0f;
+            octahedralEncode(pixel[0] * invAlpha - inCenter, pixel[1] * invAlpha - inCenter,
+                             pixel[2] * invAlpha - inCenter, &u, &v);
+            out[0] = u * alpha;
+            out[1] = v * alpha;
+        }
+    });
+    if (!ok.load()) {
+        dst.errorfmt("push-pull could not read normal map pixels as float");
+        return false;
+    }
+    return true;
+}
+
 static bool
 runPullLevel(PushPullLevel* dst, const PushPullLevel& src, const int nthreads)
 {
@@ -551,6 +1062,8 @@ runPullLevel(PushPullLevel* dst, const PushPullLevel& src, const int nthreads)
             view.dstWidth  = dst->width;
             view.dstHeight = dst->height;
             view.channels  = src.channels;
+            view.xBegin    = chunk.xbegin;
+            view.xEnd      = chunk.xend;
             view.yBegin    = chunk.ybegin;
             view.yEnd      = chunk.yend;
             if (!solidify_pushpull_hwy::runPullExact2xHwy(&view)) {
@@ -582,6 +1095,8 @@ runPullLevel(PushPullLevel* dst, const PushPullLevel& src, const int nthreads)
         view.dstWidth  = dst->width;
         view.dstHeight = dst->height;
         view.channels  = src.channels;
+        view.xBegin    = chunk.xbegin;
+        view.xEnd      = chunk.xend;
         view.yBegin    = chunk.ybegin;
         view.yEnd      = chunk.yend;
         if (!solidify_pushpull_hwy::runPullHwy(&view)) {
@@ -591,9 +1106,79 @@ runPullLevel(PushPullLevel* dst, const PushPullLevel& src, const int nthreads)
     return ok.load();
 }
 
+// Pulls the first level of a sparse top level, one row of half-size tiles at a time. Tiles whose filter footprint
+// reaches no stored tile are zero and skip the kernel; the others are pulled from the source rows around them,
+// gathered once per tile row.
+static bool
+runSparsePullFirstLevel(PushPullLevel* dst, const PushPullSparseLevel& src, const int nthreads)
+{
+    const int dstWidth  = src.width / 2;
+    const int dstHeight = src.height / 2;
+    const int dstTile   = kPushPullSparseTile / 2;
+    resetLevel(dst, dstWidth, dstHeight, src.channels);
+
+    const size_t rowFloats = static_cast<size_t>(src.width) * src.channels;
+    std::atomic<bool> ok   = true;
+    OIIO::ROI tileRoi(0, 1, 0, src.tileRows, 0, 1, 0, 1);
+    OIIO::ImageBufAlgo::parallel_image(tileRoi, nthreads, [&](OIIO::ROI chunk) {
+        std::vector<float> band;
+        for (int ty = chunk.ybegin; ty < chunk.yend; ++ty) {
+            const int y0       = ty * dstTile;
+            const int y1       = std::min(dstHeight, y0 + dstTile);
+            const int srcBegin = std::max(0, y0 * 2 - 1);
+            const int srcEnd   = std::min(src.height, y1 * 2 + 1);
+            bool gathered      = false;
+            for (int tx = 0; tx < src.tileCols; ++tx) {
+                const int x0 = tx * dstTile;
+                const int x1 = std::min(dstWidth, x0 + dstTile);
+
+                bool stored = false;
+                for (int sy = srcBegin / kPushPullSparseTile; sy <= (srcEnd - 1) / kPushPullSparseTile; ++sy) {
+                    const int sxBegin = std::max(0, x0 * 2 - 1) / kPushPullSparseTile;
+                    const int sxEnd   = (std::min(src.width, x1 * 2 + 1) - 1) / kPushPullSparseTile;
+                    for (int sx = sxBegin; sx <= sxEnd; ++sx) {
+                        stored = stored || src.slots[static_cast<size_t>(sy) * src.tileCols + sx] >= 0;
+                    }
+                }
+                if (!stored) {
+                    for (int y = y0; y < y1; ++y) {
+                        std::fill_n(dst->pixels.data() + (static_cast<size_t>(y) * dstWidth + x0) * src.channels,
+                                    static_cast<size_t>(x1 - x0) * src.channels, 0.0f);
+                    }
+                    continue;
+                }
+
+                if (!gathered) {
+                    band.resize(static_cast<size_t>(srcEnd - srcBegin) * rowFloats);
+                    gatherSparseRows(src, srcBegin, srcEnd, band.data());
+                    gathered = true;
+                }
+                solidify_pushpull_hwy::PushPullPullView view;
+                view.src        = band.data();
+                view.dst        = dst->pixels.data();
+                view.srcWidth   = src.width;
+                view.srcHeight  = src.height;
+                view.dstWidth   = dstWidth;
+                view.dstHeight  = dstHeight;
+                view.channels   = src.channels;
+                view.xBegin     = x0;
+                view.xEnd       = x1;
+                view.yBegin     = y0;
+                view.yEnd       = y1;
+                view.srcYOffset = srcBegin;
+                if (!solidify_pushpull_hwy::runPullExact2xHwy(&view)) {
+                    ok = false;
+                    return;
+                }
+            }
+        }
+    });
+    return ok.load();
+}
+
 static int
 appendPullLevelsFromDimensions(std::vector<PushPullLevel>* pyramid, const int baseWidth, const int baseHeight,
-                               const int channels)
+                               const int channels, const int nthreads)
 {
     int width      = baseWidth;
     int height     = baseHeight;
@@ -602,7 +1187,7 @@ appendPullLevelsFromDimensions(std::vector<PushPullLevel>* pyramid, const int ba
         width  = std::max(1, width / 2);
         height = std::max(1, height / 2);
         PushPullLevel level;
-        resetLevel(&level, width, height, channels);
+        resetLevelZeroed(&level, width, height, channels, nthreads);
         pyramid->push_back(std::move(level));
         ++levelCount;
     }
@@ -610,17 +1195,17 @@ appendPullLevelsFromDimensions(std::vector<PushPullLevel>* pyramid, const int ba
 }
 
 static int
-appendPullLevels(std::vector<PushPullLevel>* pyramid)
+appendPullLevels(std::vector<PushPullLevel>* pyramid, const int nthreads)
 {
     const PushPullLevel& base = pyramid->back();
-    return appendPullLevelsFromDimensions(pyramid, base.width, base.height, base.channels);
+    return appendPullLevelsFromDimensions(pyramid, base.width, base.height, base.channels, nthreads);
 }
 
 static bool
 runPullGroupTiled(std::vector<PushPullLevel>* pyramid, const int nthreads)
 {
     const size_t baseIndex = pyramid->size() - 1u;
-    const int levelCount   = appendPullLevels(pyramid);
+    const int levelCount   = appendPullLevels(pyramid, nthreads);
     if (levelCount == 0) {
         return true;
     }
@@ -670,7 +1255,7 @@ runPullGroupTiledFromU16(std::vector<PushPullLevel>* pyramid, const uint16_t* ba
                          const int baseHeight, const int channels, const int nthreads)
 {
     const size_t baseIndex = pyramid->size();
-    const int levelCount   = appendPullLevelsFromDimensions(pyramid, baseWidth, baseHeight, channels);
+    const int levelCount   = appendPullLevelsFromDimensions(pyramid, baseWidth, baseHeight, channels, nthreads);
     if (levelCount == 0) {
         return true;
     }
@@ -719,7 +1304,7 @@ runPullGroupTiledFromHalf(std::vector<PushPullLevel>* pyramid, const half* baseP
                           const int baseHeight, const int channels, const int nthreads)
 {
     const size_t baseIndex = pyramid->size();
-    const int levelCount   = appendPullLevelsFromDimensions(pyramid, baseWidth, baseHeight, channels);
+    const int levelCount   = appendPullLevelsFromDimensions(pyramid, baseWidth, baseHeight, channels, nthreads);
     if (levelCount == 0) {
         return true;
     }
@@ -763,6 +1348,7 @@ runPullGroupTiledFromHalf(std::vector<PushPullLevel>* pyramid, const half* baseP
     return true;
 }
 
+// Composites fine over the upsampled coarse level. A fine level without pixels takes the upsampled coarse alone.
 static bool
 runPushLevel(PushPullLevel* dst, const PushPullLevel& fine, const PushPullLevel& coarse, const int nthreads)
 {
@@ -776,7 +1362,7 @@ runPushLevel(PushPullLevel* dst, const PushPullLevel& fine, const PushPullLevel&
     OIIO::ROI roi(0, fine.width, 0, fine.height, 0, 1, 0, fine.channels);
     OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
         solidify_pushpull_hwy::PushPullPushView view;
-        view.fine         = fine.pixels.data();
+        view.fine         = fine.pixels.empty() ? nullptr : fine.pixels.data();
         view.coarse       = coarse.pixels.data();
         view.dst          = dst->pixels.data();
         view.xWeights     = xWeights.data();
@@ -908,9 +1494,9 @@ runNormalizeHalfSourceToBuffer(half* dst, const half* srcPixels, const int width
 }
 
 static bool
-runNormalizeLevel(std::vector<float>* dst, const PushPullLevel& src, const int nthreads)
+runNormalizeLevel(ImageVector<float>* dst, const PushPullLevel& src, const int nthreads)
 {
-    dst->assign(src.pixels.size(), 0.0f);
+    ImageVector<float>(src.pixels.size()).swap(*dst);
     return runNormalizeLevelToBuffer(dst->data(), src, nthreads);
 }
 
@@ -925,7 +1511,7 @@ runFinalLevelToBuffer(float* dst, const PushPullLevel& fine, const PushPullLevel
     OIIO::ROI roi(0, fine.width, 0, fine.height, 0, 1, 0, fine.channels);
     OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
         solidify_pushpull_hwy::PushPullFinalView view;
-        view.fine         = fine.pixels.data();
+        view.fine         = fine.pixels.empty() ? nullptr : fine.pixels.data();
         view.coarse       = coarse.pixels.data();
         view.dst          = dst;
         view.xWeights     = xWeights.data();
@@ -1077,25 +1663,103 @@ runFinalLevelFromHalfToHalfBuffer(half* dst, const half* finePixels, const int f
 }
 
 static bool
-runFinalLevel(std::vector<float>* dst, const PushPullLevel& fine, const PushPullLevel& coarse, const int nthreads)
+runFinalLevel(ImageVector<float>* dst, const PushPullLevel& fine, const PushPullLevel& coarse, const int nthreads)
 {
-    dst->assign(fine.pixels.size(), 0.0f);
+    ImageVector<float>(static_cast<size_t>(fine.width) * static_cast<size_t>(fine.height)
+                       * static_cast<size_t>(fine.channels))
+        .swap(*dst);
     return runFinalLevelToBuffer(dst->data(), fine, coarse, nthreads);
 }
 
+// Final pass of a normal-map fill: composites fine over coarse, or only unpremultiplies fine when coarse is null,
+// and writes four-channel unit normals in storage's type.
 static bool
-resetLocalResult(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src)
+runFinalNormalLevelToBuffer(void* dst, const int storage, const PushPullLevel& fine, const PushPullLevel* coarse,
+                            const PushPullOptions& options, const int nthreads)
 {
-    OIIO::ImageSpec spec = src.spec();
+    std::vector<solidify_pushpull_hwy::PushPullBilinearWeights> xWeights;
+    std::vector<solidify_pushpull_hwy::PushPullBilinearWeights> yWeights;
+    if (coarse != nullptr) {
+        prepareBilinearResizeWeights(&xWeights, &yWeights, fine.width, fine.height, coarse->width, coarse->height);
+    }
+
+    std::atomic<bool> ok = true;
+    OIIO::ROI roi(0, fine.width, 0, fine.height, 0, 1, 0, 4);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        solidify_pushpull_hwy::PushPullFinalNormalView view;
+        view.fine         = fine.pixels.data();
+        view.coarse       = coarse != nullptr ? coarse->pixels.data() : nullptr;
+        view.dst          = dst;
+        view.xWeights     = xWeights.data();
+        view.yWeights     = yWeights.data();
+        view.fineWidth    = fine.width;
+        view.fineHeight   = fine.height;
+        view.coarseWidth  = coarse != nullptr ? coarse->width : 0;
+        view.coarseHeight = coarse != nullptr ? coarse->height : 0;
+        view.xBegin       = chunk.xbegin;
+        view.xEnd         = chunk.xend;
+        view.yBegin       = chunk.ybegin;
+        view.yEnd         = chunk.yend;
+        view.storage      = storage;
+        view.outCenter    = options.normalOutCenter;
+        view.scale        = options.normalScale;
+        if (!solidify_pushpull_hwy::runFinalNormalHwy(&view)) {
+            ok = false;
+        }
+    });
+    return ok.load();
+}
+
+static void
+setDataWindow(OIIO::ImageSpec* spec, const OIIO::ROI& region)
+{
+    spec->x      = region.xbegin;
+    spec->y      = region.ybegin;
+    spec->width  = region.width();
+    spec->height = region.height();
+}
+
+// Spec of a result taken from pyramid level levelIndex of region. Below the top level the data window origin and the
+// display window shrink by the same power of two as the level, and the data window takes the level size.
+static OIIO::ImageSpec
+resultSpec(const OIIO::ImageSpec& srcSpec, const OIIO::ROI& region, const PushPullLevel& level, const int levelIndex)
+{
+    OIIO::ImageSpec spec = srcSpec;
     spec.channelformats.clear();
-    dst.reset(spec);
-    if (dst.localpixels() == nullptr) {
+    setDataWindow(&spec, region);
+    if (levelIndex > 0) {
+        spec.x           = spec.x >> levelIndex;
+        spec.y           = spec.y >> levelIndex;
+        spec.width       = level.width;
+        spec.height      = level.height;
+        spec.full_x      = spec.full_x >> levelIndex;
+        spec.full_y      = spec.full_y >> levelIndex;
+        spec.full_width  = std::max(1, spec.full_width >> levelIndex);
+        spec.full_height = std::max(1, spec.full_height >> levelIndex);
+    }
+    return spec;
+}
+
+// Every result pixel is written by the final pass, so the result is not zeroed first.
+static bool
+resetLocalResult(OIIO::ImageBuf& dst, const OIIO::ImageSpec& spec)
+{
+    if (!resetUninitialized(dst, spec)) {
         dst.errorfmt("push-pull could not allocate result pixels");
         return false;
     }
     return true;
 }
 
+static bool
+resetLocalResult(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const OIIO::ROI& region)
+{
+    OIIO::ImageSpec spec = src.spec();
+    spec.channelformats.clear();
+    setDataWindow(&spec, region);
+    return resetLocalResult(dst, spec);
+}
+
 static bool
 applyPushPullFillLocalU16(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const int nthreads)
 {
@@ -1131,7 +1795,7 @@ applyPushPullFillLocalU16(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const
         pyramid[static_cast<size_t>(i)].pixels.swap(filled.pixels);
     }
 
-    if (!resetLocalResult(dst, src)) {
+    if (!resetLocalResult(dst, src, src.roi())) {
         return false;
     }
     uint16_t* dstPixels = static_cast<uint16_t*>(dst.localpixels());
@@ -1184,7 +1848,7 @@ applyPushPullFillLocalHalf(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const
         pyramid[static_cast<size_t>(i)].pixels.swap(filled.pixels);
     }
 
-    if (!resetLocalResult(dst, src)) {
+    if (!resetLocalResult(dst, src, src.roi())) {
         return false;
     }
     half* dstPixels = static_cast<half*>(dst.localpixels());
@@ -1202,52 +1866,1079 @@ applyPushPullFillLocalHalf(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const
     return true;
 }
 
+// Allocates the result, unless it is written in place over the source pixels dst already holds.
 static bool
-writeResult(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const std::vector<float>& pixels)
+prepareResult(OIIO::ImageBuf& dst, const OIIO::ImageSpec& spec, const bool inPlace)
 {
-    OIIO::ImageSpec spec = src.spec();
-    spec.channelformats.clear();
-    dst.reset(spec);
+    return inPlace || resetLocalResult(dst, spec);
+}
+
+// The result spec matches the source when it is taken from the top level of the source data window, and the source
+// owns its pixels in one format, so the final pass can write over them.
+static bool
+canFillInPlace(const OIIO::ImageBuf& src, const OIIO::ROI& region, const PushPullOptions& options)
+{
+    const OIIO::ROI roi = src.roi();
+    return options.level <= 0 && src.storage() == OIIO::ImageBuf::LOCALBUFFER && src.localpixels() != nullptr
+           && src.spec().channelformats.empty() && region.xbegin == roi.xbegin && region.xend == roi.xend
+           && region.ybegin == roi.ybegin && region.yend == roi.yend;
+}
+
+static bool
+writeResult(OIIO::ImageBuf& dst, const OIIO::ImageSpec& spec, const ImageVector<float>& pixels, const bool inPlace)
+{
+    if (!inPlace && !resetUninitialized(dst, spec)) {
+        return false;
+    }
 
-    const OIIO::ROI roi(src.xbegin(), src.xend(), src.ybegin(), src.yend(), src.zbegin(), src.zend(), 0,
-                        src.nchannels());
-    if (!dst.set_pixels(roi, OIIO::TypeDesc::FLOAT, pixels.data())) {
+    if (!dst.set_pixels(dst.roi(), OIIO::TypeDesc::FLOAT, pixels.data())) {
         dst.errorfmt("push-pull could not write result pixels");
         return false;
     }
     return true;
 }
 
-}  // namespace
-
-bool
-applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const int nthreads)
+// Final pass over a sparse top level, one tile row at a time: the fine rows are gathered and composited over coarse,
+// straight into the pixels of a float result and through a float band for other formats.
+static bool
+writeSparseResult(OIIO::ImageBuf& dst, const OIIO::ImageSpec& spec, const PushPullSparseLevel& fine,
+                  const PushPullLevel& coarse, const bool inPlace, const int nthreads)
 {
-    if (!validatePushPullSource(dst, src)) {
-        return false;
-    }
-    if (&dst == &src) {
-        OIIO::ImageBuf tmp;
-        const bool ok = applyPushPullFill(tmp, src, nthreads);
-        dst           = std::move(tmp);
-        return ok;
-    }
-    std::vector<PushPullLevel> pyramid;
-    pyramid.reserve(32);
-    pyramid.emplace_back();
-    if (!readTopLevel(&pyramid.back(), dst, src)) {
+    if (!prepareResult(dst, spec, inPlace)) {
         return false;
     }
+    std::vector<solidify_pushpull_hwy::PushPullBilinearWeights> xWeights;
+    std::vector<solidify_pushpull_hwy::PushPullBilinearWeights> yWeights;
+    prepareBilinearResizeWeights(&xWeights, &yWeights, fine.width, fine.height, coarse.width, coarse.height);
 
-    while (pyramid.back().width > 1 || pyramid.back().height > 1) {
-        PushPullLevel level;
-        if (!runPullLevel(&level, pyramid.back(), nthreads)) {
-            dst.errorfmt("push-pull pull kernel failed");
-            return false;
-        }
+    const OIIO::ROI roi    = dst.roi();
+    const size_t rowFloats = static_cast<size_t>(fine.width) * fine.channels;
+    float* dstPixels       = spec.format == OIIO::TypeDesc::FLOAT ? static_cast<float*>(dst.localpixels()) : nullptr;
+    std::atomic<bool> ok   = true;
+    OIIO::ROI tileRoi(0, 1, 0, fine.tileRows, 0, 1, 0, 1);
+    OIIO::ImageBufAlgo::parallel_image(tileRoi, nthreads, [&](OIIO::ROI chunk) {
+        std::vector<float> rows;
+        std::vector<float> filled;
+        for (int ty = chunk.ybegin; ty < chunk.yend; ++ty) {
+            const int y0 = ty * kPushPullSparseTile;
+            const int y1 = std::min(fine.height, y0 + kPushPullSparseTile);
+            rows.resize(static_cast<size_t>(y1 - y0) * rowFloats);
+            gatherSparseRows(fine, y0, y1, rows.data());
+            if (!dstPixels) {
+                filled.resize(rows.size());
+            }
+
+            solidify_pushpull_hwy::PushPullFinalView view;
+            view.fine         = rows.data();
+            view.coarse       = coarse.pixels.data();
+            view.dst          = dstPixels ? dstPixels + static_cast<size_t>(y0) * rowFloats : filled.data();
+            view.xWeights     = xWeights.data();
+            view.yWeights     = yWeights.data();
+            view.fineWidth    = fine.width;
+            view.fineHeight   = fine.height;
+            view.coarseWidth  = coarse.width;
+            view.coarseHeight = coarse.height;
+            view.channels     = fine.channels;
+            view.xBegin       = 0;
+            view.xEnd         = fine.width;
+            view.yBegin       = y0;
+            view.yEnd         = y1;
+            view.rowOffset    = y0;
+            if (!solidify_pushpull_hwy::runFinalHwy(&view)) {
+                ok = false;
+                return;
+            }
+            OIIO::ROI bandRoi(roi.xbegin, roi.xend, roi.ybegin + y0, roi.ybegin + y1, roi.zbegin, roi.zend, 0,
+                              fine.channels);
+            if (!dstPixels && !dst.set_pixels(bandRoi, OIIO::TypeDesc::FLOAT, filled.data())) {
+                ok = false;
+                return;
+            }
+        }
+    });
+    if (!ok.load()) {
+        dst.errorfmt("push-pull final kernel failed");
+        return false;
+    }
+    return true;
+}
+
+// Unpremultiplied copies of the filled pyramid levels below resultLevel, in the source channel layout.
+static bool
+writeMipLevels(std::vector<OIIO::ImageBuf>* mipLevels, const OIIO::ImageSpec& srcSpec,
+               const std::vector<PushPullLevel>& pyramid, const int resultLevel, const PushPullOptions& options)
+{
+    mipLevels->clear();
+    mipLevels->reserve(pyramid.size());
+    for (size_t i = static_cast<size_t>(resultLevel) + 1; i < pyramid.size(); ++i) {
+        const PushPullLevel& level = pyramid[i];
+        OIIO::ImageSpec spec(level.width, level.height, srcSpec.nchannels, OIIO::TypeDesc::FLOAT);
+        spec.channelnames  = srcSpec.channelnames;
+        spec.alpha_channel = srcSpec.alpha_channel;
+        OIIO::ImageBuf& mip = mipLevels->emplace_back(spec);
+        if (options.normalMap) {
+            if (!runFinalNormalLevelToBuffer(mip.localpixels(), solidify_pushpull_hwy::PushPullNormalStorage_F32, level,
+                                             nullptr, options, options.nthreads)) {
+                return false;
+            }
+        } else if (!runNormalizeLevelToBuffer(static_cast<float*>(mip.localpixels()), level, options.nthreads)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Decodes the filled octahedral level into dst, straight into its pixels for float, uint16 and half results.
+static bool
+writeNormalResult(OIIO::ImageBuf& dst, const OIIO::ImageSpec& spec, const PushPullLevel& fine,
+                  const PushPullLevel* coarse, const PushPullOptions& options, const bool inPlace)
+{
+    int storage = -1;
+    if (spec.format == OIIO::TypeDesc::FLOAT) {
+        storage = solidify_pushpull_hwy::PushPullNormalStorage_F32;
+    } else if (spec.format == OIIO::TypeDesc::UINT16) {
+        storage = solidify_pushpull_hwy::PushPullNormalStorage_U16;
+    } else if (spec.format == OIIO::TypeDesc::HALF) {
+        storage = solidify_pushpull_hwy::PushPullNormalStorage_F16;
+    }
+
+    if (storage >= 0) {
+        if (!prepareResult(dst, spec, inPlace)) {
+            return false;
+        }
+        if (!runFinalNormalLevelToBuffer(dst.localpixels(), storage, fine, coarse, options, options.nthreads)) {
+            dst.errorfmt("push-pull final normal kernel failed");
+            return false;
+        }
+        return true;
+    }
+
+    ImageVector<float> decoded(static_cast<size_t>(fine.width) * static_cast<size_t>(fine.height) * 4u);
+    if (!runFinalNormalLevelToBuffer(decoded.data(), solidify_pushpull_hwy::PushPullNormalStorage_F32, fine, coarse,
+                                     options, options.nthreads)) {
+        dst.errorfmt("push-pull final normal kernel failed");
+        return false;
+    }
+    return writeResult(dst, spec, decoded, inPlace);
+}
+
+static bool
+setBandedError(std::string* error, const char* message)
+{
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+// Receives rows [ybegin, yend) of one level of a banded fill, in order from the top.
+using PushPullRowsFn = std::function<bool(int ybegin, int yend, const float* pixels)>;
+
+// Source for the level pulled from source. Each band is pulled on demand from the source rows under its filter
+// footprint, so nothing of either level is kept between calls. source must outlive the returned source.
+static PushPullBandSource
+pulledBandSource(const PushPullBandSource& source, const int nthreads)
+{
+    const int srcWidth  = source.width;
+    const int srcHeight = source.height;
+    const int channels  = source.channels;
+    const int dstWidth  = std::max(1, srcWidth / 2);
+    const int dstHeight = std::max(1, srcHeight / 2);
+    const bool exact2x  = srcWidth == dstWidth * 2 && srcHeight == dstHeight * 2;
+
+    auto xWeights = std::make_shared<std::vector<solidify_pushpull_hwy::PushPullTriangleWeights>>();
+    auto yWeights = std::make_shared<std::vector<solidify_pushpull_hwy::PushPullTriangleWeights>>();
+    if (!exact2x) {
+        xWeights->resize(static_cast<size_t>(dstWidth));
+        yWeights->resize(static_cast<size_t>(dstHeight));
+        for (int x = 0; x < dstWidth; ++x) {
+            computeTriangleResizeWeights(&(*xWeights)[static_cast<size_t>(x)], x, srcWidth, dstWidth);
+        }
+        for (int y = 0; y < dstHeight; ++y) {
+            computeTriangleResizeWeights(&(*yWeights)[static_cast<size_t>(y)], y, srcHeight, dstHeight);
+        }
+    }
+
+    PushPullBandSource pulled;
+    pulled.width    = dstWidth;
+    pulled.height   = dstHeight;
+    pulled.channels = channels;
+    pulled.readRows = [&source, srcWidth, srcHeight, channels, dstWidth, dstHeight, exact2x, xWeights, yWeights,
+                       nthreads](const int y0, const int y1, float* pixels) {
+        // Source rows touched by this band of destination rows, including the filter halo.
+        int srcBegin = 0;
+        int srcEnd   = 0;
+        if (exact2x) {
+            srcBegin = std::max(0, y0 * 2 - 1);
+            srcEnd   = std::min(srcHeight, y1 * 2 + 1);
+        } else {
+            srcBegin = srcHeight;
+            srcEnd   = 0;
+            for (int y = y0; y < y1; ++y) {
+                const solidify_pushpull_hwy::PushPullTriangleWeights& yw = (*yWeights)[static_cast<size_t>(y)];
+                for (int i = 0; i < yw.taps; ++i) {
+                    srcBegin = std::min(srcBegin, yw.indices[i]);
+                    srcEnd   = std::max(srcEnd, yw.indices[i] + 1);
+                }
+            }
+        }
+
+        std::vector<float> band(static_cast<size_t>(srcEnd - srcBegin) * static_cast<size_t>(srcWidth)
+                                * static_cast<size_t>(channels));
+        if (!source.readRows(srcBegin, srcEnd, band.data())) {
+            return false;
+        }
+
+        std::atomic<bool> ok = true;
+        OIIO::ROI roi(0, dstWidth, y0, y1, 0, 1, 0, channels);
+        OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+            solidify_pushpull_hwy::PushPullPullView view;
+            view.src        = band.data();
+            view.dst        = pixels;
+            view.xWeights   = xWeights->data();
+            view.yWeights   = yWeights->data();
+            view.srcWidth   = srcWidth;
+            view.srcHeight  = srcHeight;
+            view.dstWidth   = dstWidth;
+            view.dstHeight  = dstHeight;
+            view.channels   = channels;
+            view.xBegin     = chunk.xbegin;
+            view.xEnd       = chunk.xend;
+            view.yBegin     = chunk.ybegin;
+            view.yEnd       = chunk.yend;
+            view.srcYOffset = srcBegin;
+            view.dstYOffset = y0;
+            const bool done = exact2x ? solidify_pushpull_hwy::runPullExact2xHwy(&view)
+                                      : solidify_pushpull_hwy::runPullHwy(&view);
+            if (!done) {
+                ok = false;
+            }
+        });
+        return ok.load();
+    };
+    return pulled;
+}
+
+// Size of one level of a banded fill and of the level below it, with the weights that upsample the coarse level.
+struct PushPullBandedLevel {
+    int width        = 0;
+    int height       = 0;
+    int coarseWidth  = 0;
+    int coarseHeight = 0;
+    int channels     = 0;
+    std::vector<solidify_pushpull_hwy::PushPullBilinearWeights> xWeights;
+    std::vector<solidify_pushpull_hwy::PushPullBilinearWeights> yWeights;
+};
+
+// Composites rows [y0, y1) of a level, held at pixels, over the filled coarse rows held from coarseBegin at coarse,
+// in place. With normalize the result is divided by alpha as in the final pass, otherwise it stays premultiplied.
+static bool
+composeBandedRows(float* pixels, const int y0, const int y1, const float* coarse, const int coarseBegin,
+                  const PushPullBandedLevel& level, const bool normalize, const int nthreads)
+{
+    std::atomic<bool> ok = true;
+    OIIO::ROI roi(0, level.width, y0, y1, 0, 1, 0, level.channels);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        if (normalize) {
+            solidify_pushpull_hwy::PushPullFinalView view;
+            view.fine          = pixels;
+            view.coarse        = coarse;
+            view.dst           = pixels;
+            view.xWeights      = level.xWeights.data();
+            view.yWeights      = level.yWeights.data();
+            view.fineWidth     = level.width;
+            view.fineHeight    = level.height;
+            view.coarseWidth   = level.coarseWidth;
+            view.coarseHeight  = level.coarseHeight;
+            view.channels      = level.channels;
+            view.xBegin        = chunk.xbegin;
+            view.xEnd          = chunk.xend;
+            view.yBegin        = chunk.ybegin;
+            view.yEnd          = chunk.yend;
+            view.rowOffset     = y0;
+            view.coarseYOffset = coarseBegin;
+            if (!solidify_pushpull_hwy::runFinalHwy(&view)) {
+                ok = false;
+            }
+            return;
+        }
+        solidify_pushpull_hwy::PushPullPushView view;
+        view.fine          = pixels;
+        view.coarse        = coarse;
+        view.dst           = pixels;
+        view.xWeights      = level.xWeights.data();
+        view.yWeights      = level.yWeights.data();
+        view.fineWidth     = level.width;
+        view.fineHeight    = level.height;
+        view.coarseWidth   = level.coarseWidth;
+        view.coarseHeight  = level.coarseHeight;
+        view.channels      = level.channels;
+        view.xBegin        = chunk.xbegin;
+        view.xEnd          = chunk.xend;
+        view.yBegin        = chunk.ybegin;
+        view.yEnd          = chunk.yend;
+        view.rowOffset     = y0;
+        view.coarseYOffset = coarseBegin;
+        if (!solidify_pushpull_hwy::runPushHwy(&view)) {
+            ok = false;
+        }
+    });
+    return ok.load();
+}
+
+// Fills the level read from source and hands it to emit in bands of bandRows rows, unpremultiplied when normalize is
+// set and premultiplied for the next finer level otherwise. A level of at most residentBytes is read whole and filled
+// with its pyramid in memory. A larger one fills the level below through a recursive call on pulledBandSource and
+// reads source again band by band as the coarse rows under each band arrive, so it keeps only a band of its own rows
+// and a window of coarse rows.
+static bool
+runBandedLevel(const PushPullBandSource& source, const PushPullRowsFn& emit, const bool normalize, const int bandRows,
+               const size_t residentBytes, const int nthreads)
+{
+    const int width        = source.width;
+    const int height       = source.height;
+    const int channels     = source.channels;
+    const size_t rowFloats = static_cast<size_t>(width) * static_cast<size_t>(channels);
+
+    if (width == 1 && height == 1) {
+        PushPullLevel top;
+        resetLevel(&top, 1, 1, channels);
+        if (!source.readRows(0, 1, top.pixels.data())) {
+            return false;
+        }
+        if (!normalize) {
+            return emit(0, 1, top.pixels.data());
+        }
+        ImageVector<float> normalized;
+        return runNormalizeLevel(&normalized, top, nthreads) && emit(0, 1, normalized.data());
+    }
+
+    PushPullBandedLevel level;
+    level.width        = width;
+    level.height       = height;
+    level.coarseWidth  = std::max(1, width / 2);
+    level.coarseHeight = std::max(1, height / 2);
+    level.channels     = channels;
+    prepareBilinearResizeWeights(&level.xWeights, &level.yWeights, width, height, level.coarseWidth,
+                                 level.coarseHeight);
+
+    if (rowFloats * static_cast<size_t>(height) * sizeof(float) <= residentBytes) {
+        std::vector<PushPullLevel> pyramid;
+        pyramid.reserve(32);
+        pyramid.emplace_back();
+        resetLevel(&pyramid.back(), width, height, channels);
+        for (int y0 = 0; y0 < height; y0 += bandRows) {
+            const int y1 = std::min(height, y0 + bandRows);
+            if (!source.readRows(y0, y1, pyramid.back().pixels.data() + static_cast<size_t>(y0) * rowFloats)) {
+                return false;
+            }
+        }
+        while (pyramid.back().width > 1 || pyramid.back().height > 1) {
+            PushPullLevel next;
+            if (!runPullLevel(&next, pyramid.back(), nthreads)) {
+                return false;
+            }
+            pyramid.push_back(std::move(next));
+        }
+        for (int i = static_cast<int>(pyramid.size()) - 2; i >= 1; --i) {
+            PushPullLevel filled;
+            if (!runPushLevel(&filled, pyramid[static_cast<size_t>(i)], pyramid[static_cast<size_t>(i + 1)],
+                              nthreads)) {
+                return false;
+            }
+            pyramid[static_cast<size_t>(i)].pixels.swap(filled.pixels);
+        }
+
+        float* pixels       = pyramid[0].pixels.data();
+        const float* coarse = pyramid[1].pixels.data();
+        for (int y0 = 0; y0 < height; y0 += bandRows) {
+            const int y1 = std::min(height, y0 + bandRows);
+            float* band  = pixels + static_cast<size_t>(y0) * rowFloats;
+            if (!composeBandedRows(band, y0, y1, coarse, 0, level, normalize, nthreads) || !emit(y0, y1, band)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const size_t coarseRowFloats = static_cast<size_t>(level.coarseWidth) * static_cast<size_t>(channels);
+    std::vector<float> band(static_cast<size_t>(bandRows) * rowFloats);
+    std::vector<float> window;  // Filled coarse rows [coarseBegin, coarseEnd)
+    int coarseBegin = 0;
+    int coarseEnd   = 0;
+    int next        = 0;
+
+    // Composites every band whose coarse rows have all arrived, then drops the coarse rows no later band reads.
+    auto flush = [&]() {
+        while (next < height) {
+            const int y1 = std::min(height, next + bandRows);
+            if (level.yWeights[static_cast<size_t>(y1 - 1)].index1 >= coarseEnd) {
+                return true;
+            }
+            if (!source.readRows(next, y1, band.data())
+                || !composeBandedRows(band.data(), next, y1, window.data(), coarseBegin, level, normalize, nthreads)
+                || !emit(next, y1, band.data())) {
+                return false;
+            }
+            next = y1;
+            if (next < height) {
+                const int keep = level.yWeights[static_cast<size_t>(next)].index0;
+                if (keep > coarseBegin) {
+                    window.erase(window.begin(),
+                                 window.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(keep - coarseBegin)
+                                                                              * coarseRowFloats));
+                    coarseBegin = keep;
+                }
+            }
+        }
+        return true;
+    };
+    const PushPullRowsFn receive = [&](const int y0, const int y1, const float* pixels) {
+        window.insert(window.end(), pixels, pixels + static_cast<size_t>(y1 - y0) * coarseRowFloats);
+        coarseEnd = y1;
+        return flush();
+    };
+
+    const PushPullBandSource coarseSource = pulledBandSource(source, nthreads);
+    if (!runBandedLevel(coarseSource, receive, false, bandRows, residentBytes, nthreads)) {
+        return false;
+    }
+    return next == height;
+}
+
+// Scattered samples start at the finest pyramid level with at least this many samples per pixel.
+static constexpr float kPushPullSampleLevelDensity = 0.25f;
+
+// Accumulates samples of a width x height target into level, whose size is that of a pyramid level of the target,
+// keeping the weighted mean color premultiplied by the pixel's summed weight, at most 1.
+static void
+accumulateSamples(PushPullLevel* level, const std::vector<PushPullSample>& samples, const int width,
+                  const int height, const int nthreads)
+{
+    const int colorChannels = level->channels - 1;
+    const float xScale      = static_cast<float>(level->width) / static_cast<float>(width);
+    const float yScale      = static_cast<float>(level->height) / static_cast<float>(height);
+    for (const PushPullSample& sample : samples) {
+        if (!(sample.weight > 0.0f) || !(sample.x >= 0.0f && sample.x < static_cast<float>(width))
+            || !(sample.y >= 0.0f && sample.y < static_cast<float>(height))) {
+            continue;
+        }
+        const int x  = std::min(level->width - 1, static_cast<int>(sample.x * xScale));
+        const int y  = std::min(level->height - 1, static_cast<int>(sample.y * yScale));
+        float* pixel = level->pixels.data()
+                       + (static_cast<size_t>(y) * static_cast<size_t>(level->width) + static_cast<size_t>(x))
+                             * static_cast<size_t>(level->channels);
+        for (int c = 0; c < colorChannels; ++c) {
+            pixel[c] += sample.color[c] * sample.weight;
+        }
+        pixel[colorChannels] += sample.weight;
+    }
+
+    OIIO::ROI roi(0, level->width, 0, level->height, 0, 1, 0, level->channels);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        for (int y = chunk.ybegin; y < chunk.yend; ++y) {
+            for (int x = chunk.xbegin; x < chunk.xend; ++x) {
+                float* pixel = level->pixels.data()
+                               + (static_cast<size_t>(y) * static_cast<size_t>(level->width)
+                                  + static_cast<size_t>(x))
+                                     * static_cast<size_t>(level->channels);
+                const float weight = pixel[colorChannels];
+                if (weight <= 0.0f) {
+                    continue;
+                }
+                const float alpha = std::min(weight, 1.0f);
+                for (int c = 0; c < colorChannels; ++c) {
+                    pixel[c] *= alpha / weight;
+                }
+                pixel[colorChannels] = alpha;
+            }
+        }
+    });
+}
+
+// Membrane solve sweeps: per grid of the full multigrid start, per grid and side of each V-cycle, and at the coarsest
+// grid of a V-cycle. With the cycle count they are fixed, so the solve costs a constant number of passes per pixel.
+static constexpr int kPushPullMembraneLevelSweeps  = 4;
+static constexpr int kPushPullMembraneCycles       = 2;
+static constexpr int kPushPullMembraneCycleSweeps  = 2;
+static constexpr int kPushPullMembraneCoarseSweeps = 16;
+
+// A grid of the membrane solve. field holds color with the coverage slot last: fixed pixels, which the sweeps leave
+// alone, hold straight color and coverage 1, and free pixels the solved values, whose color is weighted by their
+// coverage slot like premultiplied color. Solving color and coverage together is exact because the solve is linear
+// and treats every channel alike. rhs is the right-hand side, or nothing for zero.
+struct PushPullMembraneGrid {
+    PushPullLevel field;
+    ImageVector<float> rhs;
+    std::vector<uint8_t> fixed;
+};
+
+// One red-black Gauss-Seidel sweep. The two colors run one after the other, each parallel over rows.
+static bool
+runMembraneSweep(PushPullMembraneGrid* grid, const int nthreads)
+{
+    const PushPullLevel& field = grid->field;
+    for (int parity = 0; parity < 2; ++parity) {
+        std::atomic<bool> ok = true;
+        OIIO::ROI roi(0, field.width, 0, field.height, 0, 1, 0, field.channels);
+        OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+            solidify_pushpull_hwy::PushPullSmoothView view;
+            view.u        = grid->field.pixels.data();
+            view.rhs      = grid->rhs.empty() ? nullptr : grid->rhs.data();
+            view.fixed    = grid->fixed.data();
+            view.width    = field.width;
+            view.height   = field.height;
+            view.channels = field.channels;
+            view.parity   = parity;
+            view.yBegin   = chunk.ybegin;
+            view.yEnd     = chunk.yend;
+            if (!solidify_pushpull_hwy::runSmoothHwy(&view)) {
+                ok = false;
+            }
+        });
+        if (!ok.load()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+runMembraneSweeps(PushPullMembraneGrid* grid, const int sweeps, const int nthreads)
+{
+    for (int i = 0; i < sweeps; ++i) {
+        if (!runMembraneSweep(grid, nthreads)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Fixes the fully covered pixels of level at their straight color. A level without pixels fixes none.
+static void
+seedMembraneGrid(PushPullMembraneGrid* grid, const PushPullLevel& level, const int nthreads)
+{
+    const size_t pixelCount = static_cast<size_t>(level.width) * static_cast<size_t>(level.height);
+    grid->fixed.assign(pixelCount, 0);
+    if (level.pixels.empty()) {
+        return;
+    }
+
+    const int channels = level.channels;
+    OIIO::ROI roi(0, level.width, 0, level.height, 0, 1, 0, channels);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        for (int y = chunk.ybegin; y < chunk.yend; ++y) {
+            for (int x = chunk.xbegin; x < chunk.xend; ++x) {
+                const size_t index = static_cast<size_t>(y) * static_cast<size_t>(level.width)
+                                     + static_cast<size_t>(x);
+                const float* src  = level.pixels.data() + index * static_cast<size_t>(channels);
+                const float alpha = src[channels - 1];
+                if (alpha < 1.0f - kPushPullAlphaEpsilon) {
+                    continue;
+                }
+                float* dst = grid->field.pixels.data() + index * static_cast<size_t>(channels);
+                for (int c = 0; c < channels - 1; ++c) {
+                    dst[c] = src[c] / alpha;
+                }
+                dst[channels - 1]  = 1.0f;
+                grid->fixed[index] = 1;
+            }
+        }
+    });
+}
+
+// Coarse child ranges of the pyramid: coarse column X covers fine columns [2X, 2X + 2), and the last one also covers
+// the odd column a fine size not divisible by two leaves over.
+static int
+membraneChildEnd(const int coarse, const int coarseSize, const int fineSize)
+{
+    return coarse == coarseSize - 1 ? fineSize : std::min(fineSize, coarse * 2 + 2);
+}
+
+// Allocates a correction grid of coarse's size below fine. Like the pull's coverage, a coarse pixel is fixed when any
+// of its children is: the coarse problem then keeps a boundary wherever the fine one has one, and never becomes a
+// pure Neumann problem whose correction drifts without bound.
+static void
+prepareMembraneCorrectionGrid(PushPullMembraneGrid* coarse, const PushPullMembraneGrid& fine, const int width,
+                              const int height, const int nthreads)
+{
+    const int channels = fine.field.channels;
+    resetLevel(&coarse->field, width, height, channels);
+    ImageVector<float>(coarse->field.pixels.size()).swap(coarse->rhs);
+    coarse->fixed.assign(static_cast<size_t>(width) * static_cast<size_t>(height), 0);
+
+    const int fineWidth  = fine.field.width;
+    const int fineHeight = fine.field.height;
+    OIIO::ROI roi(0, width, 0, height, 0, 1, 0, channels);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        for (int y = chunk.ybegin; y < chunk.yend; ++y) {
+            const int yEnd = membraneChildEnd(y, height, fineHeight);
+            for (int x = chunk.xbegin; x < chunk.xend; ++x) {
+                const int xEnd = membraneChildEnd(x, width, fineWidth);
+                bool fixed     = false;
+                for (int fy = std::min(y * 2, fineHeight - 1); fy < yEnd && !fixed; ++fy) {
+                    for (int fx = std::min(x * 2, fineWidth - 1); fx < xEnd; ++fx) {
+                        if (fine.fixed[static_cast<size_t>(fy) * static_cast<size_t>(fineWidth) + fx] != 0) {
+                            fixed = true;
+                            break;
+                        }
+                    }
+                }
+                coarse->fixed[static_cast<size_t>(y) * static_cast<size_t>(width) + x] = fixed ? 1 : 0;
+            }
+        }
+    });
+}
+
+// Restricts the residual of fine into the right-hand side of coarse and clears the coarse correction. Each coarse
+// row takes the mean residual of its children, scaled by four for the doubled grid spacing, from a band of residual
+// rows computed only for it.
+static bool
+restrictMembraneResidual(PushPullMembraneGrid* coarse, const PushPullMembraneGrid& fine, const int nthreads)
+{
+    const PushPullLevel& fineField = fine.field;
+    const int width                = coarse->field.width;
+    const int height               = coarse->field.height;
+    const int channels             = fineField.channels;
+    const size_t fineStride        = static_cast<size_t>(fineField.width) * static_cast<size_t>(channels);
+    parallelZero(coarse->field.pixels.data(), coarse->field.pixels.size() * sizeof(float), nthreads);
+
+    std::atomic<bool> ok = true;
+    OIIO::ROI roi(0, width, 0, height, 0, 1, 0, channels);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        std::vector<float> band;
+        for (int y = chunk.ybegin; y < chunk.yend; ++y) {
+            const int fyBegin = std::min(y * 2, fineField.height - 1);
+            const int fyEnd   = membraneChildEnd(y, height, fineField.height);
+            band.resize(static_cast<size_t>(fyEnd - fyBegin) * fineStride);
+
+            solidify_pushpull_hwy::PushPullResidualView view;
+            view.u        = fineField.pixels.data();
+            view.rhs      = fine.rhs.empty() ? nullptr : fine.rhs.data();
+            view.fixed    = fine.fixed.data();
+            view.dst      = band.data();
+            view.width    = fineField.width;
+            view.height   = fineField.height;
+            view.channels = channels;
+            view.yBegin   = fyBegin;
+            view.yEnd     = fyEnd;
+            if (!solidify_pushpull_hwy::runResidualHwy(&view)) {
+                ok = false;
+                return;
+            }
+
+            float* dstRow = coarse->rhs.data() + static_cast<size_t>(y) * static_cast<size_t>(width) * channels;
+            for (int x = 0; x < width; ++x) {
+                const int fxBegin = std::min(x * 2, fineField.width - 1);
+                const int fxEnd   = membraneChildEnd(x, width, fineField.width);
+                float* dst        = dstRow + static_cast<size_t>(x) * static_cast<size_t>(channels);
+                std::fill(dst, dst + channels, 0.0f);
+                for (int fy = fyBegin; fy < fyEnd; ++fy) {
+                    const float* srcRow = band.data() + static_cast<size_t>(fy - fyBegin) * fineStride;
+                    for (int fx = fxBegin; fx < fxEnd; ++fx) {
+                        const float* src = srcRow + static_cast<size_t>(fx) * static_cast<size_t>(channels);
+                        for (int c = 0; c < channels; ++c) {
+                            dst[c] += src[c];
+                        }
+                    }
+                }
+                const float scale = 4.0f / static_cast<float>((fyEnd - fyBegin) * (fxEnd - fxBegin));
+                for (int c = 0; c < channels; ++c) {
+                    dst[c] *= scale;
+                }
+            }
+        }
+    });
+    return ok.load();
+}
+
+// A level holding only the size of level, which runPushLevel fills with the upsampled coarse level alone.
+static PushPullLevel
+sizeOnlyLevel(const PushPullLevel& level)
+{
+    PushPullLevel shape;
+    shape.width    = level.width;
+    shape.height   = level.height;
+    shape.channels = level.channels;
+    return shape;
+}
+
+// Adds the bilinear upsample of the coarse correction to the free pixels of fine.
+static bool
+addMembraneCorrection(PushPullMembraneGrid* fine, const PushPullLevel& correction, const int nthreads)
+{
+    PushPullLevel& field = fine->field;
+    PushPullLevel upsampled;
+    if (!runPushLevel(&upsampled, sizeOnlyLevel(field), correction, nthreads)) {
+        return false;
+    }
+
+    const int channels = field.channels;
+    OIIO::ROI roi(0, field.width, 0, field.height, 0, 1, 0, channels);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        for (int y = chunk.ybegin; y < chunk.yend; ++y) {
+            for (int x = chunk.xbegin; x < chunk.xend; ++x) {
+                const size_t index = static_cast<size_t>(y) * static_cast<size_t>(field.width)
+                                     + static_cast<size_t>(x);
+                if (fine->fixed[index] != 0) {
+                    continue;
+                }
+                const size_t base = index * static_cast<size_t>(channels);
+                for (int c = 0; c < channels; ++c) {
+                    field.pixels[base + c] += upsampled.pixels[base + c];
+                }
+            }
+        }
+    });
+    return true;
+}
+
+// V-cycle from grids[index] down: sweeps, restricts the residual, solves the coarser correction, adds it back and
+// sweeps again. The coarsest grid is only swept.
+static bool
+runMembraneCycle(std::vector<PushPullMembraneGrid>& grids, const size_t index, const int nthreads)
+{
+    PushPullMembraneGrid* grid = &grids[index];
+    if (index + 1 == grids.size()) {
+        return runMembraneSweeps(grid, kPushPullMembraneCoarseSweeps, nthreads);
+    }
+    PushPullMembraneGrid* coarse = &grids[index + 1];
+    return runMembraneSweeps(grid, kPushPullMembraneCycleSweeps, nthreads)
+           && restrictMembraneResidual(coarse, *grid, nthreads) && runMembraneCycle(grids, index + 1, nthreads)
+           && addMembraneCorrection(grid, coarse->field, nthreads)
+           && runMembraneSweeps(grid, kPushPullMembraneCycleSweeps, nthreads);
+}
+
+// Solves the membrane fill of pyramid level resultLevel into dst, color weighted by the coverage slot as in
+// PushPullMembraneGrid, for the final pass to composite the level over and divide by coverage. The pulled levels are
+// the multigrid hierarchy: the solve starts at the coarsest, fixed where the pull found coverage, and each finer
+// level starts from the upsampled solution of the one below and is swept with its own known pixels fixed. Fixed
+// cycles then refine resultLevel.
+// The levels below resultLevel are replaced by their solutions, which writeMipLevels reads like pushed levels.
+static bool
+runMembraneFill(PushPullLevel* dst, std::vector<PushPullLevel>& pyramid, const int resultLevel, const int nthreads)
+{
+    const size_t last        = pyramid.size() - 1;
+    const PushPullLevel& top = pyramid[last];
+
+    PushPullMembraneGrid grid;
+    resetLevelZeroed(&grid.field, top.width, top.height, top.channels, nthreads);
+    seedMembraneGrid(&grid, top, nthreads);
+    if (!runMembraneSweeps(&grid, kPushPullMembraneCoarseSweeps, nthreads)) {
+        return false;
+    }
+    for (size_t i = last; i > static_cast<size_t>(resultLevel); --i) {
+        const PushPullLevel& level = pyramid[i - 1];
+        PushPullMembraneGrid finer;
+        if (!runPushLevel(&finer.field, sizeOnlyLevel(level), grid.field, nthreads)) {
+            return false;
+        }
+        // Levels holding only their size take the upsampled solution, as the push would give them the coarse level.
+        seedMembraneGrid(&finer, level, nthreads);
+        if (!level.pixels.empty() && !runMembraneSweeps(&finer, kPushPullMembraneLevelSweeps, nthreads)) {
+            return false;
+        }
+        pyramid[i].pixels.swap(grid.field.pixels);
+        grid = std::move(finer);
+    }
+
+    // Without a fully covered pixel the result level has no boundary for the cycles to solve against.
+    if (std::find(grid.fixed.begin(), grid.fixed.end(), 1) == grid.fixed.end()) {
+        *dst = std::move(grid.field);
+        return true;
+    }
+    std::vector<PushPullMembraneGrid> grids;
+    grids.reserve(pyramid.size() - static_cast<size_t>(resultLevel));
+    grids.push_back(std::move(grid));
+    for (size_t i = static_cast<size_t>(resultLevel) + 1; i < pyramid.size(); ++i) {
+        PushPullMembraneGrid coarse;
+        prepareMembraneCorrectionGrid(&coarse, grids.back(), pyramid[i].width, pyramid[i].height, nthreads);
+        grids.push_back(std::move(coarse));
+    }
+    for (int cycle = 0; cycle < kPushPullMembraneCycles; ++cycle) {
+        if (!runMembraneCycle(grids, 0, nthreads)) {
+            return false;
+        }
+    }
+    *dst = std::move(grids.front().field);
+    return true;
+}
+
+// Seed plane value of a pixel without a seed. Far enough off any image that every real seed is closer.
+static constexpr float kPushPullNoSeed = -1.0e9f;
+
+// Seeds the jump flood with the covered pixels of level, each its own seed.
+static void
+seedJumpFlood(float* seedX, float* seedY, const PushPullLevel& level, const int nthreads)
+{
+    const int channels = level.channels;
+    OIIO::ROI roi(0, level.width, 0, level.height, 0, 1, 0, channels);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        for (int y = chunk.ybegin; y < chunk.yend; ++y) {
+            for (int x = chunk.xbegin; x < chunk.xend; ++x) {
+                const size_t index = static_cast<size_t>(y) * static_cast<size_t>(level.width)
+                                     + static_cast<size_t>(x);
+                const bool covered = !level.pixels.empty()
+                                     && level.pixels[(index + 1) * static_cast<size_t>(channels) - 1]
+                                            > kPushPullAlphaEpsilon;
+                seedX[index] = covered ? static_cast<float>(x) : kPushPullNoSeed;
+                seedY[index] = covered ? static_cast<float>(y) : kPushPullNoSeed;
+            }
+        }
+    });
+}
+
+// Finds the nearest covered pixel of every pixel of level by jump flooding: passes at steps halving down to one
+// pixel, each offering every pixel the seeds of its eight neighbours step away, and one more one-pixel pass to fix
+// most of the misses the halving leaves. A radius above zero caps the first step, since seeds farther away are
+// dropped anyway. seedX and seedY receive the seed coordinates, kPushPullNoSeed where none reached the pixel.
+static bool
+runJumpFlood(ImageVector<float>* seedX, ImageVector<float>* seedY, const PushPullLevel& level, const int radius,
+             const int nthreads)
+{
+    const size_t pixelCount = static_cast<size_t>(level.width) * static_cast<size_t>(level.height);
+    ImageVector<float>(pixelCount).swap(*seedX);
+    ImageVector<float>(pixelCount).swap(*seedY);
+    ImageVector<float> nextX(pixelCount);
+    ImageVector<float> nextY(pixelCount);
+    seedJumpFlood(seedX->data(), seedY->data(), level, nthreads);
+
+    int step = static_cast<int>(std::bit_ceil(static_cast<unsigned>(std::max(level.width, level.height))) / 2u);
+    if (radius > 0) {
+        step = std::min(step, static_cast<int>(std::bit_ceil(static_cast<unsigned>(radius))));
+    }
+    std::vector<int> steps;
+    for (; step > 0; step /= 2) {
+        steps.push_back(step);
+    }
+    steps.push_back(1);
+
+    OIIO::ROI roi(0, level.width, 0, level.height, 0, 1, 0, 1);
+    for (const int passStep : steps) {
+        std::atomic<bool> ok = true;
+        OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+            solidify_pushpull_hwy::PushPullJumpFloodView view;
+            view.srcX   = seedX->data();
+            view.srcY   = seedY->data();
+            view.dstX   = nextX.data();
+            view.dstY   = nextY.data();
+            view.width  = level.width;
+            view.height = level.height;
+            view.step   = passStep;
+            view.yBegin = chunk.ybegin;
+            view.yEnd   = chunk.yend;
+            if (!solidify_pushpull_hwy::runJumpFloodHwy(&view)) {
+                ok = false;
+            }
+        });
+        if (!ok.load()) {
+            return false;
+        }
+        seedX->swap(nextX);
+        seedY->swap(nextY);
+    }
+    return true;
+}
+
+// Dilates level into dst: every pixel takes the straight color of its nearest covered pixel with coverage 1, and
+// pixels farther than a radius above zero stay zero. distance, when given, receives per pixel the distance to that
+// covered pixel, or -1 where none was taken.
+static bool
+runDilateLevel(PushPullLevel* dst, const PushPullLevel& level, const int radius, float* distance,
+               const int nthreads)
+{
+    ImageVector<float> seedX;
+    ImageVector<float> seedY;
+    if (!runJumpFlood(&seedX, &seedY, level, radius, nthreads)) {
+        return false;
+    }
+
+    resetLevel(dst, level.width, level.height, level.channels);
+    const int channels   = level.channels;
+    const float radiusSq = static_cast<float>(radius) * static_cast<float>(radius);
+    OIIO::ROI roi(0, level.width, 0, level.height, 0, 1, 0, channels);
+    OIIO::ImageBufAlgo::parallel_image(roi, nthreads, [&](OIIO::ROI chunk) {
+        for (int y = chunk.ybegin; y < chunk.yend; ++y) {
+            for (int x = chunk.xbegin; x < chunk.xend; ++x) {
+                const size_t index = static_cast<size_t>(y) * static_cast<size_t>(level.width)
+                                     + static_cast<size_t>(x);
+                const float dx     = seedX[index] - static_cast<float>(x);
+                const float dy     = seedY[index] - static_cast<float>(y);
+                const float distSq = dx * dx + dy * dy;
+                const bool found   = seedX[index] != kPushPullNoSeed && (radius <= 0 || distSq <= radiusSq);
+                float* out         = dst->pixels.data() + index * static_cast<size_t>(channels);
+                if (distance != nullptr) {
+                    distance[index] = found ? std::sqrt(distSq) : -1.0f;
+                }
+                if (!found) {
+                    std::fill_n(out, channels, 0.0f);
+                    continue;
+                }
+                const size_t seed = static_cast<size_t>(seedY[index]) * static_cast<size_t>(level.width)
+                                    + static_cast<size_t>(seedX[index]);
+                const float* src  = level.pixels.data() + seed * static_cast<size_t>(channels);
+                const float alpha = src[channels - 1];
+                for (int c = 0; c < channels - 1; ++c) {
+                    out[c] = src[c] / alpha;
+                }
+                out[channels - 1] = 1.0f;
+            }
+        }
+    });
+    return true;
+}
+
+// Dilates pyramid level resultLevel into dst for the final pass to composite the level over, and each level below
+// it in place, with the radius shrinking with the level, for writeMipLevels.
+static bool
+runDilateFill(PushPullLevel* dst, float* distance, std::vector<PushPullLevel>& pyramid, const int resultLevel,
+              const int radius, const int nthreads)
+{
+    if (!runDilateLevel(dst, pyramid[static_cast<size_t>(resultLevel)], radius, distance, nthreads)) {
+        return false;
+    }
+    for (size_t i = static_cast<size_t>(resultLevel) + 1; i < pyramid.size(); ++i) {
+        const int shift       = static_cast<int>(i) - resultLevel;
+        const int levelRadius = radius > 0 ? std::max(1, radius >> std::min(shift, 30)) : 0;
+        PushPullLevel dilated;
+        if (!runDilateLevel(&dilated, pyramid[i], levelRadius, nullptr, nthreads)) {
+            return false;
+        }
+        pyramid[i].pixels.swap(dilated.pixels);
+    }
+    return true;
+}
+
+}  // namespace
+
+OIIO::ROI
+pushPullFillRegion(const OIIO::ImageSpec& spec, const PushPullOptions& options)
+{
+    return fillRegion(spec, options);
+}
+
+bool
+pushPullPullPlane(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, int nthreads)
+{
+    const int srcWidth  = src.spec().width;
+    const int srcHeight = src.spec().height;
+    const int dstWidth  = std::max(1, srcWidth / 2);
+    const int dstHeight = std::max(1, srcHeight / 2);
+
+    std::vector<float> plane(static_cast<size_t>(srcWidth) * static_cast<size_t>(srcHeight));
+    OIIO::ROI srcRoi = src.roi();
+    srcRoi.chbegin   = 0;
+    srcRoi.chend     = 1;
+    if (!src.get_pixels(srcRoi, OIIO::TypeDesc::FLOAT, plane.data())) {
+        dst.errorfmt("push-pull could not read the plane as float");
+        return false;
+    }
+
+    // The weights of an exact half are the 1-3-3-1 tent of the exact 2x pull kernel.
+    using Weights = solidify_pushpull_hwy::PushPullTriangleWeights;
+    std::vector<Weights> xWeights(static_cast<size_t>(dstWidth));
+    std::vector<Weights> yWeights(static_cast<size_t>(dstHeight));
+    for (int x = 0; x < dstWidth; ++x) {
+        computeTriangleResizeWeights(&xWeights[static_cast<size_t>(x)], x, srcWidth, dstWidth);
+    }
+    for (int y = 0; y < dstHeight; ++y) {
+        computeTriangleResizeWeights(&yWeights[static_cast<size_t>(y)], y, srcHeight, dstHeight);
+    }
+
+    dst.reset(OIIO::ImageSpec(dstWidth, dstHeight, 1, OIIO::TypeDesc::FLOAT));
+    float* out = static_cast<float*>(dst.localpixels());
+    OIIO::ImageBufAlgo::parallel_image(dst.roi(), nthreads, [&](OIIO::ROI chunk) {
+        for (int y = chunk.ybegin; y < chunk.yend; ++y) {
+            const Weights& yw = yWeights[static_cast<size_t>(y)];
+            for (int x = chunk.xbegin; x < chunk.xend; ++x) {
+                const Weights& xw = xWeights[static_cast<size_t>(x)];
+                float sum         = 0.0f;
+                for (int j = 0; j < yw.taps; ++j) {
+                    const float* row = plane.data() + static_cast<size_t>(yw.indices[j]) * srcWidth;
+                    float rowSum     = 0.0f;
+                    for (int i = 0; i < xw.taps; ++i) {
+                        rowSum += xw.weights[i] * row[xw.indices[i]];
+                    }
+                    sum += yw.weights[j] * rowSum;
+                }
+                out[static_cast<size_t>(y) * dstWidth + x] = sum;
+            }
+        }
+    });
+    return true;
+}
+
+bool
+applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const int nthreads)
+{
+    PushPullOptions options;
+    options.nthreads = nthreads;
+    return applyPushPullFill(dst, src, options);
+}
+
+// Pulls, pushes and composites a pyramid whose top level already holds the premultiplied region. srcSpec is the
+// spec of the source the top level was read from, with alpha as its last channel. inPlace writes the result over
+// the pixels dst already holds, which must have the result spec. With sparseTop the top level holds only its size
+// and its pixels are the stored tiles of sparseTop. Levels before the last one given may also hold only their size,
+// and are then filled from the level below them. Dilation needs no level below the result level, so it pulls only
+// for MIP levels.
+static bool
+fillFromTopLevel(OIIO::ImageBuf& dst, const OIIO::ImageSpec& srcSpec, const OIIO::ROI& region,
+                 const PushPullOptions& options, std::vector<PushPullLevel>& pyramid, const bool inPlace,
+                 const PushPullSparseLevel* sparseTop = nullptr)
+{
+    const int nthreads = options.nthreads;
+    const bool dilate  = options.engine == FillEngine::Dilate;
+    while ((pyramid.back().width > 1 || pyramid.back().height > 1)
+           && (!dilate || options.mipLevels || static_cast<int>(pyramid.size()) <= options.level)) {
+        PushPullLevel level;
+        const bool pulled = sparseTop && pyramid.size() == 1 ? runSparsePullFirstLevel(&level, *sparseTop, nthreads)
+                                                             : runPullLevel(&level, pyramid.back(), nthreads);
+        if (!pulled) {
+            dst.errorfmt("push-pull pull kernel failed");
+            return false;
+        }
         pyramid.push_back(std::move(level));
     }
-    for (int i = static_cast<int>(pyramid.size()) - 2; i >= 1; --i) {
+
+    // The push stops above the result level and the final pass runs at its resolution, so finer levels are only
+    // needed to pull and are released here.
+    const int resultLevel = std::clamp(options.level, 0, static_cast<int>(pyramid.size()) - 1);
+    for (int i = 0; i < resultLevel; ++i) {
+        ImageVector<float>().swap(pyramid[static_cast<size_t>(i)].pixels);
+    }
+    const bool hasCoarse = static_cast<size_t>(resultLevel) + 1 < pyramid.size();
+
+    // The membrane solve and the dilation replace the push: the result level is composited over their solution
+    // instead of the pushed level below it.
+    PushPullLevel solution;
+    const bool solved = dilate || (options.engine == FillEngine::Membrane && hasCoarse);
+    if (options.engine == FillEngine::Membrane && hasCoarse
+        && !runMembraneFill(&solution, pyramid, resultLevel, nthreads)) {
+        dst.errorfmt("push-pull membrane solve failed");
+        return false;
+    }
+    if (dilate) {
+        const PushPullLevel& level = pyramid[static_cast<size_t>(resultLevel)];
+        float* distance            = nullptr;
+        if (options.distance) {
+            OIIO::ImageSpec spec = resultSpec(srcSpec, region, level, resultLevel);
+            spec.nchannels       = 1;
+            spec.format          = OIIO::TypeDesc::FLOAT;
+            spec.channelnames    = { "Y" };
+            spec.alpha_channel   = -1;
+            if (!resetUninitialized(*options.distance, spec)) {
+                dst.errorfmt("push-pull could not allocate distance pixels");
+                return false;
+            }
+            distance = static_cast<float*>(options.distance->localpixels());
+        }
+        if (!runDilateFill(&solution, distance, pyramid, resultLevel, options.dilateRadius, nthreads)) {
+            dst.errorfmt("push-pull dilation failed");
+            return false;
+        }
+    }
+    for (int i = static_cast<int>(pyramid.size()) - 2; i > resultLevel && !solved; --i) {
         PushPullLevel filled;
         if (!runPushLevel(&filled, pyramid[static_cast<size_t>(i)], pyramid[static_cast<size_t>(i + 1)], nthreads)) {
             dst.errorfmt("push-pull push kernel failed");
@@ -1255,71 +2946,356 @@ applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const int nthr
         }
         pyramid[static_cast<size_t>(i)].pixels.swap(filled.pixels);
     }
+    if (options.mipLevels && !writeMipLevels(options.mipLevels, srcSpec, pyramid, resultLevel, options)) {
+        dst.errorfmt("push-pull MIP level kernel failed");
+        return false;
+    }
 
-    if (src.spec().format == OIIO::TypeDesc::FLOAT) {
-        if (!resetLocalResult(dst, src)) {
+    // Without a level below it or a solution the result level is only normalized.
+    const bool composite          = hasCoarse || solved;
+    const PushPullLevel& fine     = pyramid[static_cast<size_t>(resultLevel)];
+    const PushPullLevel& coarse   = solved      ? solution
+                                    : hasCoarse ? pyramid[static_cast<size_t>(resultLevel) + 1]
+                                                : fine;
+    const OIIO::ImageSpec outSpec = resultSpec(srcSpec, region, fine, resultLevel);
+    if (sparseTop && resultLevel == 0) {
+        return writeSparseResult(dst, outSpec, *sparseTop, coarse, inPlace, nthreads);
+    }
+    if (options.normalMap) {
+        return writeNormalResult(dst, outSpec, fine, composite ? &coarse : nullptr, options, inPlace);
+    }
+    if (srcSpec.format == OIIO::TypeDesc::FLOAT) {
+        if (!prepareResult(dst, outSpec, inPlace)) {
             return false;
         }
         float* dstPixels = static_cast<float*>(dst.localpixels());
-        if (pyramid.size() >= 2u) {
-            if (!runFinalLevelToBuffer(dstPixels, pyramid[0], pyramid[1], nthreads)) {
+        if (composite) {
+            if (!runFinalLevelToBuffer(dstPixels, fine, coarse, nthreads)) {
                 dst.errorfmt("push-pull final kernel failed");
                 return false;
             }
         } else {
-            if (!runNormalizeLevelToBuffer(dstPixels, pyramid.front(), nthreads)) {
+            if (!runNormalizeLevelToBuffer(dstPixels, fine, nthreads)) {
                 dst.errorfmt("push-pull normalize kernel failed");
                 return false;
             }
         }
         return true;
-    } else if (src.spec().format == OIIO::TypeDesc::UINT16) {
-        if (!resetLocalResult(dst, src)) {
+    } else if (srcSpec.format == OIIO::TypeDesc::UINT16) {
+        if (!prepareResult(dst, outSpec, inPlace)) {
             return false;
         }
         uint16_t* dstPixels = static_cast<uint16_t*>(dst.localpixels());
-        if (pyramid.size() >= 2u) {
-            if (!runFinalLevelToU16Buffer(dstPixels, pyramid[0], pyramid[1], nthreads)) {
+        if (composite) {
+            if (!runFinalLevelToU16Buffer(dstPixels, fine, coarse, nthreads)) {
                 dst.errorfmt("push-pull final uint16 kernel failed");
                 return false;
             }
         } else {
-            if (!runNormalizeLevelToU16Buffer(dstPixels, pyramid.front(), nthreads)) {
+            if (!runNormalizeLevelToU16Buffer(dstPixels, fine, nthreads)) {
                 dst.errorfmt("push-pull normalize uint16 kernel failed");
                 return false;
             }
         }
         return true;
-    } else if (src.spec().format == OIIO::TypeDesc::HALF) {
-        if (!resetLocalResult(dst, src)) {
+    } else if (srcSpec.format == OIIO::TypeDesc::HALF) {
+        if (!prepareResult(dst, outSpec, inPlace)) {
             return false;
         }
         half* dstPixels = static_cast<half*>(dst.localpixels());
-        if (pyramid.size() >= 2u) {
-            if (!runFinalLevelToHalfBuffer(dstPixels, pyramid[0], pyramid[1], nthreads)) {
+        if (composite) {
+            if (!runFinalLevelToHalfBuffer(dstPixels, fine, coarse, nthreads)) {
                 dst.errorfmt("push-pull final half kernel failed");
                 return false;
             }
         } else {
-            if (!runNormalizeLevelToHalfBuffer(dstPixels, pyramid.front(), nthreads)) {
+            if (!runNormalizeLevelToHalfBuffer(dstPixels, fine, nthreads)) {
                 dst.errorfmt("push-pull normalize half kernel failed");
                 return false;
             }
         }
         return true;
     } else {
-        std::vector<float> normalized;
-        if (pyramid.size() >= 2u) {
-            if (!runFinalLevel(&normalized, pyramid[0], pyramid[1], nthreads)) {
+        ImageVector<float> normalized;
+        if (composite) {
+            if (!runFinalLevel(&normalized, fine, coarse, nthreads)) {
                 dst.errorfmt("push-pull final kernel failed");
                 return false;
             }
         } else {
-            if (!runNormalizeLevel(&normalized, pyramid.front(), nthreads)) {
+            if (!runNormalizeLevel(&normalized, fine, nthreads)) {
                 dst.errorfmt("push-pull normalize kernel failed");
                 return false;
             }
         }
-        return writeResult(dst, src, normalized);
+        return writeResult(dst, outSpec, normalized, inPlace);
+    }
+}
+
+bool
+applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const PushPullOptions& options)
+{
+    if (!validatePushPullSource(dst, src)) {
+        return false;
+    }
+    const OIIO::ROI region = fillRegion(src.spec(), options);
+    if (region.width() <= 0 || region.height() <= 0) {
+        dst.errorfmt("push-pull region does not overlap the source image");
+        return false;
+    }
+    // The top level is a float copy of the region and the source is not read again, so a full-resolution result
+    // with the source layout is written over the source's own pixels instead of a new buffer.
+    const bool inPlace = &dst == &src && canFillInPlace(src, region, options);
+    if (&dst == &src && !inPlace) {
+        OIIO::ImageBuf tmp;
+        const bool ok = applyPushPullFill(tmp, src, options);
+        dst           = std::move(tmp);
+        return ok;
+    }
+
+    if (options.normalMap && src.nchannels() != 4) {
+        dst.errorfmt("normal-map push-pull requires RGBA input");
+        return false;
+    }
+
+    std::vector<PushPullLevel> pyramid;
+    pyramid.reserve(32);
+    pyramid.emplace_back();
+
+    // Mostly empty canvases keep only the tiles holding data at full resolution.
+    PushPullSparseLevel sparseTop;
+    if (planSparseTopLevel(&sparseTop, src, region, options)) {
+        if (!readSparseTopLevel(&sparseTop, dst, src, region, options.nthreads)) {
+            return false;
+        }
+        pyramid.back().width    = sparseTop.width;
+        pyramid.back().height   = sparseTop.height;
+        pyramid.back().channels = sparseTop.channels;
+        return fillFromTopLevel(dst, src.spec(), region, options, pyramid, inPlace, &sparseTop);
+    }
+
+    const bool read = options.normalMap ? readTopLevelNormals(&pyramid.back(), dst, src, nullptr, region, false,
+                                                              options.normalInCenter, options.nthreads)
+                                        : readTopLevel(&pyramid.back(), dst, src, region);
+    if (!read) {
+        return false;
+    }
+    return fillFromTopLevel(dst, src.spec(), region, options, pyramid, inPlace);
+}
+
+bool
+packCoverageBits(const OIIO::ImageBuf& coverage, PushPullCoverageBits* bits, const int nthreads)
+{
+    if (bits == nullptr) {
+        return false;
+    }
+    *bits = {};
+    if (!coverage.initialized() || coverage.nchannels() != 1 || coverage.spec().depth != 1) {
+        return false;
+    }
+
+    const OIIO::ROI roi = coverage.roi();
+    PushPullCoverageBits packed;
+    packed.x           = roi.xbegin;
+    packed.y           = roi.ybegin;
+    packed.width       = roi.width();
+    packed.height      = roi.height();
+    packed.wordsPerRow = (static_cast<size_t>(packed.width) + 63u) / 64u;
+    packed.words.assign(packed.wordsPerRow * static_cast<size_t>(packed.height), 0u);
+
+    // Chunks span whole rows so no two threads write the same word.
+    std::atomic<bool> binary = true;
+    OIIO::ROI rows(0, 1, roi.ybegin, roi.yend, 0, 1, 0, 1);
+    OIIO::ImageBufAlgo::parallel_image(rows, nthreads, [&](OIIO::ROI chunk) {
+        std::vector<float> values(static_cast<size_t>(packed.width));
+        for (int y = chunk.ybegin; y < chunk.yend && binary.load(std::memory_order_relaxed); ++y) {
+            OIIO::ROI row(roi.xbegin, roi.xend, y, y + 1, roi.zbegin, roi.zend, 0, 1);
+            if (!coverage.get_pixels(row, OIIO::TypeDesc::FLOAT, values.data())) {
+                binary = false;
+                return;
+            }
+            uint64_t* words = packed.words.data() + static_cast<size_t>(y - roi.ybegin) * packed.wordsPerRow;
+            for (int x = 0; x < packed.width; ++x) {
+                const float v = values[static_cast<size_t>(x)];
+                if (v == 1.0f) {
+                    words[x / 64] |= uint64_t(1) << (x % 64);
+                } else if (v != 0.0f) {
+                    binary = false;
+                    return;
+                }
+            }
+        }
+    });
+    if (!binary.load()) {
+        return false;
+    }
+    *bits = std::move(packed);
+    return true;
+}
+
+// Fills color with the coverage plane, or with bits when coverage is null, once the caller has checked them.
+static bool
+fillWithCoverage(OIIO::ImageBuf& dst, const OIIO::ImageBuf& color, const OIIO::ImageBuf* coverage,
+                 const PushPullCoverageBits* bits, const PushPullOptions& options, const bool premultiply)
+{
+    OIIO::ROI region = fillRegion(color.spec(), options);
+    region.chend     = color.nchannels() + 1;
+    if (region.width() <= 0 || region.height() <= 0) {
+        dst.errorfmt("push-pull region does not overlap the source image");
+        return false;
+    }
+
+    // The result has the color channels plus the coverage as its alpha.
+    OIIO::ImageSpec srcSpec = color.spec();
+    srcSpec.channelformats.clear();
+    srcSpec.nchannels = color.nchannels() + 1;
+    srcSpec.channelnames.push_back("A");
+    srcSpec.alpha_channel = color.nchannels();
+
+    if (options.normalMap && color.nchannels() != 3) {
+        dst.errorfmt("normal-map push-pull requires RGB color");
+        return false;
+    }
+
+    std::vector<PushPullLevel> pyramid;
+    pyramid.reserve(32);
+    pyramid.emplace_back();
+    const bool read = options.normalMap
+                          ? readTopLevelNormals(&pyramid.back(), dst, color, coverage, region, premultiply,
+                                                options.normalInCenter, options.nthreads)
+                          : readTopLevelWithCoverage(&pyramid.back(), dst, color, coverage, bits, region,
+                                                     premultiply, options.nthreads);
+    if (!read) {
+        return false;
+    }
+    return fillFromTopLevel(dst, srcSpec, region, options, pyramid, false);
+}
+
+bool
+applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& color, const OIIO::ImageBuf& coverage,
+                  const PushPullOptions& options, const bool premultiply)
+{
+    if (!color.initialized() || !coverage.initialized()) {
+        dst.errorfmt("push-pull color or coverage image is not initialized");
+        return false;
+    }
+    if (color.spec().depth != 1 || coverage.spec().depth != 1) {
+        dst.errorfmt("push-pull does not support volume images");
+        return false;
+    }
+    if ((color.nchannels() != 1 && color.nchannels() != 3) || coverage.nchannels() != 1) {
+        dst.errorfmt("push-pull requires grayscale or RGB color and a one-channel coverage plane");
+        return false;
+    }
+    if (&dst == &color || &dst == &coverage) {
+        OIIO::ImageBuf tmp;
+        const bool ok = applyPushPullFill(tmp, color, coverage, options, premultiply);
+        dst           = std::move(tmp);
+        return ok;
+    }
+    return fillWithCoverage(dst, color, &coverage, nullptr, options, premultiply);
+}
+
+bool
+applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& color, const PushPullCoverageBits& coverage,
+                  const PushPullOptions& options, const bool premultiply)
+{
+    if (!color.initialized()) {
+        dst.errorfmt("push-pull color image is not initialized");
+        return false;
+    }
+    if (color.spec().depth != 1) {
+        dst.errorfmt("push-pull does not support volume images");
+        return false;
+    }
+    if (color.nchannels() != 1 && color.nchannels() != 3) {
+        dst.errorfmt("push-pull requires grayscale or RGB color");
+        return false;
+    }
+    if (coverage.words.size() != coverage.wordsPerRow * static_cast<size_t>(std::max(0, coverage.height))
+        || coverage.wordsPerRow * 64u < static_cast<size_t>(std::max(0, coverage.width))) {
+        dst.errorfmt("push-pull coverage bits do not match their size");
+        return false;
+    }
+    if (options.normalMap) {
+        dst.errorfmt("normal-map push-pull requires a coverage plane");
+        return false;
+    }
+    if (&dst == &color) {
+        OIIO::ImageBuf tmp;
+        const bool ok = applyPushPullFill(tmp, color, coverage, options, premultiply);
+        dst           = std::move(tmp);
+        return ok;
+    }
+    return fillWithCoverage(dst, color, nullptr, &coverage, options, premultiply);
+}
+
+bool
+applyPushPullFillSamples(OIIO::ImageBuf& dst, const std::vector<PushPullSample>& samples, const int width,
+                         const int height, const int channels, const PushPullOptions& options)
+{
+    if (width <= 0 || height <= 0) {
+        dst.errorfmt("push-pull sample target has no pixels");
+        return false;
+    }
+    if (channels != 1 && channels != 3) {
+        dst.errorfmt("push-pull samples must be grayscale or RGB");
+        return false;
+    }
+    if (options.normalMap) {
+        dst.errorfmt("normal-map push-pull does not take scattered samples");
+        return false;
+    }
+
+    OIIO::ImageSpec srcSpec(width, height, channels + 1, OIIO::TypeDesc::FLOAT);
+    srcSpec.channelnames  = channels == 1 ? std::vector<std::string> { "Y", "A" }
+                                          : std::vector<std::string> { "R", "G", "B", "A" };
+    srcSpec.alpha_channel = channels;
+
+    // The samples go into the finest level, no finer than the result level, with kPushPullSampleLevelDensity
+    // samples per pixel. The levels above it only carry their size and take the upsampled level below them.
+    // Dilation has no level below to take them from and puts the samples into the result level.
+    std::vector<PushPullLevel> pyramid;
+    pyramid.reserve(32);
+    int levelWidth  = width;
+    int levelHeight = height;
+    for (;;) {
+        PushPullLevel& level = pyramid.emplace_back();
+        level.width          = levelWidth;
+        level.height         = levelHeight;
+        level.channels       = channels + 1;
+        const bool dense     = options.engine == FillEngine::Dilate
+                               || static_cast<double>(levelWidth) * levelHeight * kPushPullSampleLevelDensity
+                                      <= static_cast<double>(samples.size());
+        if ((levelWidth == 1 && levelHeight == 1) || (dense && static_cast<int>(pyramid.size()) > options.level)) {
+            break;
+        }
+        levelWidth  = std::max(1, levelWidth / 2);
+        levelHeight = std::max(1, levelHeight / 2);
+    }
+
+    PushPullLevel& sampleLevel = pyramid.back();
+    resetLevelZeroed(&sampleLevel, sampleLevel.width, sampleLevel.height, sampleLevel.channels, options.nthreads);
+    accumulateSamples(&sampleLevel, samples, width, height, options.nthreads);
+    return fillFromTopLevel(dst, srcSpec, OIIO::ROI(0, width, 0, height, 0, 1, 0, channels + 1), options, pyramid,
+                            false);
+}
+
+bool
+applyPushPullFillBanded(const PushPullBandSource& source, const PushPullBandSink& sink, const int nthreads,
+                        std::string* error)
+{
+    if (source.width <= 0 || source.height <= 0) {
+        return setBandedError(error, "push-pull band source has no pixels");
+    }
+    if (source.channels != 2 && source.channels != 4) {
+        return setBandedError(error, "push-pull requires grayscale+alpha or RGBA input");
     }
+    if (!source.readRows || !sink.writeRows) {
+        return setBandedError(error, "push-pull band source and sink need row callbacks");
+    }
+    if (!runBandedLevel(source, sink.writeRows, true, std::max(2, sink.bandHeight), sink.residentBytes, nthreads)) {
+        return setBandedError(error, "push-pull banded fill failed");
+    }
+    return true;
 }
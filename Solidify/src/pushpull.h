@@ -20,5 +20,136 @@
 
 #include <OpenImageIO/imagebuf.h>
 
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// How the holes are filled. PushPull composites each pyramid level over the upsampled level below it. Membrane
+// solves Laplace's equation over the holes with the known pixels held fixed, a smooth harmonic fill without the
+// blocky gradients of push-pull in large holes, for a few times the cost: a multigrid solve on the pulled pyramid
+// with a fixed number of red-black Gauss-Seidel sweeps and V-cycles. Dilate gives every hole pixel the color of the
+// nearest covered pixel, the edge padding texture packers expect, found by jump flooding in log2 of the image size
+// passes; it does not pull the pyramid below the result level unless mipLevels are requested.
+enum class FillEngine { PushPull, Membrane, Dilate };
+
+// Region and threading for applyPushPullFill. roi defaults to the source data window; margin grows it on every
+// side, clamped to the union of the data and display windows, and a negative margin fills the whole display window.
+// Pixels of the region outside the source data window are read as holes. dst keeps the source display window and
+// gets the region as its data window, so nothing outside it is allocated or filled.
+// level > 0 returns the result at that pyramid level instead, each level half the size of the one above: the push
+// stops there and the final pass runs at that resolution, with the data and display windows scaled to match.
+// mipLevels, when set, receives the filled pyramid below the result level as float images down to 1x1,
+// unpremultiplied like the result. They match the MIP chain OIIO expects for a region that starts at the origin.
+// normalMap fills RGBA or RGB-plus-coverage input as normal vectors centered on normalInCenter: they are read into
+// a two-channel octahedral encoding plus alpha, filled, and written back as unit vectors scaled by normalScale
+// around normalOutCenter, the mapping of ImageBufAlgo::normalize. Zero-length vectors come back as +Z.
+struct PushPullOptions {
+    OIIO::ROI roi;
+    int margin                             = 0;
+    int level                              = 0;
+    int nthreads                           = 0;
+    std::vector<OIIO::ImageBuf>* mipLevels = nullptr;
+    bool normalMap                         = false;
+    float normalInCenter                   = 0.5f;
+    float normalOutCenter                  = 0.5f;
+    float normalScale                      = 0.5f;
+    // false always reads the top level dense, even for a mostly empty region.
+    bool sparseTopLevel = true;
+    FillEngine engine   = FillEngine::PushPull;
+    // Dilate only: pixels farther than dilateRadius result-level pixels from coverage stay empty, with zero color and
+    // alpha, and 0 fills every hole. distance, when set, receives the distance in pixels from every result pixel to
+    // the nearest covered one as a one-channel float image with the result's windows, 0 on coverage and -1 where
+    // nothing was found within the radius.
+    int dilateRadius         = 0;
+    OIIO::ImageBuf* distance = nullptr;
+};
+
+// Region applyPushPullFill fills for a source with spec: its data window, or options.roi, grown by the margin and
+// clamped to the union of the data and display windows. A full-resolution result takes it as its data window.
+OIIO::ROI
+pushPullFillRegion(const OIIO::ImageSpec& spec, const PushPullOptions& options);
+
+// Halves the first channel of src into a one-channel float dst of max(1, width / 2) x max(1, height / 2) with the
+// filter of one pull level, so it matches the coverage of the corresponding push-pull pyramid level.
+bool
+pushPullPullPlane(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, int nthreads = 0);
+
 bool
 applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, int nthreads = 0);
+// dst may be src. A level 0 fill of the source data window is then written over the source's own pixels, without
+// allocating a second full-resolution image; other fills replace src with a new result.
+bool
+applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& src, const PushPullOptions& options);
+// Fills grayscale or RGB color whose coverage is the separate one-channel plane coverage, for external masks.
+// Coverage becomes the last channel of dst and, when premultiply is set, color is multiplied by it while the top
+// pyramid level is read; no RGBA copy of the source is built.
+bool
+applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& color, const OIIO::ImageBuf& coverage,
+                  const PushPullOptions& options, bool premultiply);
+
+// Coverage that is strictly 0 or 1, one bit per pixel: column x of row y is bit (x - this->x) % 64 of word
+// (x - this->x) / 64 among the wordsPerRow words of row y - this->y. Pixels outside width x height are uncovered.
+struct PushPullCoverageBits {
+    int x              = 0;
+    int y              = 0;
+    int width          = 0;
+    int height         = 0;
+    size_t wordsPerRow = 0;
+    std::vector<uint64_t> words;
+};
+
+// Packs the one-channel coverage plane into bits. False, leaving bits empty, when a pixel is neither 0 nor 1.
+bool
+packCoverageBits(const OIIO::ImageBuf& coverage, PushPullCoverageBits* bits, int nthreads = 0);
+// The coverage plane fill with binary coverage taken from bits. The top level is read 64 pixels at a time: runs that
+// popcount finds fully covered only get their coverage set, empty runs are cleared with one fill when premultiplied,
+// and only mixed runs test pixels one by one.
+bool
+applyPushPullFill(OIIO::ImageBuf& dst, const OIIO::ImageBuf& color, const PushPullCoverageBits& coverage,
+                  const PushPullOptions& options, bool premultiply);
+
+// A scattered sample for applyPushPullFillSamples: a position in pixels of the target, where pixel (i, j) spans
+// [i, i + 1) x [j, j + 1), a straight color, of which grayscale uses the first channel, and a weight. Samples
+// landing in one pixel are averaged by weight, and a pixel whose weights sum below 1 is partly filled from around it.
+struct PushPullSample {
+    float x        = 0.0f;
+    float y        = 0.0f;
+    float color[3] = {};
+    float weight   = 1.0f;
+};
+
+// Fills a width x height float image of 1 or 3 color channels plus alpha from scattered samples, without a dense
+// top level. The samples are accumulated straight into the finest pyramid level they cover at about one sample per
+// four pixels, that level is pulled and pushed as usual, and the finer levels are upsampled from it. options.level,
+// mipLevels and nthreads apply; samples outside the target and non-positive weights are skipped.
+bool
+applyPushPullFillSamples(OIIO::ImageBuf& dst, const std::vector<PushPullSample>& samples, int width, int height,
+                         int channels, const PushPullOptions& options);
+
+// Row-band source for applyPushPullFillBanded. readRows fills rows [ybegin, yend) of the
+// full-resolution image as interleaved premultiplied float pixels with alpha in the last channel.
+struct PushPullBandSource {
+    int width    = 0;
+    int height   = 0;
+    int channels = 0;
+    std::function<bool(int ybegin, int yend, float* pixels)> readRows;
+};
+
+// Row-band sink for applyPushPullFillBanded. writeRows receives filled, unpremultiplied float
+// rows [ybegin, yend) with alpha set to 1 wherever coverage was found. Pyramid levels of at most
+// residentBytes are held in memory; larger ones are streamed.
+struct PushPullBandSink {
+    int bandHeight       = 64;
+    size_t residentBytes = size_t(256) << 20;
+    std::function<bool(int ybegin, int yend, const float* pixels)> writeRows;
+};
+
+// Push-pull fill that holds no pyramid level larger than sink.residentBytes. Each larger level is
+// pulled from the one above in row bands, as its rows are needed, and composited a band at a time
+// once the filled coarse rows under the band are in. Peak memory is the first level that fits the
+// budget with its coarser levels, under twice residentBytes, plus a few bands per streamed level.
+// The source is read once, plus once per streamed level.
+bool
+applyPushPullFillBanded(const PushPullBandSource& source, const PushPullBandSink& sink, int nthreads = 0,
+                        std::string* error = nullptr);
@@ -29,6 +29,7 @@
 #    include <cmath>
 #    include <cstddef>
 #    include <cstdint>
+#    include <type_traits>
 
 HWY_BEFORE_NAMESPACE();
 namespace solidify_pushpull_hwy {
@@ -79,20 +80,43 @@ namespace HWY_NAMESPACE {
             return half(value);
         }
 
+        // A pixel of Channels floats in one vector. Octahedral normal pixels (u, v, alpha) have no power-of-two
+        // width, so they ride in four lanes and load and store only the three they own.
+        template<int Channels> using PixelTag = hn::FixedTag<float, Channels == 3 ? 4 : Channels>;
+
+        template<int Channels>
+        HWY_ATTR hn::VFromD<PixelTag<Channels>> loadPixel(const PixelTag<Channels> d, const float* src)
+        {
+            if constexpr (Channels == 3) {
+                return hn::LoadN(d, src, 3);
+            } else {
+                return hn::Load(d, src);
+            }
+        }
+
         template<int Channels>
-        HWY_ATTR hn::VFromD<hn::FixedTag<float, Channels>>
-        normalizePulledPixelFixed(const hn::FixedTag<float, Channels> d,
-                                  const hn::VFromD<hn::FixedTag<float, Channels>> v)
+        HWY_ATTR void storePixel(const PixelTag<Channels> d, const hn::VFromD<PixelTag<Channels>> v, float* dst)
+        {
+            if constexpr (Channels == 3) {
+                hn::StoreN(v, d, dst, 3);
+            } else {
+                hn::Store(v, d, dst);
+            }
+        }
+
+        template<int Channels>
+        HWY_ATTR hn::VFromD<PixelTag<Channels>> normalizePulledPixelFixed(const PixelTag<Channels> d,
+                                                                          const hn::VFromD<PixelTag<Channels>> v)
         {
             float tmp[Channels];
-            hn::Store(v, d, tmp);
+            storePixel<Channels>(d, v, tmp);
             const float alpha = tmp[Channels - 1];
             if (alpha != 0.0f) {
                 const float invAlpha = 1.0f / alpha;
                 for (int c = 0; c < Channels; ++c) {
                     tmp[c] *= invAlpha;
                 }
-                return hn::Load(d, tmp);
+                return loadPixel<Channels>(d, tmp);
             }
             return v;
         }
@@ -107,16 +131,16 @@ namespace HWY_NAMESPACE {
 
         template<int Channels> HWY_ATTR void pullRowsFixed(const PushPullPullView* view)
         {
-            const hn::FixedTag<float, Channels> d;
+            const PixelTag<Channels> d;
             using V      = hn::VFromD<decltype(d)>;
             const V zero = hn::Zero(d);
 
             for (int y = view->yBegin; y < view->yEnd; ++y) {
                 float* dstRow = view->dst
-                                + static_cast<size_t>(y) * static_cast<size_t>(view->dstWidth)
+                                + static_cast<size_t>(y - view->dstYOffset) * static_cast<size_t>(view->dstWidth)
                                       * static_cast<size_t>(Channels);
                 const PushPullTriangleWeights& yw = view->yWeights[y];
-                for (int x = 0; x < view->dstWidth; ++x) {
+                for (int x = view->xBegin; x < view->xEnd; ++x) {
                     const PushPullTriangleWeights& xw = view->xWeights[x];
                     V sum                             = zero;
                     for (int dy = 0; dy < yw.taps; ++dy) {
@@ -130,25 +154,25 @@ namespace HWY_NAMESPACE {
                                 continue;
                             }
                             const float* srcPixel = view->src
-                                                    + (static_cast<size_t>(yw.indices[dy])
+                                                    + (static_cast<size_t>(yw.indices[dy] - view->srcYOffset)
                                                            * static_cast<size_t>(view->srcWidth)
                                                        + static_cast<size_t>(xw.indices[dx]))
                                                           * static_cast<size_t>(Channels);
-                            sum = hn::MulAdd(hn::Load(d, srcPixel), hn::Set(d, weight), sum);
+                            sum = hn::MulAdd(loadPixel<Channels>(d, srcPixel), hn::Set(d, weight), sum);
                         }
                     }
                     const V out = normalizePulledPixelFixed<Channels>(d, sum);
-                    hn::Store(out, d, dstRow + static_cast<size_t>(x) * Channels);
+                    storePixel<Channels>(d, out, dstRow + static_cast<size_t>(x) * Channels);
                 }
             }
         }
 
         template<int Channels>
-        HWY_ATTR hn::VFromD<hn::FixedTag<float, Channels>>
-        loadExact2xRowFixed(const hn::FixedTag<float, Channels> d, const float* src, const int srcWidth, const int y,
+        HWY_ATTR hn::VFromD<PixelTag<Channels>>
+        loadExact2xRowFixed(const PixelTag<Channels> d, const float* src, const int srcWidth, const int y,
                             const int x0, const int x1, const int x2, const int x3)
         {
-            using V         = hn::VFromD<hn::FixedTag<float, Channels>>;
+            using V         = hn::VFromD<PixelTag<Channels>>;
             const V three   = hn::Set(d, 3.0f);
             const float* p0 = src
                               + (static_cast<size_t>(y) * static_cast<size_t>(srcWidth) + static_cast<size_t>(x0))
@@ -162,19 +186,18 @@ namespace HWY_NAMESPACE {
             const float* p3 = src
                               + (static_cast<size_t>(y) * static_cast<size_t>(srcWidth) + static_cast<size_t>(x3))
                                     * static_cast<size_t>(Channels);
-            V sum = hn::Load(d, p0);
-            sum   = hn::MulAdd(hn::Load(d, p1), three, sum);
-            sum   = hn::MulAdd(hn::Load(d, p2), three, sum);
-            return hn::Add(sum, hn::Load(d, p3));
+            V sum = loadPixel<Channels>(d, p0);
+            sum   = hn::MulAdd(loadPixel<Channels>(d, p1), three, sum);
+            sum   = hn::MulAdd(loadPixel<Channels>(d, p2), three, sum);
+            return hn::Add(sum, loadPixel<Channels>(d, p3));
         }
 
         template<int Channels>
-        HWY_ATTR hn::VFromD<hn::FixedTag<float, Channels>>
-        sampleExact2xFixed(const PushPullPullView* view, const hn::FixedTag<float, Channels> d, const int sy0,
-                           const int sy1, const int sy2, const int sy3, const int sx0, const int sx1, const int sx2,
-                           const int sx3)
+        HWY_ATTR hn::VFromD<PixelTag<Channels>>
+        sampleExact2xFixed(const PushPullPullView* view, const PixelTag<Channels> d, const int sy0, const int sy1,
+                           const int sy2, const int sy3, const int sx0, const int sx1, const int sx2, const int sx3)
         {
-            using V       = hn::VFromD<hn::FixedTag<float, Channels>>;
+            using V       = hn::VFromD<PixelTag<Channels>>;
             const V three = hn::Set(d, 3.0f);
             const V inv64 = hn::Set(d, 1.0f / 64.0f);
             const V row0  = loadExact2xRowFixed<Channels>(d, view->src, view->srcWidth, sy0, sx0, sx1, sx2, sx3);
@@ -189,46 +212,51 @@ namespace HWY_NAMESPACE {
         }
 
         template<int Channels>
-        HWY_ATTR void storeExact2xPixelFixed(const PushPullPullView* view, const hn::FixedTag<float, Channels> d,
-                                             float* dstRow, const int x, const int sy0, const int sy1, const int sy2,
-                                             const int sy3, const int sx0, const int sx1, const int sx2, const int sx3)
+        HWY_ATTR void storeExact2xPixelFixed(const PushPullPullView* view, const PixelTag<Channels> d, float* dstRow,
+                                             const int x, const int sy0, const int sy1, const int sy2, const int sy3,
+                                             const int sx0, const int sx1, const int sx2, const int sx3)
         {
-            const hn::VFromD<hn::FixedTag<float, Channels>> out = sampleExact2xFixed<Channels>(view, d, sy0, sy1, sy2,
-                                                                                               sy3, sx0, sx1, sx2, sx3);
-            hn::Store(out, d, dstRow + static_cast<size_t>(x) * static_cast<size_t>(Channels));
+            const hn::VFromD<PixelTag<Channels>> out = sampleExact2xFixed<Channels>(view, d, sy0, sy1, sy2, sy3, sx0,
+                                                                                    sx1, sx2, sx3);
+            storePixel<Channels>(d, out, dstRow + static_cast<size_t>(x) * static_cast<size_t>(Channels));
         }
 
         template<int Channels> HWY_ATTR void pullRowsExact2xFixed(const PushPullPullView* view)
         {
-            const hn::FixedTag<float, Channels> d;
+            const PixelTag<Channels> d;
             const int srcXMax = view->srcWidth - 1;
             const int srcYMax = view->srcHeight - 1;
 
             for (int y = view->yBegin; y < view->yEnd; ++y) {
                 float* dstRow = view->dst
-                                + static_cast<size_t>(y) * static_cast<size_t>(view->dstWidth)
+                                + static_cast<size_t>(y - view->dstYOffset) * static_cast<size_t>(view->dstWidth)
                                       * static_cast<size_t>(Channels);
                 const int srcY = y * 2;
-                const int sy0  = clampIndex(srcY - 1, srcYMax);
-                const int sy1  = srcY;
-                const int sy2  = srcY + 1;
-                const int sy3  = clampIndex(srcY + 2, srcYMax);
-
-                if (view->dstWidth == 1) {
-                    storeExact2xPixelFixed<Channels>(view, d, dstRow, 0, sy0, sy1, sy2, sy3, 0, 0, srcXMax, srcXMax);
-                    continue;
+                const int sy0  = clampIndex(srcY - 1, srcYMax) - view->srcYOffset;
+                const int sy1  = srcY - view->srcYOffset;
+                const int sy2  = srcY + 1 - view->srcYOffset;
+                const int sy3  = clampIndex(srcY + 2, srcYMax) - view->srcYOffset;
+
+                // Only the first and last columns reach past the source edge.
+                const int lastX  = view->dstWidth - 1;
+                const int xBegin = view->xBegin;
+                const int xEnd   = view->xEnd;
+                int x            = xBegin;
+                if (x == 0 && x < xEnd) {
+                    storeExact2xPixelFixed<Channels>(view, d, dstRow, 0, sy0, sy1, sy2, sy3, 0, 0, std::min(1, srcXMax),
+                                                     std::min(2, srcXMax));
+                    ++x;
                 }
-
-                storeExact2xPixelFixed<Channels>(view, d, dstRow, 0, sy0, sy1, sy2, sy3, 0, 0, 1, 2);
-                for (int x = 1; x + 1 < view->dstWidth; ++x) {
+                for (; x < xEnd && x < lastX; ++x) {
                     const int sx0 = x * 2 - 1;
                     storeExact2xPixelFixed<Channels>(view, d, dstRow, x, sy0, sy1, sy2, sy3, sx0, sx0 + 1, sx0 + 2,
                                                      sx0 + 3);
                 }
-                const int lastX = view->dstWidth - 1;
-                const int srcX  = lastX * 2;
-                storeExact2xPixelFixed<Channels>(view, d, dstRow, lastX, sy0, sy1, sy2, sy3, srcX - 1, srcX, srcX + 1,
-                                                 srcXMax);
+                if (x == lastX && x < xEnd) {
+                    const int srcX = lastX * 2;
+                    storeExact2xPixelFixed<Channels>(view, d, dstRow, lastX, sy0, sy1, sy2, sy3, srcX - 1, srcX,
+                                                     srcX + 1, srcXMax);
+                }
             }
         }
 
@@ -612,34 +640,26 @@ namespace HWY_NAMESPACE {
         }
 
         template<int Channels>
-        HWY_ATTR hn::VFromD<hn::FixedTag<float, Channels>> sampleBilinear(const PushPullPushView* view,
-                                                                          const PushPullBilinearWeights& xw,
-                                                                          const PushPullBilinearWeights& yw)
+        HWY_ATTR hn::VFromD<PixelTag<Channels>> sampleBilinear(const PushPullPushView* view,
+                                                               const PushPullBilinearWeights& xw,
+                                                               const PushPullBilinearWeights& yw)
         {
-            const hn::FixedTag<float, Channels> d;
+            const PixelTag<Channels> d;
             using V = hn::VFromD<decltype(d)>;
 
-            const float* p00 = view->coarse
-                               + (static_cast<size_t>(yw.index0) * static_cast<size_t>(view->coarseWidth)
-                                  + static_cast<size_t>(xw.index0))
-                                     * static_cast<size_t>(Channels);
-            const float* p10 = view->coarse
-                               + (static_cast<size_t>(yw.index0) * static_cast<size_t>(view->coarseWidth)
-                                  + static_cast<size_t>(xw.index1))
-                                     * static_cast<size_t>(Channels);
-            const float* p01 = view->coarse
-                               + (static_cast<size_t>(yw.index1) * static_cast<size_t>(view->coarseWidth)
-                                  + static_cast<size_t>(xw.index0))
-                                     * static_cast<size_t>(Channels);
-            const float* p11 = view->coarse
-                               + (static_cast<size_t>(yw.index1) * static_cast<size_t>(view->coarseWidth)
-                                  + static_cast<size_t>(xw.index1))
-                                     * static_cast<size_t>(Channels);
-
-            const V v00    = hn::Load(d, p00);
-            const V v10    = hn::Load(d, p10);
-            const V v01    = hn::Load(d, p01);
-            const V v11    = hn::Load(d, p11);
+            const size_t row0 = static_cast<size_t>(yw.index0 - view->coarseYOffset)
+                                * static_cast<size_t>(view->coarseWidth);
+            const size_t row1 = static_cast<size_t>(yw.index1 - view->coarseYOffset)
+                                * static_cast<size_t>(view->coarseWidth);
+            const float* p00  = view->coarse + (row0 + static_cast<size_t>(xw.index0)) * static_cast<size_t>(Channels);
+            const float* p10  = view->coarse + (row0 + static_cast<size_t>(xw.index1)) * static_cast<size_t>(Channels);
+            const float* p01  = view->coarse + (row1 + static_cast<size_t>(xw.index0)) * static_cast<size_t>(Channels);
+            const float* p11  = view->coarse + (row1 + static_cast<size_t>(xw.index1)) * static_cast<size_t>(Channels);
+
+            const V v00    = loadPixel<Channels>(d, p00);
+            const V v10    = loadPixel<Channels>(d, p10);
+            const V v01    = loadPixel<Channels>(d, p01);
+            const V v11    = loadPixel<Channels>(d, p11);
             const V txv    = hn::Set(d, xw.t);
             const V tyv    = hn::Set(d, yw.t);
             const V top    = hn::MulAdd(hn::Sub(v10, v00), txv, v00);
@@ -649,25 +669,30 @@ namespace HWY_NAMESPACE {
 
         template<int Channels> HWY_ATTR void pushRowsFixed(const PushPullPushView* view)
         {
-            const hn::FixedTag<float, Channels> d;
+            const PixelTag<Channels> d;
             using V = hn::VFromD<decltype(d)>;
 
             for (int y = view->yBegin; y < view->yEnd; ++y) {
                 const PushPullBilinearWeights& yw = view->yWeights[y];
                 for (int x = view->xBegin; x < view->xEnd; ++x) {
-                    const size_t base = (static_cast<size_t>(y) * static_cast<size_t>(view->fineWidth)
+                    const size_t base = (static_cast<size_t>(y - view->rowOffset)
+                                             * static_cast<size_t>(view->fineWidth)
                                          + static_cast<size_t>(x))
                                         * static_cast<size_t>(Channels);
+                    float* dstPixel = view->dst + base;
+                    if (view->fine == nullptr) {
+                        storePixel<Channels>(d, sampleBilinear<Channels>(view, view->xWeights[x], yw), dstPixel);
+                        continue;
+                    }
                     const float* finePixel = view->fine + base;
-                    float* dstPixel        = view->dst + base;
                     const float alpha      = finePixel[Channels - 1];
                     if (alpha >= 1.0f - kPushPullAlphaEpsilon) {
-                        const V fine = hn::Load(d, finePixel);
-                        hn::Store(fine, d, dstPixel);
+                        const V fine = loadPixel<Channels>(d, finePixel);
+                        storePixel<Channels>(d, fine, dstPixel);
                         continue;
                     }
 
-                    const V fine   = hn::Load(d, finePixel);
+                    const V fine   = loadPixel<Channels>(d, finePixel);
                     const V coarse = sampleBilinear<Channels>(view, view->xWeights[x], yw);
                     float missing  = 1.0f - alpha;
                     if (missing < 0.0f) {
@@ -676,7 +701,7 @@ namespace HWY_NAMESPACE {
                         missing = 1.0f;
                     }
                     const V out = hn::MulAdd(coarse, hn::Set(d, missing), fine);
-                    hn::Store(out, d, dstPixel);
+                    storePixel<Channels>(d, out, dstPixel);
                 }
             }
         }
@@ -687,22 +712,24 @@ namespace HWY_NAMESPACE {
             using V = hn::VFromD<decltype(d)>;
 
             PushPullPushView coarseView;
-            coarseView.coarse       = view->coarse;
-            coarseView.xWeights     = view->xWeights;
-            coarseView.yWeights     = view->yWeights;
-            coarseView.coarseWidth  = view->coarseWidth;
-            coarseView.coarseHeight = view->coarseHeight;
-            coarseView.channels     = view->channels;
+            coarseView.coarse        = view->coarse;
+            coarseView.xWeights      = view->xWeights;
+            coarseView.yWeights      = view->yWeights;
+            coarseView.coarseWidth   = view->coarseWidth;
+            coarseView.coarseHeight  = view->coarseHeight;
+            coarseView.channels      = view->channels;
+            coarseView.coarseYOffset = view->coarseYOffset;
 
             for (int y = view->yBegin; y < view->yEnd; ++y) {
                 const PushPullBilinearWeights& yw = view->yWeights[y];
                 for (int x = view->xBegin; x < view->xEnd; ++x) {
-                    const size_t base = (static_cast<size_t>(y) * static_cast<size_t>(view->fineWidth)
+                    const size_t base = (static_cast<size_t>(y - view->rowOffset)
+                                             * static_cast<size_t>(view->fineWidth)
                                          + static_cast<size_t>(x))
                                         * static_cast<size_t>(Channels);
-                    const float* finePixel = view->fine + base;
+                    const float* finePixel = view->fine != nullptr ? view->fine + base : nullptr;
                     float* dstPixel        = view->dst + base;
-                    const float alpha      = finePixel[Channels - 1];
+                    const float alpha      = finePixel != nullptr ? finePixel[Channels - 1] : 0.0f;
                     if (alpha >= 1.0f - kPushPullAlphaEpsilon) {
                         for (int c = 0; c < Channels - 1; ++c) {
                             dstPixel[c] = finePixel[c];
@@ -711,7 +738,7 @@ namespace HWY_NAMESPACE {
                         continue;
                     }
 
-                    const V fine   = hn::Load(d, finePixel);
+                    const V fine   = finePixel != nullptr ? hn::Load(d, finePixel) : hn::Zero(d);
                     const V coarse = sampleBilinear<Channels>(&coarseView, view->xWeights[x], yw);
                     float missing  = 1.0f - alpha;
                     if (missing < 0.0f) {
@@ -1079,12 +1106,255 @@ namespace HWY_NAMESPACE {
             }
         }
 
+        // Octahedral (u, v) back to a unit vector.
+        HWY_ATTR void octahedralDecode(const float u, const float v, float n[3])
+        {
+            n[0] = u;
+            n[1] = v;
+            n[2] = 1.0f - std::fabs(u) - std::fabs(v);
+            if (n[2] < 0.0f) {
+                n[0] = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+                n[1] = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+            }
+            const float len    = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            const float invLen = len > 0.0f ? 1.0f / len : 0.0f;
+            n[0] *= invLen;
+            n[1] *= invLen;
+            n[2] *= invLen;
+        }
+
+        template<typename T> HWY_ATTR T storeNormalValue(const float value)
+        {
+            if constexpr (std::is_same_v<T, uint16_t>) {
+                return floatToU16(value);
+            } else if constexpr (std::is_same_v<T, half>) {
+                return floatToHalf(value);
+            } else {
+                return value;
+            }
+        }
+
+        // Composites a three-channel octahedral level over the coarser one like finalRowsFixed, then decodes the
+        // unpremultiplied (u, v) to a unit normal and writes it as RGB in the output range, with alpha 1 wherever
+        // coverage was found. Without a coarse level the fine level is only unpremultiplied and decoded.
+        template<typename T> HWY_ATTR void finalNormalRows(const PushPullFinalNormalView* view)
+        {
+            const PixelTag<3> d;
+            using V = hn::VFromD<decltype(d)>;
+
+            PushPullPushView coarseView;
+            coarseView.coarse       = view->coarse;
+            coarseView.coarseWidth  = view->coarseWidth;
+            coarseView.coarseHeight = view->coarseHeight;
+            coarseView.channels     = 3;
+
+            T* dst = static_cast<T*>(view->dst);
+            for (int y = view->yBegin; y < view->yEnd; ++y) {
+                for (int x = view->xBegin; x < view->xEnd; ++x) {
+                    const size_t index = static_cast<size_t>(y) * static_cast<size_t>(view->fineWidth)
+                                         + static_cast<size_t>(x);
+                    const float* finePixel = view->fine + index * 3u;
+                    T* dstPixel            = dst + index * 4u;
+                    const float alpha      = finePixel[2];
+
+                    float pixel[3] = { finePixel[0], finePixel[1], alpha };
+                    float outAlpha = 1.0f;
+                    if (view->coarse == nullptr || alpha < 1.0f - kPushPullAlphaEpsilon) {
+                        if (view->coarse != nullptr) {
+                            const V coarse      = sampleBilinear<3>(&coarseView, view->xWeights[x], view->yWeights[y]);
+                            const float missing = std::clamp(1.0f - alpha, 0.0f, 1.0f);
+                            storePixel<3>(d, hn::MulAdd(coarse, hn::Set(d, missing), loadPixel<3>(d, finePixel)),
+                                          pixel);
+                        }
+                        const float invAlpha = pixel[2] > kPushPullAlphaEpsilon ? 1.0f / pixel[2] : 0.0f;
+                        pixel[0] *= invAlpha;
+                        pixel[1] *= invAlpha;
+                        outAlpha = pixel[2] > kPushPullAlphaEpsilon ? 1.0f : 0.0f;
+                    }
+
+                    float n[3] = { 0.0f, 0.0f, 0.0f };
+                    if (outAlpha > 0.0f) {
+                        octahedralDecode(pixel[0], pixel[1], n);
+                    }
+                    for (int c = 0; c < 3; ++c) {
+                        dstPixel[c] = storeNormalValue<T>(n[c] * view->scale + view->outCenter);
+                    }
+                    dstPixel[3] = storeNormalValue<T>(outAlpha);
+                }
+            }
+        }
+
+        // Sum of the in-image four-neighbours of pixel (x, y) of a width x height field, their count in count.
+        template<int Channels>
+        HWY_ATTR hn::VFromD<PixelTag<Channels>> neighbourSum(const PixelTag<Channels> d, const float* u,
+                                                             const int width, const int height, const int x,
+                                                             const int y, int* count)
+        {
+            using V = hn::VFromD<PixelTag<Channels>>;
+
+            const size_t stride = static_cast<size_t>(width) * static_cast<size_t>(Channels);
+            const float* center = u + (static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x))
+                                          * static_cast<size_t>(Channels);
+            V sum = hn::Zero(d);
+            int n = 0;
+            if (x > 0) {
+                sum = hn::Add(sum, loadPixel<Channels>(d, center - Channels));
+                ++n;
+            }
+            if (x + 1 < width) {
+                sum = hn::Add(sum, loadPixel<Channels>(d, center + Channels));
+                ++n;
+            }
+            if (y > 0) {
+                sum = hn::Add(sum, loadPixel<Channels>(d, center - stride));
+                ++n;
+            }
+            if (y + 1 < height) {
+                sum = hn::Add(sum, loadPixel<Channels>(d, center + stride));
+                ++n;
+            }
+            *count = n;
+            return sum;
+        }
+
+        template<int Channels> HWY_ATTR void smoothRowsFixed(const PushPullSmoothView* view)
+        {
+            const PixelTag<Channels> d;
+            using V = hn::VFromD<decltype(d)>;
+
+            for (int y = view->yBegin; y < view->yEnd; ++y) {
+                for (int x = (y + view->parity) & 1; x < view->width; x += 2) {
+                    const size_t index = static_cast<size_t>(y) * static_cast<size_t>(view->width)
+                                         + static_cast<size_t>(x);
+                    if (view->fixed[index] != 0) {
+                        continue;
+                    }
+                    int count   = 0;
+                    const V sum = neighbourSum<Channels>(d, view->u, view->width, view->height, x, y, &count);
+                    if (count == 0) {
+                        continue;
+                    }
+                    const size_t base = index * static_cast<size_t>(Channels);
+                    const V rhs       = view->rhs != nullptr ? loadPixel<Channels>(d, view->rhs + base) : hn::Zero(d);
+                    const V out       = hn::Mul(hn::Add(sum, rhs), hn::Set(d, 1.0f / static_cast<float>(count)));
+                    storePixel<Channels>(d, out, view->u + base);
+                }
+            }
+        }
+
+        template<int Channels> HWY_ATTR void residualRowsFixed(const PushPullResidualView* view)
+        {
+            const PixelTag<Channels> d;
+            using V = hn::VFromD<decltype(d)>;
+
+            for (int y = view->yBegin; y < view->yEnd; ++y) {
+                float* dstRow = view->dst
+                                + static_cast<size_t>(y - view->yBegin) * static_cast<size_t>(view->width)
+                                      * static_cast<size_t>(Channels);
+                for (int x = 0; x < view->width; ++x) {
+                    const size_t index = static_cast<size_t>(y) * static_cast<size_t>(view->width)
+                                         + static_cast<size_t>(x);
+                    float* dstPixel = dstRow + static_cast<size_t>(x) * static_cast<size_t>(Channels);
+                    if (view->fixed[index] != 0) {
+                        storePixel<Channels>(d, hn::Zero(d), dstPixel);
+                        continue;
+                    }
+                    int count         = 0;
+                    const V sum       = neighbourSum<Channels>(d, view->u, view->width, view->height, x, y, &count);
+                    const size_t base = index * static_cast<size_t>(Channels);
+                    const V rhs       = view->rhs != nullptr ? loadPixel<Channels>(d, view->rhs + base) : hn::Zero(d);
+                    const V center    = loadPixel<Channels>(d, view->u + base);
+                    const V weight    = hn::Set(d, static_cast<float>(count));
+                    storePixel<Channels>(d, hn::NegMulAdd(center, weight, hn::Add(sum, rhs)), dstPixel);
+                }
+            }
+        }
+
+        HWY_ATTR float seedDistance(const float x, const float y, const float seedX, const float seedY)
+        {
+            const float dx = seedX - x;
+            const float dy = seedY - y;
+            return dx * dx + dy * dy;
+        }
+
+        // Offers row y the seeds of row candidateY shifted by offset pixels, keeping per pixel the closer seed.
+        HWY_ATTR void jumpFloodOffer(const PushPullJumpFloodView* view, const int y, const int candidateY,
+                                     const int offset)
+        {
+            const hn::ScalableTag<float> d;
+            using V         = hn::VFromD<decltype(d)>;
+            const int lanes = static_cast<int>(hn::Lanes(d));
+
+            const int width     = view->width;
+            const size_t row    = static_cast<size_t>(y) * static_cast<size_t>(width);
+            const size_t offers = static_cast<size_t>(candidateY) * static_cast<size_t>(width);
+            float* bestX        = view->dstX + row;
+            float* bestY        = view->dstY + row;
+            const float* offerX = view->srcX + offers;
+            const float* offerY = view->srcY + offers;
+            const int xBegin    = std::max(0, -offset);
+            const int xEnd      = std::min(width, width - offset);
+            const V yv          = hn::Set(d, static_cast<float>(y));
+            int x               = xBegin;
+            for (; x + lanes <= xEnd; x += lanes) {
+                const V xv        = hn::Iota(d, static_cast<float>(x));
+                const V bx        = hn::LoadU(d, bestX + x);
+                const V by        = hn::LoadU(d, bestY + x);
+                const V ox        = hn::LoadU(d, offerX + x + offset);
+                const V oy        = hn::LoadU(d, offerY + x + offset);
+                const V bdx       = hn::Sub(bx, xv);
+                const V bdy       = hn::Sub(by, yv);
+                const V odx       = hn::Sub(ox, xv);
+                const V ody       = hn::Sub(oy, yv);
+                const V best      = hn::MulAdd(bdx, bdx, hn::Mul(bdy, bdy));
+                const V offered   = hn::MulAdd(odx, odx, hn::Mul(ody, ody));
+                const auto closer = hn::Lt(offered, best);
+                hn::StoreU(hn::IfThenElse(closer, ox, bx), d, bestX + x);
+                hn::StoreU(hn::IfThenElse(closer, oy, by), d, bestY + x);
+            }
+            const float fy = static_cast<float>(y);
+            for (; x < xEnd; ++x) {
+                const float fx = static_cast<float>(x);
+                const float ox = offerX[x + offset];
+                const float oy = offerY[x + offset];
+                if (seedDistance(fx, fy, ox, oy) < seedDistance(fx, fy, bestX[x], bestY[x])) {
+                    bestX[x] = ox;
+                    bestY[x] = oy;
+                }
+            }
+        }
+
+        HWY_ATTR void jumpFloodRows(const PushPullJumpFloodView* view)
+        {
+            const size_t width = static_cast<size_t>(view->width);
+            for (int y = view->yBegin; y < view->yEnd; ++y) {
+                const size_t row = static_cast<size_t>(y) * width;
+                std::copy_n(view->srcX + row, width, view->dstX + row);
+                std::copy_n(view->srcY + row, width, view->dstY + row);
+                for (int dy = -1; dy <= 1; ++dy) {
+                    const int candidateY = y + dy * view->step;
+                    if (candidateY < 0 || candidateY >= view->height) {
+                        continue;
+                    }
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if (dx != 0 || dy != 0) {
+                            jumpFloodOffer(view, y, candidateY, dx * view->step);
+                        }
+                    }
+                }
+            }
+        }
+
         bool PushPullPullKernel(const PushPullPullView* view)
         {
             if (view->channels == 4) {
                 pullRowsFixed<4>(view);
                 return true;
             }
+            if (view->channels == 3) {
+                pullRowsFixed<3>(view);
+                return true;
+            }
             if (view->channels == 2) {
                 pullRowsFixed<2>(view);
                 return true;
@@ -1098,6 +1368,10 @@ namespace HWY_NAMESPACE {
                 pullRowsExact2xFixed<4>(view);
                 return true;
             }
+            if (view->channels == 3) {
+                pullRowsExact2xFixed<3>(view);
+                return true;
+            }
             if (view->channels == 2) {
                 pullRowsExact2xFixed<2>(view);
                 return true;
@@ -1150,6 +1424,10 @@ namespace HWY_NAMESPACE {
                 pushRowsFixed<4>(view);
                 return true;
             }
+            if (view->channels == 3) {
+                pushRowsFixed<3>(view);
+                return true;
+            }
             if (view->channels == 2) {
                 pushRowsFixed<2>(view);
                 return true;
@@ -1287,6 +1565,59 @@ namespace HWY_NAMESPACE {
             return false;
         }
 
+        bool PushPullFinalNormalKernel(const PushPullFinalNormalView* view)
+        {
+            switch (view->storage) {
+            case PushPullNormalStorage_F32: finalNormalRows<float>(view); return true;
+            case PushPullNormalStorage_U16: finalNormalRows<uint16_t>(view); return true;
+            case PushPullNormalStorage_F16: finalNormalRows<half>(view); return true;
+            default: return false;
+            }
+        }
+
+        bool PushPullSmoothKernel(const PushPullSmoothView* view)
+        {
+            if (view->channels == 4) {
+                smoothRowsFixed<4>(view);
+                return true;
+            }
+            if (view->channels == 3) {
+                smoothRowsFixed<3>(view);
+                return true;
+            }
+            if (view->channels == 2) {
+                smoothRowsFixed<2>(view);
+                return true;
+            }
+            return false;
+        }
+
+        bool PushPullJumpFloodKernel(const PushPullJumpFloodView* view)
+        {
+            if (view->step <= 0) {
+                return false;
+            }
+            jumpFloodRows(view);
+            return true;
+        }
+
+        bool PushPullResidualKernel(const PushPullResidualView* view)
+        {
+            if (view->channels == 4) {
+                residualRowsFixed<4>(view);
+                return true;
+            }
+            if (view->channels == 3) {
+                residualRowsFixed<3>(view);
+                return true;
+            }
+            if (view->channels == 2) {
+                residualRowsFixed<2>(view);
+                return true;
+            }
+            return false;
+        }
+
     }  // namespace
 }  // namespace HWY_NAMESPACE
 }  // namespace solidify_pushpull_hwy
@@ -165,6 +165,67 @@ get_codec_value(const toml::value& data, const std::string& section, const std::
     }
 }
 
+// Reads key from one [[Outputs]] table.
+template<typename T>
+static void
+get_target_value(const toml::value& table, const std::string& key, T& var)
+{
+    if (table.contains(key)) {
+        var = toml::find<T>(table, key);
+    }
+}
+
+static void
+get_target_codec_value(const toml::value& table, const std::string& key, int& var,
+                       int (*decode)(const std::string&, int))
+{
+    if (table.contains(key)) {
+        var = decode(toml::find<std::string>(table, key), var);
+    }
+}
+
+static void
+clampSettings(Settings& loaded)
+{
+    loaded.alphaMode           = std::clamp<uint>(loaded.alphaMode, 0, 2);
+    loaded.normMode            = std::clamp<uint>(loaded.normMode, 0, 2);
+    loaded.repairMode          = std::clamp<uint>(loaded.repairMode, 0, 6);
+    loaded.rangeMode           = std::clamp<uint>(loaded.rangeMode, 0, 3);
+    loaded.swapBasis           = std::clamp<uint>(loaded.swapBasis, 0, 5);
+    loaded.swapInvertMask      = std::clamp<uint>(loaded.swapInvertMask, 0, 7);
+    loaded.grayscaleMode       = std::clamp<uint>(loaded.grayscaleMode, 0, 7);
+    loaded.alphaGamma          = std::clamp(loaded.alphaGamma, 0.01f, 10.0f);
+    loaded.fillMargin          = std::clamp(loaded.fillMargin, -1, 65536);
+    loaded.fillEngine          = std::clamp(loaded.fillEngine, static_cast<int>(FillEngine_PushPull),
+                                            static_cast<int>(FillEngine_Dilate));
+    loaded.dilateRadius        = std::clamp(loaded.dilateRadius, 0, 65536);
+    loaded.defFormat           = std::clamp(loaded.defFormat, 0, 8);
+    loaded.fileFormat          = std::clamp(loaded.fileFormat, -1, 8);
+    loaded.defBDepth           = std::clamp(loaded.defBDepth, 0, 6);
+    loaded.bitDepth            = std::clamp(loaded.bitDepth, -1, 6);
+    loaded.outputScale         = std::clamp(loaded.outputScale, 0, 16);
+    loaded.verbosity           = std::clamp<uint>(loaded.verbosity, 0, 5);
+    loaded.tiffCompression     = std::clamp(loaded.tiffCompression, static_cast<int>(TiffCompression_Zip),
+                                            static_cast<int>(TiffCompression_None));
+    loaded.tiffZipLevel        = std::clamp(loaded.tiffZipLevel, 1, 9);
+    loaded.exrCompression      = std::clamp(loaded.exrCompression, static_cast<int>(ExrCompression_Zip),
+                                            static_cast<int>(ExrCompression_None));
+    loaded.exrZipLevel         = std::clamp(loaded.exrZipLevel, 1, 9);
+    loaded.exrDwaLevel         = std::clamp(loaded.exrDwaLevel, 1, 100);
+    loaded.pngStrategy         = std::clamp(loaded.pngStrategy, static_cast<int>(PngCompression_Default),
+                                            static_cast<int>(PngCompression_None));
+    loaded.pngCompressionLevel = std::clamp(loaded.pngCompressionLevel, 0, 9);
+    loaded.jpegQuality         = std::clamp(loaded.jpegQuality, 1, 100);
+    loaded.jpegSubsampling     = std::clamp(loaded.jpegSubsampling, static_cast<int>(JpegSubsampling_444),
+                                            static_cast<int>(JpegSubsampling_411));
+    loaded.jpeg2000QStep       = std::clamp(loaded.jpeg2000QStep, -1.0f, 10.0f);
+    loaded.heicQuality         = std::clamp(loaded.heicQuality, 1, 100);
+    loaded.jpegxlQuality       = std::clamp(loaded.jpegxlQuality, 1, 100);
+    loaded.jpegxlEffort        = std::clamp(loaded.jpegxlEffort, 1, 9);
+    loaded.jpegxlSpeed         = std::clamp(loaded.jpegxlSpeed, 0, 4);
+    loaded.cacheSizeMB         = std::clamp<uint>(loaded.cacheSizeMB, 64, 262144);
+}
+
 bool
 loadSettings(Settings& outSettings, const std::string& filename)
 {
@@ -179,8 +240,13 @@ loadSettings(Settings& outSettings, const std::string& filename)
         get_value(data, "Global", "Console", loaded.conEnable);
         get_value(data, "Global", "Threads", loaded.numThreads);
         get_value(data, "Global", "QueueLimit", loaded.queueLimit);
+        get_value(data, "Global", "Incremental", loaded.incremental);
         get_value(data, "Global", "Verbosity", loaded.verbosity);
         get_value(data, "Global", "AlphaGamma", loaded.alphaGamma);
+        get_value(data, "Global", "FillMargin", loaded.fillMargin);
+        get_value(data, "Global", "FillEngine", loaded.fillEngine);
+        get_value(data, "Global", "DilateRadius", loaded.dilateRadius);
+        get_value(data, "Global", "DilateDistance", loaded.dilateDistance);
 
         if (data.contains("Global") && data.at("Global").contains("MaskNames")) {
             std::vector<std::string> values = toml::find<std::vector<std::string>>(data, "Global", "MaskNames");
@@ -215,6 +281,9 @@ loadSettings(Settings& outSettings, const std::string& filename)
         get_value(data, "Export", "FileFormat", loaded.fileFormat);
         get_value(data, "Export", "DefaultBit", loaded.defBDepth);
         get_value(data, "Export", "BitDepth", loaded.bitDepth);
+        get_value(data, "Export", "OutputScale", loaded.outputScale);
+        get_value(data, "Export", "MipMap", loaded.mipmapOutput);
+        get_value(data, "Export", "MipFilter", loaded.mipFilter);
 
         get_codec_value(data, "Encoding", "TiffCompression", loaded.tiffCompression, tiffCompressionFromString);
         get_value(data, "Encoding", "TiffZipLevel", loaded.tiffZipLevel);
@@ -233,37 +302,43 @@ loadSettings(Settings& outSettings, const std::string& filename)
 
         get_value(data, "CameraRaw", "RawRotation", loaded.rawRot);
 
-        loaded.alphaMode           = std::clamp<uint>(loaded.alphaMode, 0, 2);
-        loaded.normMode            = std::clamp<uint>(loaded.normMode, 0, 2);
-        loaded.repairMode          = std::clamp<uint>(loaded.repairMode, 0, 6);
-        loaded.rangeMode           = std::clamp<uint>(loaded.rangeMode, 0, 3);
-        loaded.swapBasis           = std::clamp<uint>(loaded.swapBasis, 0, 5);
-        loaded.swapInvertMask      = std::clamp<uint>(loaded.swapInvertMask, 0, 7);
-        loaded.grayscaleMode       = std::clamp<uint>(loaded.grayscaleMode, 0, 7);
-        loaded.alphaGamma          = std::clamp(loaded.alphaGamma, 0.01f, 10.0f);
-        loaded.defFormat           = std::clamp(loaded.defFormat, 0, 8);
-        loaded.fileFormat          = std::clamp(loaded.fileFormat, -1, 8);
-        loaded.defBDepth           = std::clamp(loaded.defBDepth, 0, 6);
-        loaded.bitDepth            = std::clamp(loaded.bitDepth, -1, 6);
-        loaded.verbosity           = std::clamp<uint>(loaded.verbosity, 0, 5);
-        loaded.tiffCompression     = std::clamp(loaded.tiffCompression, static_cast<int>(TiffCompression_Zip),
-                                                static_cast<int>(TiffCompression_None));
-        loaded.tiffZipLevel        = std::clamp(loaded.tiffZipLevel, 1, 9);
-        loaded.exrCompression      = std::clamp(loaded.exrCompression, static_cast<int>(ExrCompression_Zip),
-                                                static_cast<int>(ExrCompression_None));
-        loaded.exrZipLevel         = std::clamp(loaded.exrZipLevel, 1, 9);
-        loaded.exrDwaLevel         = std::clamp(loaded.exrDwaLevel, 1, 100);
-        loaded.pngStrategy         = std::clamp(loaded.pngStrategy, static_cast<int>(PngCompression_Default),
-                                                static_cast<int>(PngCompression_None));
-        loaded.pngCompressionLevel = std::clamp(loaded.pngCompressionLevel, 0, 9);
-        loaded.jpegQuality         = std::clamp(loaded.jpegQuality, 1, 100);
-        loaded.jpegSubsampling     = std::clamp(loaded.jpegSubsampling, static_cast<int>(JpegSubsampling_444),
-                                                static_cast<int>(JpegSubsampling_411));
-        loaded.jpeg2000QStep       = std::clamp(loaded.jpeg2000QStep, -1.0f, 10.0f);
-        loaded.heicQuality         = std::clamp(loaded.heicQuality, 1, 100);
-        loaded.jpegxlQuality       = std::clamp(loaded.jpegxlQuality, 1, 100);
-        loaded.jpegxlEffort        = std::clamp(loaded.jpegxlEffort, 1, 9);
-        loaded.jpegxlSpeed         = std::clamp(loaded.jpegxlSpeed, 0, 4);
+        get_value(data, "Memory", "OutOfCore", loaded.outOfCore);
+        get_value(data, "Memory", "CacheSizeMB", loaded.cacheSizeMB);
+        get_value(data, "Memory", "ZeroCopy", loaded.zeroCopy);
+
+        clampSettings(loaded);
+
+        // Each [[Outputs]] table is a fan-out target: the settings above with its own keys on top.
+        if (data.contains("Outputs")) {
+            for (const toml::value& table : toml::find<std::vector<toml::value>>(data, "Outputs")) {
+                Settings target = loaded;
+                target.outputs.clear();
+                get_target_value(table, "Suffix", target.outSuffix);
+                get_target_value(table, "FileFormat", target.fileFormat);
+                get_target_value(table, "BitDepth", target.bitDepth);
+                get_target_value(table, "ExportAlpha", target.alphaMode);
+                get_target_value(table, "NormalizeMode", target.normMode);
+                get_target_value(table, "RangeMode", target.rangeMode);
+                get_target_value(table, "SwapBasis", target.swapBasis);
+                get_target_value(table, "SwapInvertMask", target.swapInvertMask);
+                get_target_value(table, "GrayscaleMode", target.grayscaleMode);
+                get_target_value(table, "MipMap", target.mipmapOutput);
+                get_target_value(table, "MipFilter", target.mipFilter);
+                get_target_codec_value(table, "TiffCompression", target.tiffCompression, tiffCompressionFromString);
+                get_target_value(table, "TiffZipLevel", target.tiffZipLevel);
+                get_target_codec_value(table, "OpenEXRCompression", target.exrCompression, exrCompressionFromString);
+                get_target_value(table, "OpenEXRZipLevel", target.exrZipLevel);
+                get_target_value(table, "OpenEXRDwaLevel", target.exrDwaLevel);
+                get_target_codec_value(table, "PngStrategy", target.pngStrategy, pngStrategyFromString);
+                get_target_value(table, "PngLevel", target.pngCompressionLevel);
+                get_target_value(table, "JpegQuality", target.jpegQuality);
+                get_target_codec_value(table, "JpegSubsampling", target.jpegSubsampling, jpegSubsamplingFromString);
+                get_target_value(table, "HeicQuality", target.heicQuality);
+                get_target_value(table, "JpegXLQuality", target.jpegxlQuality);
+                clampSettings(target);
+                loaded.outputs.push_back(std::move(target));
+            }
+        }
 
         outSettings = loaded;
         return true;
@@ -375,6 +450,17 @@ exrCompressionName(int compression)
     }
 }
 
+static const char*
+fillEngineName(int engine)
+{
+    switch (engine) {
+    case FillEngine_PushPull: return "Push-Pull";
+    case FillEngine_Membrane: return "Membrane";
+    case FillEngine_Dilate: return "Dilate";
+    default: return "Unknown";
+    }
+}
+
 static const char*
 pngStrategyName(int strategy)
 {
@@ -410,11 +496,20 @@ printSettings(Settings& settings)
     spdlog::info("Use Alpha: {}", settings.useAlpha ? "Embedded image alpha" : "External mask file");
     spdlog::info("Premultiply: {}", settings.premultiplyAlpha ? "Enabled" : "Disabled");
     spdlog::info("Alpha Gamma: {}", settings.alphaGamma);
+    spdlog::info("Fill Margin: {}", settings.fillMargin < 0 ? std::string("Display window")
+                                                            : std::to_string(settings.fillMargin) + " px");
+    spdlog::info("Fill Engine: {}", fillEngineName(settings.fillEngine));
+    if (settings.fillEngine == FillEngine_Dilate) {
+        spdlog::info("Dilate Radius: {}", settings.dilateRadius > 0 ? std::to_string(settings.dilateRadius) + " px"
+                                                                    : std::string("Unlimited"));
+        spdlog::info("Dilate Distance: {}", settings.dilateDistance ? "Enabled" : "Disabled");
+    }
     spdlog::info("Mask: {}", settings.alphaMode == 0
                                ? "Remove Alpha"
                                : (settings.alphaMode == 1 ? "Preserve Alpha" : "Export Alpha only"));
     spdlog::info("Parallel Threads: {}", settings.numThreads);
     spdlog::info("Queue Limit: {}", settings.queueLimit);
+    spdlog::info("Incremental Batch: {}", settings.incremental ? "Enabled" : "Disabled");
     spdlog::info("Normalize Mode: {}", settings.normMode);
     spdlog::info("Repair Mode: {}", settings.repairMode);
     spdlog::info("Range Mode: {}", settings.rangeMode);
@@ -427,6 +522,9 @@ printSettings(Settings& settings)
     spdlog::info("Default File Format: {}", formatName(settings.defFormat));
     spdlog::info("Export Bit Depth: {}", bitDepthName(settings.bitDepth));
     spdlog::info("Default Export Bit Depth: {}", bitDepthName(settings.defBDepth));
+    spdlog::info("Output Scale: 1/{}", 1 << settings.outputScale);
+    spdlog::info("MIP-mapped TIFF/EXR: {} filter {}", settings.mipmapOutput ? "Enabled" : "Disabled",
+                 settings.mipFilter.empty() ? std::string("push-pull pyramid") : settings.mipFilter);
     spdlog::info("TIFF Compression: {} level {}", tiffCompressionName(settings.tiffCompression), settings.tiffZipLevel);
     spdlog::info("OpenEXR Compression: {} zip level {} dwa level {}", exrCompressionName(settings.exrCompression),
                  settings.exrZipLevel, settings.exrDwaLevel);
@@ -439,6 +537,15 @@ printSettings(Settings& settings)
     spdlog::info("JPEG XL Quality: {} effort {} speed {}", settings.jpegxlQuality, settings.jpegxlEffort,
                  settings.jpegxlSpeed);
     spdlog::info("Raw Rotation: {}", settings.rawRot);
+    spdlog::info("Out-of-core Push-Pull: {} cache {} MB", settings.outOfCore ? "Enabled" : "Disabled",
+                 settings.cacheSizeMB);
+    spdlog::info("Mapped TIFF/PNM input, PNM/PFM output: {}", settings.zeroCopy ? "Enabled" : "Disabled");
+    spdlog::info("Output Targets: {}", settings.outputs.empty() ? std::string("Single")
+                                                                : std::to_string(settings.outputs.size()));
+    for (const Settings& target : settings.outputs) {
+        spdlog::info("  {}: {} {} alpha {}", target.outSuffix.empty() ? std::string("(default)") : target.outSuffix,
+                     formatName(target.fileFormat), bitDepthName(target.bitDepth), target.alphaMode);
+    }
     spdlog::info("Verbosity: {}", settings.verbosity);
     spdlog::info("------------------------");
 }
@@ -29,6 +29,12 @@ typedef unsigned short ushort;
 typedef unsigned int uint;
 typedef unsigned long ulong;
 
+enum FillEngineMode : int {
+    FillEngine_PushPull = 0,
+    FillEngine_Membrane,
+    FillEngine_Dilate,
+};
+
 enum TiffCompressionMode : int {
     TiffCompression_Zip = 0,
     TiffCompression_Lzw,
@@ -74,11 +80,22 @@ struct Settings {
     uint swapBasis, swapInvertMask, grayscaleMode;
     int fileFormat, defFormat;
     int bitDepth, defBDepth;
+    int outputScale;
+    bool mipmapOutput;
+    std::string mipFilter;
     int rawRot;
     uint numThreads;
     uint queueLimit;
+    bool incremental;
+    bool outOfCore;
+    uint cacheSizeMB;
+    bool zeroCopy;
     uint verbosity;
     float alphaGamma;
+    int fillMargin;
+    int fillEngine;
+    int dilateRadius;
+    bool dilateDistance;
     float grayscaleWeights[3];
     int tiffCompression, tiffZipLevel;
     int exrCompression, exrZipLevel, exrDwaLevel;
@@ -90,6 +107,11 @@ struct Settings {
 
     std::vector<std::string> normNames, mask_substr, out_formats;
 
+    // Output name suffix, empty for the default one picked from the processing mode.
+    std::string outSuffix;
+    // Fan-out targets written from one decode and fill of each input; empty writes a single output.
+    std::vector<Settings> outputs;
+
     static constexpr int raw_rot[5]  = { -1, 0, 3, 5, 6 };
     static constexpr uint rngConv[4] = { 0, 1, 2, 3 };
 
@@ -105,19 +127,30 @@ struct Settings {
         alphaMode      = 0;
         numThreads     = 3;
         queueLimit     = 0;
+        incremental    = false;
         verbosity      = 3;
         alphaGamma     = 1.0f;
+        fillMargin     = 0;
+        fillEngine     = FillEngine_PushPull;
+        dilateRadius   = 0;
+        dilateDistance = false;
         normMode       = 1;
         repairMode     = 0;
         swapBasis      = 0;
         swapInvertMask = 0;
         grayscaleMode  = 0;
+        outOfCore      = false;
+        cacheSizeMB    = 2048;
+        zeroCopy       = false;
 
         rangeMode           = 0;
         fileFormat          = -1;
         defFormat           = 0;
         bitDepth            = -1;
         defBDepth           = 1;
+        outputScale         = 0;
+        mipmapOutput        = false;
+        mipFilter           = "";
         rawRot              = -1;
         grayscaleWeights[0] = 0.2126f;
         grayscaleWeights[1] = 0.7152f;
@@ -140,6 +173,9 @@ struct Settings {
         normNames   = { "normal", "tangent", "object", "world" };
         mask_substr = { "_mask.", "_mask_", "_alpha.", "_alpha_" };
         out_formats = { "tif", "exr", "png", "jpg", "jp2", "jph", "heic", "jxl", "ppm" };
+
+        outSuffix.clear();
+        outputs.clear();
     }
 
     int getBitDepth() const
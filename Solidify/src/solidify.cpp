@@ -177,59 +177,716 @@ getTypedPointer(OIIO::ImageBuf& buf, const OIIO::TypeDesc& type)
     }
 }
 
-bool
-solidify_main(const std::string& inputFileName, const std::string& outputFileName,
-              const MaskBuffers& maskBuffers, const SolidifyProgressCallback& progressCallback)
+static bool
+isNormalMapName(const std::string& inputFileName)
 {
-    VTimer g_timer;
+    const std::string lowName = toLower(inputFileName);
+    for (auto& name : settings.normNames) {
+        if (lowName.find(name, 0) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    TypeDesc out_format;
+// Normalize, repair, range, swap and grayscale passes run on the whole processed image in writeSolidifyTarget.
+static bool
+hasPostFillPasses(const std::string& inputFileName, const Settings& target = settings)
+{
+    const bool doNormalize = target.normMode == 2 || (target.normMode != 0 && isNormalMapName(inputFileName));
+    return doNormalize || target.repairMode != 0 || target.rangeMode > 1 || target.swapBasis != 0
+           || target.swapInvertMask != 0 || target.grayscaleMode != 0;
+}
 
-    ImageSpec config;
-    config["raw:user_flip"] = settings.rawRot;
-    //config["oiio:reorient"] = 0;
+// Centers and scale of the normalize and repair passes for a range mode: inCenter is the zero vector of the input,
+// outCenter and scale map unit vectors to the output range.
+static void
+rangeCenters(const int rangeMode, float* inCenter, float* outCenter, float* scale)
+{
+    switch (rangeMode) {
+    case 1:
+        *inCenter  = 0.0f;
+        *outCenter = 0.0f;
+        *scale     = 1.0f;
+        break;
+    case 2:
+        *inCenter  = 0.0f;
+        *outCenter = 0.5f;
+        *scale     = 0.5f;
+        break;
+    case 3:
+        *inCenter  = 0.5f;
+        *outCenter = 0.0f;
+        *scale     = 1.0f;
+        break;
+    case 0:
+    default:
+        *inCenter  = 0.5f;
+        *outCenter = 0.5f;
+        *scale     = 0.5f;
+        break;
+    }
+}
 
-    config["oiio:UnassociatedAlpha"] = 1;
-    config["tiff:UnassociatedAlpha"] = 0;
-    config["oiio:ColorSpace"]        = "Linear";
+// True when target renormalizes the whole fill result, so push-pull can fill in the octahedral normal domain and
+// hand back unit normals in target's range instead.
+static bool
+normalizesFill(const std::string& inputFileName, const Settings& target)
+{
+    const bool doNormalize = target.normMode == 2 || (target.normMode != 0 && isNormalMapName(inputFileName));
+    return doNormalize && target.repairMode == 0;
+}
 
-    ImageBuf input_buf(inputFileName, 0, 0, nullptr, &config, nullptr);
+static FillEngine
+fillEngine(const int mode)
+{
+    switch (mode) {
+    case FillEngine_Membrane: return FillEngine::Membrane;
+    case FillEngine_Dilate: return FillEngine::Dilate;
+    default: return FillEngine::PushPull;
+    }
+}
 
-    if (!input_buf.init_spec(inputFileName, 0, 0)) {
+// Out-of-core push-pull only covers the plain solidify pipeline: embedded alpha in the last channel, the push-pull
+// engine and no post-fill pass that would need the whole filled image in memory.
+static bool
+canSolidifyOutOfCore(const ImageSpec& spec, const std::string& inputFileName, bool external_alpha)
+{
+    if (!settings.isSolidify || external_alpha || settings.alphaMode == 2
+        || settings.fillEngine != FillEngine_PushPull) {
+        return false;
+    }
+    if (spec.nchannels != 2 && spec.nchannels != 4) {
+        return false;
+    }
+    // Banded push-pull covers the data window only and writes full resolution.
+    return settings.fillMargin == 0 && settings.outputScale == 0 && !hasPostFillPasses(inputFileName);
+}
+
+// Applies alpha gamma and, when enabled, premultiplication to count interleaved float pixels with alpha in the
+// last channel, matching what img_load does for the in-memory path.
+static void
+shapeAlphaPixels(float* pixels, size_t count, int channels)
+{
+    const int alphaChannel = channels - 1;
+    const bool applyGamma  = std::abs(settings.alphaGamma - 1.0f) > 0.000001f;
+    const float exponent   = 1.0f / std::max(settings.alphaGamma, 0.01f);
+    for (size_t i = 0; i < count; ++i) {
+        float* pixel = pixels + i * static_cast<size_t>(channels);
+        float alpha  = pixel[alphaChannel];
+        if (applyGamma) {
+            alpha               = std::pow(std::clamp(alpha, 0.0f, 1.0f), exponent);
+            pixel[alphaChannel] = alpha;
+        }
+        if (settings.premultiplyAlpha) {
+            for (int c = 0; c < alphaChannel; ++c) {
+                pixel[c] *= alpha;
+            }
+        }
+    }
+}
+
+// Output spec for channels [chbegin, chend) of an input with inputSpec, with the same export format and encoder
+// settings as the in-memory path.
+static ImageSpec
+makeOutputSpec(const std::string& outputFileName, const ImageSpec& inputSpec, int chbegin, int chend)
+{
+    ImageSpec ospec = inputSpec;
+    ospec.nchannels = chend - chbegin;
+    ospec.channelnames.clear();
+    for (int c = chbegin; c < chend; ++c) {
+        ospec.channelnames.push_back(inputSpec.channel_name(c));
+    }
+    ospec.channelformats.clear();
+    ospec.alpha_channel = -1;  // No alpha channel
+    ospec.erase_attribute("Exif:LensSpecification");
+    if (getTypeDesc(settings.bitDepth) == TypeDesc::UNKNOWN) {
+        ospec.set_format(inputSpec.format);
+    } else {
+        ospec.set_format(getTypeDesc(settings.bitDepth));
+    }
+    applyEncoderSettings(ospec, outputFileName, settings);
+    spdlog::info("Output file format: {}", formatText(ospec.format));
+    return ospec;
+}
+
+// MIP-mapped output needs a format that can hold tiles and MIP levels, such as TIFF and OpenEXR.
+static bool
+canWriteMipmapped(const std::string& outputFileName)
+{
+    auto out = ImageOutput::create(outputFileName);
+    return out && out->supports("tiles") && out->supports("mipmap");
+}
+
+// MIP chain below top, each level half the size of the one above down to 1x1 and resampled from it with filter.
+static bool
+resampleMipLevels(std::vector<ImageBuf>* levels, const ImageBuf& top, const std::string& filter)
+{
+    levels->clear();
+    levels->reserve(32);
+    const ImageBuf* above = &top;
+    int width             = top.spec().width;
+    int height            = top.spec().height;
+    while (width > 1 || height > 1) {
+        width  = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        ImageBuf level;
+        if (!ImageBufAlgo::resize(level, *above, { { "filtername", filter } },
+                                  ROI(0, width, 0, height, 0, 1, 0, top.nchannels()))) {
+            spdlog::error("MIP level {}x{} resize error: {}", width, height, level.geterror());
+            return false;
+        }
+        levels->push_back(std::move(level));
+        above = &levels->back();
+    }
+    return true;
+}
+
+// Appends levels below the top image already written to out, taking topSpec.nchannels channels from firstChannel
+// of each level.
+static bool
+writeMipLevels(ImageOutput& out, const std::string& outputFileName, const ImageSpec& topSpec,
+               const std::vector<ImageBuf>& levels, int firstChannel)
+{
+    for (const ImageBuf& level : levels) {
+        ImageSpec spec   = topSpec;
+        spec.width       = level.spec().width;
+        spec.height      = level.spec().height;
+        spec.full_width  = spec.width;
+        spec.full_height = spec.height;
+        if (!out.open(outputFileName, spec, ImageOutput::AppendMIPLevel)) {
+            return false;
+        }
+        const TypeDesc format = level.spec().format;
+        const char* pixels    = (const char*)level.localpixels() + firstChannel * format.size();
+        if (!out.write_image(format, pixels, level.pixel_stride(), level.scanline_stride(), level.z_stride())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Box-filters a full-resolution alpha down to full, the display window of a result taken from a pyramid level.
+static bool
+scaleAlphaToLevel(ImageBuf& dst, const ImageBuf& alpha, ROI full)
+{
+    full.chbegin = 0;
+    full.chend   = alpha.nchannels();
+    if (!ImageBufAlgo::resize(dst, alpha, { { "filtername", "box" } }, full)) {
+        spdlog::error("alpha resize error: {}", dst.geterror());
+        return false;
+    }
+    return true;
+}
+
+// Opens outputFileName for band writes of channels [chbegin, chend) of an input with inputSpec. A tiled input stays
+// tiled when the output format supports tiles, as on the in-memory path.
+static std::unique_ptr<ImageOutput>
+openStreamOutput(const std::string& outputFileName, const ImageSpec& inputSpec, int chbegin, int chend)
+{
+    ImageSpec ospec = makeOutputSpec(outputFileName, inputSpec, chbegin, chend);
+
+    auto out = ImageOutput::create(outputFileName);
+    if (!out) {
+        spdlog::error("Could not create output file: {}", outputFileName);
+        return nullptr;
+    }
+    if (ospec.tile_width > 0 && !out->supports("tiles")) {
+        ospec.tile_width  = 0;
+        ospec.tile_height = 0;
+        ospec.tile_depth  = 0;
+    }
+    if (!out->open(outputFileName, ospec, ImageOutput::Create)) {
+        spdlog::error("Error opening {}", outputFileName);
+        spdlog::error("{}", out->geterror());
+        return nullptr;
+    }
+    return out;
+}
+
+// Rows per band for a stream output: about rows, rounded to whole tile rows when the output is tiled.
+static int
+streamBandRows(const ImageOutput& out, int rows)
+{
+    const int tileHeight = out.spec().tile_height;
+    return out.spec().tile_width > 0 && tileHeight > 0 ? std::max(1, rows / tileHeight) * tileHeight : rows;
+}
+
+// Writes rows [ybegin, yend) of an input with inputSpec to a stream output, as tiles when the output is tiled. ybegin
+// must start a tile row and yend end one or the image.
+static bool
+writeStreamRows(ImageOutput& out, const ImageSpec& inputSpec, int ybegin, int yend, TypeDesc format, const void* data,
+                stride_t xstride = AutoStride)
+{
+    if (out.spec().tile_width > 0) {
+        return out.write_tiles(inputSpec.x, inputSpec.x + inputSpec.width, inputSpec.y + ybegin, inputSpec.y + yend,
+                               inputSpec.z, inputSpec.z + 1, format, data, xstride);
+    }
+    return out.write_scanlines(inputSpec.y + ybegin, inputSpec.y + yend, inputSpec.z, format, data, xstride);
+}
+
+static bool
+solidifyFromCache(ImageCache& cache, const std::string& inputFileName, const std::string& outputFileName,
+                  const ImageSpec& inputSpec, const SolidifyProgressCallback& progressCallback)
+{
+    const ustring fileName(inputFileName);
+    const int width        = inputSpec.width;
+    const int height       = inputSpec.height;
+    const int channels     = inputSpec.nchannels;
+    const int alphaChannel = channels - 1;
+
+    PushPullBandSource source;
+    source.width    = width;
+    source.height   = height;
+    source.channels = channels;
+    source.readRows = [&](int ybegin, int yend, float* pixels) {
+        if (!cache.get_pixels(fileName, 0, 0, inputSpec.x, inputSpec.x + width, inputSpec.y + ybegin,
+                              inputSpec.y + yend, inputSpec.z, inputSpec.z + 1, 0, channels, TypeDesc::FLOAT,
+                              pixels)) {
+            spdlog::error("Error reading rows {}-{} of {}", ybegin, yend, inputFileName);
+            spdlog::error("{}", cache.geterror());
+            return false;
+        }
+        shapeAlphaPixels(pixels, static_cast<size_t>(yend - ybegin) * static_cast<size_t>(width), channels);
+        return true;
+    };
+
+    auto out = openStreamOutput(outputFileName, inputSpec, 0, settings.alphaMode == 1 ? channels : channels - 1);
+    if (!out) {
+        return false;
+    }
+
+    const std::string writeStatus = "Writing: " + std::filesystem::path(outputFileName).filename().string();
+    std::vector<float> bandAlpha;
+    std::vector<float> bandPixels;
+
+    // Pyramid levels up to the cache size are held in memory, larger ones are streamed from the cache.
+    PushPullBandSink sink;
+    sink.bandHeight    = streamBandRows(*out, 64);
+    sink.residentBytes = static_cast<size_t>(settings.cacheSizeMB) << 20;
+    sink.writeRows     = [&](int ybegin, int yend, const float* pixels) {
+        const float* rows = pixels;
+        if (settings.alphaMode == 1) {
+            // Preserve mode writes the file's own alpha, before gamma shaping.
+            const size_t count = static_cast<size_t>(yend - ybegin) * static_cast<size_t>(width);
+            bandAlpha.resize(count);
+            if (!cache.get_pixels(fileName, 0, 0, inputSpec.x, inputSpec.x + width, inputSpec.y + ybegin,
+                                  inputSpec.y + yend, inputSpec.z, inputSpec.z + 1, alphaChannel, alphaChannel + 1,
+                                  TypeDesc::FLOAT, bandAlpha.data())) {
+                spdlog::error("Error reading alpha rows {}-{} of {}", ybegin, yend, inputFileName);
+                spdlog::error("{}", cache.geterror());
+                return false;
+            }
+            bandPixels.assign(pixels, pixels + count * static_cast<size_t>(channels));
+            for (size_t i = 0; i < count; ++i) {
+                bandPixels[i * static_cast<size_t>(channels) + static_cast<size_t>(alphaChannel)] = bandAlpha[i];
+            }
+            rows = bandPixels.data();
+        }
+        const stride_t xstride = static_cast<stride_t>(channels) * static_cast<stride_t>(sizeof(float));
+        if (!writeStreamRows(*out, inputSpec, ybegin, yend, TypeDesc::FLOAT, rows, xstride)) {
+            spdlog::error("Error writing {}", outputFileName);
+            spdlog::error("{}", out->geterror());
+            return false;
+        }
+        reportProgress(progressCallback, 0.35f + 0.65f * static_cast<float>(yend) / static_cast<float>(height),
+                       writeStatus);
+        return true;
+    };
+
+    std::string error;
+    const bool ok = applyPushPullFillBanded(source, sink, 0, &error);
+    if (!ok) {
+        spdlog::error("push-pull error: {}", error);
+    }
+    out->close();
+    return ok;
+}
+
+static bool
+solidifyOutOfCore(const std::string& inputFileName, const std::string& outputFileName, const ImageSpec& config,
+                  const ImageSpec& inputSpec, const SolidifyProgressCallback& progressCallback)
+{
+    VTimer pushpull_timer;
+    spdlog::info("Out-of-core push-pull, cache size {} MB", settings.cacheSizeMB);
+    reportProgress(progressCallback, 0.0f, "Reading: " + std::filesystem::path(inputFileName).filename().string());
+
+    auto cache = ImageCache::create(false);
+    cache->attribute("max_memory_MB", static_cast<float>(settings.cacheSizeMB));
+    cache->attribute("autotile", 64);
+
+    bool ok = cache->add_file(ustring(inputFileName), nullptr, &config);
+    if (!ok) {
         spdlog::error("Error reading {}", inputFileName);
-        spdlog::error("{}", input_buf.geterror());
+        spdlog::error("{}", cache->geterror());
+    } else {
+        ok = solidifyFromCache(*cache, inputFileName, outputFileName, inputSpec, progressCallback);
+    }
+    ImageCache::destroy(cache);
+
+    if (!ok) {
         reportProgress(progressCallback, 0.0f, "Error! Check console for details");
         return false;
     }
+    spdlog::info("File processing time : {}", pushpull_timer.nowText());
+    reportProgress(progressCallback, 1.0f, "Written: " + std::filesystem::path(outputFileName).filename().string());
+    return true;
+}
 
-    TypeDesc orig_format = input_buf.spec().format;
+// Conversion-only runs skip every pixel operation, so the file can go straight from decoder to encoder.
+static bool
+canStreamConvert(const ImageSpec& spec, const std::string& inputFileName, bool external_alpha)
+{
+    if (settings.isSolidify || external_alpha || settings.alphaMode == 2 || settings.mipmapOutput) {
+        return false;
+    }
+    if (spec.nchannels < 1 || spec.nchannels > 4 || spec.depth != 1) {
+        return false;
+    }
+    return !hasPostFillPasses(inputFileName);
+}
 
-    //   // check EXIF rotation
-    //   int orientation = 1;
-    //   auto& tspec = input_buf.spec();
-    //   auto& extspec = tspec.extra_attribs;
-    //   for (auto& attr : extspec) {
-    //	std::string name = attr.name().string();
-    //	std::string value = attr.get_string();
-    //	spdlog::info) << name << " : " << value << std::endl;
-    //}
+// Same output channel count the in-memory path picks from alphaMode for an unmodified input.
+static int
+streamConvertChannels(const ImageSpec& spec)
+{
+    const int channels   = spec.nchannels;
+    const bool hasAlpha  = channels == 4 || channels == 2;
+    const bool grayscale = channels <= 2;
+    if (settings.alphaMode == 1 && hasAlpha) {
+        return channels;
+    }
+    if (settings.alphaMode == 0) {
+        return grayscale ? 1 : std::min(3, channels);
+    }
+    return 1;
+}
 
-    spdlog::info("File bith depth: {}", formatText(orig_format));
+// Copies channels [chbegin, chend) from in to out in row bands, converting to the output pixel format while
+// decoding. Only two bands are held at a time: the next band is decoded while the previous one is being encoded.
+static bool
+streamScanlineBands(ImageInput& in, ImageOutput& out, const ImageSpec& inputSpec, int chbegin, int chend,
+                    const std::string& status, const SolidifyProgressCallback& progressCallback)
+{
+    const int bandRows    = streamBandRows(out, 64);
+    const TypeDesc format = out.spec().format;
+    const int height      = inputSpec.height;
+    const size_t rowBytes = static_cast<size_t>(inputSpec.width) * static_cast<size_t>(chend - chbegin)
+                            * format.size();
+
+    std::vector<unsigned char> bands[2];
+    std::future<bool> pendingWrite;
+    bool ok  = true;
+    int band = 0;
+    for (int y0 = 0; y0 < height; y0 += bandRows, ++band) {
+        const int y1                       = std::min(height, y0 + bandRows);
+        std::vector<unsigned char>& pixels = bands[band & 1];
+        pixels.resize(static_cast<size_t>(y1 - y0) * rowBytes);
+        if (!in.read_scanlines(0, 0, inputSpec.y + y0, inputSpec.y + y1, inputSpec.z, chbegin, chend, format,
+                               pixels.data())) {
+            spdlog::error("Error reading scanlines {}-{}", y0, y1);
+            spdlog::error("{}", in.geterror());
+            ok = false;
+            break;
+        }
+        if (pendingWrite.valid() && !pendingWrite.get()) {
+            ok = false;
+            break;
+        }
+        pendingWrite = std::async(std::launch::async, [&out, &pixels, &inputSpec, format, y0, y1]() {
+            return writeStreamRows(out, inputSpec, y0, y1, format, pixels.data());
+        });
+        reportProgress(progressCallback, static_cast<float>(y1) / static_cast<float>(height), status);
+    }
+    if (pendingWrite.valid() && !pendingWrite.get()) {
+        ok = false;
+    }
+    if (!ok && out.has_error()) {
+        spdlog::error("{}", out.geterror());
+    }
+    return ok;
+}
 
-    //ImageBuf::ImageBuf(config, input_buf);
+// Mask export writes only the embedded alpha, so nothing but that channel has to be decoded. Alpha gamma is left to
+// the in-memory path, which shapes alpha on load.
+static bool
+canStreamAlphaExport(const ImageSpec& spec, bool external_alpha)
+{
+    return settings.alphaMode == 2 && !external_alpha && !settings.mipmapOutput
+           && std::abs(settings.alphaGamma - 1.0f) <= 0.000001f && (spec.nchannels == 2 || spec.nchannels == 4)
+           && spec.depth == 1;
+}
 
-    bool external_alpha = false;
-    bool grayscale      = false;
+static bool
+streamConvert(const std::string& inputFileName, const std::string& outputFileName, const ImageSpec& config,
+              int chbegin, int chend, const SolidifyProgressCallback& progressCallback)
+{
+    VTimer stream_timer;
+    auto in = ImageInput::open(inputFileName, &config);
+    if (!in) {
+        spdlog::error("Error reading {}", inputFileName);
+        spdlog::error("{}", OIIO::geterror());
+        reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+        return false;
+    }
+    const ImageSpec inputSpec = in->spec();
 
-    if (!settings.useAlpha && maskBuffers.alpha.initialized() && maskBuffers.rgbAlpha.initialized()) {
-        external_alpha = true;
+    auto out = openStreamOutput(outputFileName, inputSpec, chbegin, chend);
+    if (!out) {
+        reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+        return false;
+    }
+
+    spdlog::info("Streaming {} to {}", inputFileName, outputFileName);
+    const std::string status = "Writing: " + std::filesystem::path(outputFileName).filename().string();
+    const bool ok = streamScanlineBands(*in, *out, inputSpec, chbegin, chend, status, progressCallback);
+    out->close();
+    in->close();
+    if (!ok) {
+        spdlog::error("Error writing {}", outputFileName);
+        reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+        return false;
+    }
+
+    spdlog::info("File processing time : {}", stream_timer.nowText());
+    reportProgress(progressCallback, 1.0f, "Written: " + std::filesystem::path(outputFileName).filename().string());
+    return true;
+}
+
+// Multipart EXRs and multi-page TIFFs run the plain solidify pipeline on every subimage when the output format can
+// hold them all; otherwise only subimage 0 goes through solidify_main.
+static bool
+canSolidifySubimages(const std::string& inputFileName, const std::string& outputFileName, bool external_alpha)
+{
+    if (!settings.isSolidify || external_alpha || settings.alphaMode == 2 || settings.outputScale != 0
+        || hasPostFillPasses(inputFileName)) {
+        return false;
+    }
+    auto out = ImageOutput::create(outputFileName);
+    return out && out->supports("multiimage") && out->supports("appendsubimage");
+}
+
+// Fills one decoded float subimage with its own alpha. Subimages without an alpha layout are left unchanged.
+static bool
+solidifySubimage(ImageBuf& part, int nthreads, std::string* error)
+{
+    const int channels = part.nchannels();
+    if (channels != 2 && channels != 4) {
+        return true;
+    }
+    const int alphaChannel = channels - 1;
+
+    ImageBuf originalAlpha;
+    if (settings.alphaMode == 1) {
+        int channelorder[] = { alphaChannel };
+        originalAlpha      = ImageBufAlgo::channels(part, 1, channelorder);
+    }
+    shapeAlphaPixels(static_cast<float*>(part.localpixels()), part.spec().image_pixels(), channels);
+    part.specmod().alpha_channel = alphaChannel;
+
+    PushPullOptions fillOptions;
+    fillOptions.margin       = settings.fillMargin;
+    fillOptions.nthreads     = nthreads;
+    fillOptions.engine       = fillEngine(settings.fillEngine);
+    fillOptions.dilateRadius = settings.dilateRadius;
+    ImageBuf filled;
+    if (!applyPushPullFill(filled, part, fillOptions)) {
+        *error = filled.geterror();
+        return false;
+    }
+    if (settings.alphaMode == 1 && settings.fillMargin != 0
+        && !ImageBufAlgo::zero(filled, ROI(filled.xbegin(), filled.xend(), filled.ybegin(), filled.yend(), 0, 1,
+                                           alphaChannel, alphaChannel + 1))) {
+        *error = filled.geterror();
+        return false;
+    }
+    if (settings.alphaMode == 1
+        && !ImageBufAlgo::paste(filled, originalAlpha.xbegin(), originalAlpha.ybegin(), originalAlpha.zbegin(),
+                                alphaChannel, originalAlpha)) {
+        *error = filled.geterror();
+        return false;
+    }
+    part = std::move(filled);
+    return true;
+}
+
+// Subimages decoded and filled at the same time. Each one held is a whole float part, so this bounds the memory of
+// long multi-page files.
+static constexpr int kSubimageFills = 3;
+
+static bool
+solidifySubimages(const std::string& inputFileName, const std::string& outputFileName, const ImageSpec& config,
+                  const SolidifyProgressCallback& progressCallback)
+{
+    VTimer subimage_timer;
+    auto in = ImageInput::open(inputFileName, &config);
+    if (!in) {
+        spdlog::error("Error reading {}", inputFileName);
+        spdlog::error("{}", OIIO::geterror());
+        reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+        return false;
+    }
+
+    std::vector<ImageSpec> inputSpecs;
+    for (int s = 0; in->seek_subimage(s, 0); ++s) {
+        inputSpecs.push_back(in->spec());
+    }
+    const int nsubimages = static_cast<int>(inputSpecs.size());
+    spdlog::info("Processing {} subimages of {}", nsubimages, inputFileName);
+
+    // The output is opened with every part's header before any fill is done, so the data windows are the ones the
+    // fill will grow by the margin. Parts without alpha are written unfilled.
+    PushPullOptions regionOptions;
+    regionOptions.margin = settings.fillMargin;
+    std::vector<ImageSpec> outputSpecs;
+    for (const ImageSpec& spec : inputSpecs) {
+        const bool hasAlpha  = spec.nchannels == 2 || spec.nchannels == 4;
+        const int chend      = settings.alphaMode == 0 && hasAlpha ? spec.nchannels - 1 : spec.nchannels;
+        ImageSpec filledSpec = spec;
+        if (hasAlpha) {
+            const ROI region  = pushPullFillRegion(spec, regionOptions);
+            filledSpec.x      = region.xbegin;
+            filledSpec.y      = region.ybegin;
+            filledSpec.width  = region.width();
+            filledSpec.height = region.height();
+        }
+        outputSpecs.push_back(makeOutputSpec(outputFileName, filledSpec, 0, chend));
+    }
+
+    std::unique_ptr<ImageOutput> out = ImageOutput::create(outputFileName);
+    if (!out || !out->open(outputFileName, nsubimages, outputSpecs.data())) {
+        spdlog::error("Error opening {}", outputFileName);
+        spdlog::error("{}", out ? out->geterror() : OIIO::geterror());
+        reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+        return false;
     }
 
+    // Every subimage is decoded from the one open input, and each fill starts as soon as its pixels are in while the
+    // next subimage is decoded. At most kSubimageFills parts are held at a time: before another one is decoded, the
+    // oldest is written in order and released.
+    const int inFlight            = std::min(nsubimages, kSubimageFills);
+    const int partThreads         = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / inFlight);
+    const std::string readStatus  = "Reading: " + std::filesystem::path(inputFileName).filename().string();
+    const std::string writeStatus = "Writing: " + std::filesystem::path(outputFileName).filename().string();
+    std::vector<ImageBuf> parts(static_cast<size_t>(nsubimages));
+    std::vector<std::string> errors(static_cast<size_t>(nsubimages));
+    std::vector<std::future<bool>> fills(static_cast<size_t>(nsubimages));
+    auto writePart = [&](const int s) {
+        if (!fills[s].get()) {
+            spdlog::error("push-pull error in subimage {}: {}", s, errors[s]);
+            return false;
+        }
+        if (s > 0 && !out->open(outputFileName, outputSpecs[s], ImageOutput::AppendSubimage)) {
+            spdlog::error("Error appending subimage {} to {}", s, outputFileName);
+            spdlog::error("{}", out->geterror());
+            return false;
+        }
+        const ImageBuf& part = parts[s];
+        if (!out->write_image(TypeDesc::FLOAT, part.localpixels(), part.pixel_stride(), part.scanline_stride(),
+                              part.z_stride())) {
+            spdlog::error("Error writing subimage {} of {}", s, outputFileName);
+            spdlog::error("{}", out->geterror());
+            return false;
+        }
+        parts[s].clear();
+        reportProgress(progressCallback, 0.35f + 0.65f * static_cast<float>(s + 1) / static_cast<float>(nsubimages),
+                       writeStatus);
+        return true;
+    };
+
+    bool ok     = true;
+    int written = 0;
+    for (int s = 0; s < nsubimages && ok; ++s) {
+        if (s - written == inFlight && !writePart(written++)) {
+            ok = false;
+            break;
+        }
+        ImageSpec bufSpec = inputSpecs[s];
+        bufSpec.set_format(TypeDesc::FLOAT);
+        bufSpec.channelformats.clear();
+        parts[s] = ImageBuf(bufSpec);
+        if (!in->read_image(s, 0, 0, bufSpec.nchannels, TypeDesc::FLOAT, parts[s].localpixels())) {
+            spdlog::error("Error reading subimage {} of {}", s, inputFileName);
+            spdlog::error("{}", in->geterror());
+            ok = false;
+            break;
+        }
+        fills[s] = std::async(std::launch::async, [&parts, &errors, s, partThreads]() {
+            return solidifySubimage(parts[s], partThreads, &errors[s]);
+        });
+        reportProgress(progressCallback, 0.35f * static_cast<float>(s + 1) / static_cast<float>(nsubimages),
+                       readStatus);
+    }
+    in->close();
+    for (; written < nsubimages && ok; ++written) {
+        ok = writePart(written);
+    }
+    // Fills still running after an error own parts and errors, so they are finished before those go away.
+    for (std::future<bool>& fill : fills) {
+        if (fill.valid()) {
+            fill.wait();
+        }
+    }
+    out->close();
+
+    if (!ok) {
+        reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+        return false;
+    }
+    spdlog::info("File processing time : {}", subimage_timer.nowText());
+    reportProgress(progressCallback, 1.0f, "Written: " + std::filesystem::path(outputFileName).filename().string());
+    return true;
+}
+
+// Decoded and filled image that every output target of one input is written from.
+struct SolidifyResult {
+    ImageBuf result;                  // Filled pixels, or the loaded input when nothing was filled
+    ImageBuf ownedAlpha;              // Storage for alpha when it is not the shared external mask
+    const ImageBuf* alpha = nullptr;  // Source alpha at the resolution of result, when kept
+    std::vector<ImageBuf> mipLevels;  // Filled pyramid below result, when requested
+    ImageBuf distance;                // Distance to the nearest covered pixel, from a dilation fill that keeps it
+    TypeDesc origFormat;
+    bool grayscale  = false;
+    bool filled     = false;
+    bool normalized = false;  // RGB holds unit normals in the range of every target, from a normal-map fill
+    // Bytes of whole-image copies made for this input. Targets writing side by side add theirs concurrently.
+    mutable std::atomic<size_t> copiedBytes = 0;
+};
+
+// Records a whole-image copy made for image, so redundant copies show up in the per-file debug log.
+static void
+countImageCopy(const SolidifyResult& image, const ImageBuf& copy)
+{
+    image.copiedBytes += copy.spec().image_bytes();
+}
+
+// True when target writes the fill result unchanged apart from dropping alpha, so its lower MIP levels can come
+// straight from the push-pull pyramid.
+static bool
+usesPyramidMipLevels(const std::string& inputFileName, const Settings& target)
+{
+    return target.mipmapOutput && target.mipFilter.empty() && target.alphaMode == 0
+           && !hasPostFillPasses(inputFileName, target);
+}
+
+// Loads input_buf and runs the push-pull fill with the global settings. keepAlpha holds on to the source alpha for
+// targets that write it back; pyramidMipLevels keeps the filled pyramid below the result. normalTarget, when set,
+// is the range every target normalizes the result to, so RGB input can be filled as normals and come back
+// normalized.
+static bool
+loadSolidifyResult(ImageBuf& input_buf, std::unique_ptr<MappedImage>* input_mapping, const std::string& inputFileName,
+                   bool external_alpha, const MaskBuffers& maskBuffers, bool keepAlpha, bool pyramidMipLevels,
+                   const Settings* normalTarget, SolidifyResult* image,
+                   const SolidifyProgressCallback& progressCallback)
+{
+    TypeDesc orig_format = input_buf.spec().format;
+
     // Read the image with a progress callback
 
     spdlog::info("Reading {}", inputFileName);
     ImageBuf original_alpha;
-    bool load_ok = img_load(input_buf, inputFileName, external_alpha, &original_alpha, progressCallback);
+    bool load_ok = img_load(input_buf, inputFileName, external_alpha, keepAlpha ? &original_alpha : nullptr,
+                            progressCallback, input_mapping);
     if (!load_ok) {
         spdlog::error("Error reading {}", inputFileName);
         reportProgress(progressCallback, 0.0f, "Error! Check console for details");
@@ -241,7 +898,6 @@ solidify_main(const std::string& inputFileName, const std::string& outputFileNam
 
     // Get the format (bit depth and type)
     TypeDesc load_format = ispec.format;
-    out_format           = load_format;  // copy latest buffer format as an output format
 
     spdlog::info("File loaded bit depth: {}", formatText(load_format));
 
@@ -251,8 +907,9 @@ solidify_main(const std::string& inputFileName, const std::string& outputFileNam
     spdlog::info("Image size: {}x{}", width, height);
     spdlog::info("Channels: {} Alpha channel index: {}", input_buf.nchannels(), input_buf.spec().alpha_channel);
 
-    bool isValid = true;
-    int inputCh  = input_buf.nchannels();
+    bool isValid   = true;
+    bool grayscale = false;
+    int inputCh    = input_buf.nchannels();
     //
     // Valid with and without external alpha:
     // RGBA - 4 channels
@@ -295,20 +952,11 @@ solidify_main(const std::string& inputFileName, const std::string& outputFileNam
 
     // Create an ImageBuf object to store the result
 
-    ImageBuf result_buf, out_buf, rgba_buf, bit_alpha_buf, original_bit_alpha_buf;
+    ImageBuf& result_buf = image->result;
     const ImageBuf* external_alpha_buf = nullptr;
 
-    // check if filename have any of settings.normNames as substring, case insensitive
-    bool isNormName     = false;
-    bool doNormalize    = false;
-    std::string lowName = toLower(inputFileName);
-
-    for (auto& name : settings.normNames) {
-        if (lowName.find(name, 0) != std::string::npos) {
-            isNormName = true;
-            break;
-        }
-    }
+    image->origFormat = orig_format;
+    image->grayscale  = grayscale;
     //rspec.format = TypeDesc::FLOAT;
     //rspec.format = getTypeDesc(settings.bitDepth);
 
@@ -316,228 +964,342 @@ solidify_main(const std::string& inputFileName, const std::string& outputFileNam
         spdlog::info("Filling holes in process...\n");
         VTimer pushpull_timer;
 
-        if (external_alpha) {
-            const ImageBuf* alpha_buf_ptr = &maskBuffers.alpha;
-
-            if (load_format != TypeDesc::FLOAT) {
-                bit_alpha_buf = maskBuffers.alpha.copy(load_format);
-                alpha_buf_ptr = &bit_alpha_buf;
-            }
-
-            const ImageBuf* preserve_alpha_buf_ptr = maskBuffers.originalAlpha.initialized()
-                                                         ? &maskBuffers.originalAlpha
-                                                         : &maskBuffers.alpha;
-            if (load_format != TypeDesc::FLOAT) {
-                original_bit_alpha_buf = preserve_alpha_buf_ptr->copy(load_format);
-                preserve_alpha_buf_ptr = &original_bit_alpha_buf;
-            }
-            external_alpha_buf = preserve_alpha_buf_ptr;
+        PushPullOptions fillOptions;
+        fillOptions.margin       = settings.fillMargin;
+        fillOptions.level        = settings.outputScale;
+        fillOptions.engine       = fillEngine(settings.fillEngine);
+        fillOptions.dilateRadius = settings.dilateRadius;
+        if (pyramidMipLevels) {
+            fillOptions.mipLevels = &image->mipLevels;
+        }
+        if (settings.fillEngine == FillEngine_Dilate && settings.dilateDistance) {
+            fillOptions.distance = &image->distance;
+        }
+        // Normals are filled as two octahedral channels and come back unit length, in place of the normalize pass.
+        if (normalTarget && inputCh == (external_alpha ? 3 : 4)) {
+            fillOptions.normalMap = true;
+            rangeCenters(normalTarget->rangeMode, &fillOptions.normalInCenter, &fillOptions.normalOutCenter,
+                         &fillOptions.normalScale);
+            spdlog::info("Filling RGB as normals");
+        }
 
-            bool ok = true;
-            if (settings.premultiplyAlpha) {
-                ok = ImageBufAlgo::mul(input_buf, input_buf, grayscale ? maskBuffers.alpha : maskBuffers.rgbAlpha);
-                if (!ok) {
-                    spdlog::error("multiplication error: {}", input_buf.geterror());
-                    reportProgress(progressCallback, 0.0f, "Error! Check console for details");
-                    return false;
-                }
-            }
-            ok = ok && ImageBufAlgo::channel_append(rgba_buf, input_buf, *alpha_buf_ptr);
-            if (!ok) {
-                spdlog::error("channel_append error: {}", rgba_buf.geterror());
+        bool ok = true;
+        if (external_alpha) {
+            // The mask in this image's format and size comes from the batch-wide variant cache, not a copy per file,
+            // and goes to push-pull as a separate coverage plane premultiplied while the top level is read. Binary
+            // masks go as their packed bits, and the plane is only looked up when a target keeps it at full size.
+            const PushPullCoverageBits* bits = maskBuffers.coverage.get();
+            const bool packed                = bits && !fillOptions.normalMap && bits->width == width
+                                               && bits->height == height;
+            const bool fullAlpha             = keepAlpha && settings.outputScale == 0;
+            MaskView mask;
+            if ((!packed || fullAlpha) && !maskVariant(maskBuffers, load_format, width, height, &mask)) {
                 reportProgress(progressCallback, 0.0f, "Error! Check console for details");
                 return false;
             }
-            // rename last channel to alpha and set alpha channel
-            rgba_buf.specmod().channelnames[rgba_buf.nchannels() - 1] = "A";
-            rgba_buf.specmod().alpha_channel                          = rgba_buf.nchannels() - 1;
+            external_alpha_buf = mask.originalAlpha;
+            ok = packed ? applyPushPullFill(result_buf, input_buf, *bits, fillOptions, settings.premultiplyAlpha)
+                        : applyPushPullFill(result_buf, input_buf, *mask.alpha, fillOptions, settings.premultiplyAlpha);
+        } else {
+            // input_buf is not read after the fill, so it is filled in place and handed over as the result.
+            ok         = applyPushPullFill(input_buf, input_buf, fillOptions);
+            result_buf = std::move(input_buf);
         }
 
-        ImageBuf* input_buf_ptr = external_alpha
-                                      ? &rgba_buf
-                                      : &input_buf;  // Use the multiplied RGBA buffer if have an external alpha
-
-        bool ok = applyPushPullFill(result_buf, *input_buf_ptr, 0);
-
         if (!ok) {
             spdlog::error("push-pull error: {}", result_buf.geterror());
             reportProgress(progressCallback, 0.0f, "Error! Check console for details");
             return false;
         }
-
-        if (settings.alphaMode == 1) {
-            const ImageBuf& alpha_buf = external_alpha ? *external_alpha_buf : original_alpha;
-            ImageBufAlgo::paste(result_buf, 0, 0, 0, result_buf.spec().alpha_channel,
-                                alpha_buf);
-            if (result_buf.has_error()) {
-                spdlog::error("paste error: {}", result_buf.geterror());
-                reportProgress(progressCallback, 0.0f, "Error! Check console for details");
-                return false;
+        image->normalized = fillOptions.normalMap;
+
+        if (keepAlpha) {
+            // Targets that keep the source alpha get it at the resolution of the result. An external mask has that
+            // level in the batch-wide variant cache, built once on the mask's pull pyramid.
+            const ROI level = result_buf.roi_full();
+            if (external_alpha && settings.outputScale > 0) {
+                MaskView levelMask;
+                if (!maskVariant(maskBuffers, load_format, level.width(), level.height(), &levelMask)) {
+                    reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+                    return false;
+                }
+                image->alpha = levelMask.originalAlpha;
+            } else if (external_alpha) {
+                image->alpha = external_alpha_buf;
+            } else {
+                image->ownedAlpha = std::move(original_alpha);
+                image->alpha      = &image->ownedAlpha;
+            }
+            if (!external_alpha && settings.outputScale > 0) {
+                ImageBuf scaled_alpha_buf;
+                if (!scaleAlphaToLevel(scaled_alpha_buf, *image->alpha, level)) {
+                    reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+                    return false;
+                }
+                image->ownedAlpha = std::move(scaled_alpha_buf);
+                image->alpha      = &image->ownedAlpha;
             }
         }
         // reset unused buffers
-        rgba_buf.clear();
-        if (external_alpha) {
-            bit_alpha_buf.clear();
-            original_bit_alpha_buf.clear();
-        } else {
-            original_alpha.clear();
-        }
+        original_alpha.clear();
 
 #if 0
         debugImageBufWrite(result_buf, "d:/result_buf.tif");
 #endif
 
-        out_format = result_buf.spec().format;  // copy latest buffer format as an output format
-        spdlog::info("Push-Pull format: {}", formatText(out_format));
+        image->filled = true;
+        spdlog::info("Push-Pull format: {}", formatText(result_buf.spec().format));
+        if (settings.outputScale > 0) {
+            spdlog::info("Push-Pull output level {}: {}x{}", settings.outputScale, result_buf.spec().width,
+                         result_buf.spec().height);
+        }
         spdlog::info("Push-Pull time : {}", pushpull_timer.nowText());
     } else {
-        result_buf = input_buf;
+        result_buf = std::move(input_buf);
         spdlog::info("Filling holes skipped\n");
+        if (settings.outputScale > 0) {
+            spdlog::info("Output scale needs the push-pull pyramid, writing full resolution");
+        }
     }
+    return true;
+}
 
-    if ((settings.normMode == 2) || (isNormName && settings.normMode != 0)) {
-        doNormalize = true;
+// The passes writeSolidifyTarget runs on the fill result, in order. Empty when the target writes the fill as is.
+static std::vector<PostFillOp>
+postFillOps(const SolidifyResult& image, const Settings& target, const bool doNormalize, const float inCenter,
+            const float outCenter, const float outScale)
+{
+    std::vector<PostFillOp> ops;
+
+    // Preserve and mask targets put the source alpha back over the fill coverage.
+    if (image.filled && image.alpha && target.alphaMode != 0) {
+        PostFillOp op;
+        op.kind  = PostFillOp::ReplaceAlpha;
+        op.alpha = image.alpha;
+        // The fill margin lies outside the source data window, where the original alpha is zero.
+        op.clearOutside = settings.fillMargin != 0;
+        ops.push_back(op);
     }
 
-    if (settings.repairMode > 0) {
-        VTimer normalize_timer;
-        bool success = true;
-        int sign     = 1;
+    if (target.repairMode > 0) {
+        PostFillOp op;
+        op.kind    = PostFillOp::RecalcNormal;
+        op.channel = target.repairMode - 1;
+        op.sign    = 1;
+        if (target.repairMode > 4) {
+            op.sign    = -1;
+            op.channel = target.repairMode - 4;
+        }
+        op.inCenter  = inCenter;
+        op.outCenter = outCenter;
+        op.scale     = outScale;
+        ops.push_back(op);
+    } else if (doNormalize) {
+        if (!image.normalized) {
+            PostFillOp op;
+            op.kind      = PostFillOp::Normalize;
+            op.inCenter  = inCenter;
+            op.outCenter = outCenter;
+            op.scale     = outScale;
+            ops.push_back(op);
+        }
+    } else if (target.rangeMode > 1) {
+        // 2 - signed -> unsigned, 3 - unsigned -> signed
+        PostFillOp op;
+        op.kind   = PostFillOp::RangeRemap;
+        op.scale  = target.rangeMode == 2 ? 0.5f : 2.0f;
+        op.offset = target.rangeMode == 2 ? 0.5f : -1.0f;
+        ops.push_back(op);
+    }
 
-        spdlog::info("Repairing normals in process...\n");
+    if (target.swapBasis != 0 || target.swapInvertMask != 0) {
+        PostFillOp op;
+        op.kind        = PostFillOp::SwapInvert;
+        op.basis       = target.swapBasis;
+        op.invertMask  = target.swapInvertMask;
+        op.signedRange = target.rangeMode == 1 || target.rangeMode == 3;
+        ops.push_back(op);
+    }
 
-        uint channel = settings.repairMode - 1;
+    if (target.grayscaleMode != 0) {
+        PostFillOp op;
+        op.kind = PostFillOp::Grayscale;
+        op.mode = target.grayscaleMode;
+        std::copy(target.grayscaleWeights, target.grayscaleWeights + 3, op.weights);
+        op.preserveAlpha = target.alphaMode == 1;
+        ops.push_back(op);
+    }
+    return ops;
+}
 
-        if (settings.repairMode > 4) {
-            sign    = -1;
-            channel = settings.repairMode - 4;
+// Runs the post-fill passes one at a time on a copy of image.result, for layouts applyPostFillOps does not take.
+static bool
+runPostFillOpsSeparately(ImageBuf& out_buf, const SolidifyResult& image, const std::vector<PostFillOp>& ops,
+                         TypeDesc* out_format)
+{
+    int nthreads = 0;  // debug time 1 thread, for release use 0
+
+    out_buf = image.result.copy();
+    countImageCopy(image, out_buf);
+    for (const PostFillOp& op : ops) {
+        switch (op.kind) {
+        case PostFillOp::ReplaceAlpha: {
+            const ImageBuf& alpha_buf = *op.alpha;
+            const int alphaChannel    = out_buf.spec().alpha_channel;
+            if (op.clearOutside) {
+                ImageBufAlgo::zero(out_buf, ROI(out_buf.xbegin(), out_buf.xend(), out_buf.ybegin(), out_buf.yend(), 0,
+                                                1, alphaChannel, alphaChannel + 1));
+            }
+            ImageBufAlgo::paste(out_buf, alpha_buf.xbegin(), alpha_buf.ybegin(), 0, alphaChannel, alpha_buf);
+            if (out_buf.has_error()) {
+                spdlog::error("paste error: {}", out_buf.geterror());
+                return false;
+            }
+            break;
         }
-
-        ROI roi(0, result_buf.spec().width, 0, result_buf.spec().height, 0, 1, 0, result_buf.spec().nchannels);
-        int nthreads   = 0;  // debug time 1 thread, for release use 0
-        float inCenter = 0.5f, outCenter = 0.5f, outScale = 0.5f;
-
-        switch (settings.rangeMode) {
-        case 0:
-            inCenter  = 0.5f;
-            outCenter = 0.5f;
-            outScale  = 0.5f;
+        case PostFillOp::RecalcNormal:
+            if (!applyNormalRecalc(out_buf, out_buf, op.channel, op.sign, op.inCenter, op.outCenter, op.scale,
+                                   nthreads)) {
+                spdlog::debug("{}; using the iterator path", out_buf.geterror());
+                ImageBuf repaired_buf;
+                if (!recalc_normal(repaired_buf, out_buf, op.channel, op.sign, op.inCenter, op.outCenter, op.scale,
+                                   out_buf.roi(), nthreads)) {
+                    spdlog::error("Error: Could not repair normals");
+                    spdlog::error("{}", repaired_buf.geterror());
+                    return false;
+                }
+                out_buf = std::move(repaired_buf);
+            }
             break;
-        case 1:
-            inCenter  = 0.0f;
-            outCenter = 0.0f;
-            outScale  = 1.0f;
+        case PostFillOp::Normalize:
+            if (!applyNormalize(out_buf, out_buf, op.inCenter, op.outCenter, op.scale, nthreads)) {
+                spdlog::debug("{}; using ImageBufAlgo::normalize", out_buf.geterror());
+                ImageBuf normalized_buf;
+                if (!ImageBufAlgo::normalize(normalized_buf, out_buf, op.inCenter, op.outCenter, op.scale,
+                                             out_buf.roi(), nthreads)) {
+                    spdlog::error("Error: Could not normalize image");
+                    return false;
+                }
+                out_buf = std::move(normalized_buf);
+            }
+            *out_format = out_buf.spec().format;  // copy latest buffer format as an output format
             break;
-        case 2:
-            inCenter  = 0.0f;
-            outCenter = 0.5f;
-            outScale  = 0.5f;
+        case PostFillOp::RangeRemap:
+            if (!applyRangeRemap(out_buf, out_buf, op.scale, op.offset, nthreads)) {
+                spdlog::debug("{}; using ImageBufAlgo::mad", out_buf.geterror());
+                if (!ImageBufAlgo::mad(out_buf, out_buf, op.scale, op.offset)) {
+                    spdlog::error("Error: Could not convert range");
+                    spdlog::error("{}", out_buf.geterror());
+                    return false;
+                }
+            }
+            break;
+        case PostFillOp::SwapInvert:
+            spdlog::info("Applying channel swap/invert...\n");
+            if (!applyChannelSwapInvert(out_buf, out_buf, op.basis, op.invertMask, op.signedRange, nthreads)) {
+                spdlog::error("Error: Could not apply channel swap/invert");
+                spdlog::error("{}", out_buf.geterror());
+                return false;
+            }
+            *out_format = out_buf.spec().format;
             break;
-        case 3:
-            inCenter  = 0.5f;
-            outCenter = 0.0f;
-            outScale  = 1.0f;
+        case PostFillOp::Grayscale:
+            spdlog::info("Applying grayscale conversion...\n");
+            if (!applyGrayscale(out_buf, out_buf, op.mode, op.weights, op.preserveAlpha, nthreads)) {
+                spdlog::error("Error: Could not apply grayscale conversion");
+                spdlog::error("{}", out_buf.geterror());
+                return false;
+            }
+            *out_format = out_buf.spec().format;
             break;
-        default: break;
         }
-
-        success     = recalc_normal(out_buf, result_buf, channel, sign, inCenter, outCenter, outScale, roi, nthreads);
-        doNormalize = false;
     }
+    return true;
+}
 
-    if (doNormalize) {
-        VTimer normalize_timer;
-        bool success = true;
+// Writes outputFileName from a filled image: alpha, post-fill passes, format, bit depth and encoder all come from
+// target, so several targets can be written from one image at the same time. releaseResult, when set, is
+// image.result of a single target: it is freed once the passes have written their own buffer, before encoding.
+static bool
+writeSolidifyTarget(const SolidifyResult& image, const std::string& inputFileName, const std::string& outputFileName,
+                    const Settings& target, VTimer g_timer, const SolidifyProgressCallback& progressCallback,
+                    ImageBuf* releaseResult = nullptr)
+{
+    TypeDesc out_format = image.result.spec().format;
+    bool grayscale      = image.grayscale;
+    bool isNormName     = isNormalMapName(inputFileName);
 
-        ROI roi(0, result_buf.spec().width, 0, result_buf.spec().height, 0, 1, 0, result_buf.spec().nchannels);
-        int nthreads   = 0;  // debug time 1 thread, for release use 0
-        float inCenter = 0.5f, outCenter = 0.5f, outScale = 0.5f;
-        switch (settings.rangeMode) {
-        case 0:
-            inCenter  = 0.5f;
-            outCenter = 0.5f;
-            outScale  = 0.5f;
-            break;
-        case 1:
-            inCenter  = 0.0f;
-            outCenter = 0.0f;
-            outScale  = 1.0f;
-            break;
-        case 2:
-            inCenter  = 0.0f;
-            outCenter = 0.5f;
-            outScale  = 0.5f;
-            break;
-        case 3:
-            inCenter  = 0.5f;
-            outCenter = 0.0f;
-            outScale  = 1.0f;
-            break;
-        default: break;
-        }
+    bool doNormalize = (target.normMode == 2) || (isNormName && target.normMode != 0);
 
-        success = ImageBufAlgo::normalize(out_buf, result_buf, inCenter, outCenter, outScale, roi, nthreads);
-        if (!success) {
-            spdlog::error("Error: Could not normalize image");
-            reportProgress(progressCallback, 0.0f, "Error! Check console for details");
-            return false;
-        }
-        out_format = out_buf.spec().format;  // copy latest buffer format as an output format
-        spdlog::info("Normalized format: {}", formatText(out_format));
-        spdlog::info("Normalize time : {}", normalize_timer.nowText());
-    } else if (settings.repairMode == 0) {
-        out_buf = result_buf;
+    float inCenter = 0.5f, outCenter = 0.5f, outScale = 0.5f;
+    rangeCenters(target.rangeMode, &inCenter, &outCenter, &outScale);
+
+    if (target.repairMode > 0) {
+        spdlog::info("Repairing normals in process...\n");
+        doNormalize = false;
+    } else if (!doNormalize) {
         spdlog::info("Normalize skipped\n");
     }
 
-    // if not normalize and not repair and range conversion is needed
-    if (settings.repairMode == 0 && !doNormalize && settings.rangeMode > 1) {
-        switch (settings.rangeMode) {
-        case 2:  // 2 - signed -> unsigned
-            out_buf = ImageBufAlgo::mad(out_buf, 0.5f, 0.5f);
-            break;
-        case 3:  // 3 - unsigned -> signed
-            out_buf = ImageBufAlgo::mad(out_buf, 2.0f, -1.0f);
-            break;
+    // The shared fill result is only ever read: the passes write a buffer this target owns, and a target without
+    // passes writes the fill result's pixels directly.
+    const std::vector<PostFillOp> ops = postFillOps(image, target, doNormalize, inCenter, outCenter, outScale);
+    ImageBuf out_buf;
+    if (ops.empty()) {
+        if (image.result.localpixels() != nullptr) {
+            out_buf = ImageBuf(image.result.spec(), const_cast<void*>(image.result.localpixels()),
+                               image.result.pixel_stride(), image.result.scanline_stride());
+        } else {
+            out_buf = image.result;
+            countImageCopy(image, out_buf);
+        }
+    } else {
+        VTimer postfill_timer;
+        if (applyPostFillOps(out_buf, image.result, ops, 0)) {
+            spdlog::info("Post-fill passes : {} in one pass, time : {}", ops.size(), postfill_timer.nowText());
+        } else {
+            spdlog::debug("{}; running post-fill passes one by one", out_buf.geterror());
+            if (!runPostFillOpsSeparately(out_buf, image, ops, &out_format)) {
+                reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+                return false;
+            }
+            spdlog::info("Post-fill passes : {}, time : {}", ops.size(), postfill_timer.nowText());
+        }
+        if (doNormalize) {
+            spdlog::info("Normalized format: {}", formatText(out_format));
+        }
+        if (target.swapBasis != 0 || target.swapInvertMask != 0 || target.grayscaleMode != 0) {
+            grayscale = out_buf.nchannels() <= 2;
+        }
+        if (releaseResult) {
+            releaseResult->clear();
         }
     }
 
-    if (settings.swapBasis != 0 || settings.swapInvertMask != 0) {
-        VTimer transform_timer;
-        ImageBuf transformed_buf;
-        const bool signedOutputRange = settings.rangeMode == 1 || settings.rangeMode == 3;
-        spdlog::info("Applying channel swap/invert...\n");
-        const bool success = applyChannelSwapInvert(transformed_buf, out_buf, settings.swapBasis,
-                                                    settings.swapInvertMask, signedOutputRange, 0);
-        if (!success) {
-            spdlog::error("Error: Could not apply channel swap/invert");
-            spdlog::error("{}", transformed_buf.geterror());
-            reportProgress(progressCallback, 0.0f, "Error! Check console for details");
-            return false;
-        }
-        out_buf    = std::move(transformed_buf);
-        out_format = out_buf.spec().format;
-        grayscale  = out_buf.nchannels() <= 2;
-        spdlog::info("Channel swap/invert time : {}", transform_timer.nowText());
-    }
-
-    if (settings.grayscaleMode != 0) {
-        VTimer grayscale_timer;
-        ImageBuf grayscale_buf;
-        spdlog::info("Applying grayscale conversion...\n");
-        const bool success = applyGrayscale(grayscale_buf, out_buf, settings.grayscaleMode, settings.grayscaleWeights,
-                                            settings.alphaMode == 1, 0);
-        if (!success) {
-            spdlog::error("Error: Could not apply grayscale conversion");
-            spdlog::error("{}", grayscale_buf.geterror());
-            reportProgress(progressCallback, 0.0f, "Error! Check console for details");
-            return false;
+    // Lower levels of a tiled, MIP-mapped output. They come straight from the push-pull pyramid when the written
+    // pixels are the fill result, and are resampled from the processed image otherwise.
+    bool writeMips = target.mipmapOutput && canWriteMipmapped(outputFileName);
+    std::vector<ImageBuf> resampled_mip_levels;
+    const std::vector<ImageBuf>* mip_levels = usesPyramidMipLevels(inputFileName, target) ? &image.mipLevels
+                                                                                           : &resampled_mip_levels;
+    if (writeMips) {
+        const ImageSpec& spec = out_buf.spec();
+        if (spec.x != 0 || spec.y != 0 || spec.full_x != 0 || spec.full_y != 0 || spec.width != spec.full_width
+            || spec.height != spec.full_height) {
+            spdlog::info("MIP levels need the data window to match the display window, writing a single level");
+            writeMips = false;
+        } else if (mip_levels->empty()) {
+            VTimer mip_timer;
+            const std::string filter = target.mipFilter.empty() ? std::string("box") : target.mipFilter;
+            mip_levels               = &resampled_mip_levels;
+            if (!resampleMipLevels(&resampled_mip_levels, out_buf, filter)) {
+                reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+                return false;
+            }
+            spdlog::info("MIP levels resampled with {} filter, time : {}", filter, mip_timer.nowText());
+        } else {
+            spdlog::info("MIP levels taken from the push-pull pyramid");
         }
-        out_buf    = std::move(grayscale_buf);
-        out_format = out_buf.spec().format;
-        grayscale  = true;
-        spdlog::info("Grayscale conversion time : {}", grayscale_timer.nowText());
     }
 
     const int outputBufferChannels = out_buf.nchannels();
@@ -546,10 +1308,10 @@ solidify_main(const std::string& inputFileName, const std::string& outputFileNam
                                          : (out_buf.nchannels() == 4 ? 3 : (out_buf.nchannels() == 2 ? 1 : -1));
 
     ImageSpec& ospec = out_buf.specmod();
-    if (settings.alphaMode == 1 && outputAlphaChannel >= 0) {
+    if (target.alphaMode == 1 && outputAlphaChannel >= 0) {
         ospec.nchannels = grayscale ? std::min(2, outputBufferChannels)
                                     : std::min(4, outputBufferChannels);  // Write RGB and alpha channels
-    } else if (settings.alphaMode == 0) {
+    } else if (target.alphaMode == 0) {
         ospec.nchannels = grayscale ? 1 : std::min(3, outputBufferChannels);  // Only write RGB channels
     } else {
         ospec.nchannels = 1;  // Only write alpha channel
@@ -626,15 +1388,35 @@ solidify_main(const std::string& inputFileName, const std::string& outputFileNam
 
 
     ospec.alpha_channel = -1;  // No alpha channel
-    if (getTypeDesc(settings.bitDepth) == TypeDesc::UNKNOWN) {
-        ospec.set_format(orig_format);
+    if (getTypeDesc(target.bitDepth) == TypeDesc::UNKNOWN) {
+        ospec.set_format(image.origFormat);
     } else {
-        ospec.set_format(getTypeDesc(settings.bitDepth));
+        ospec.set_format(getTypeDesc(target.bitDepth));
+    }
+    applyEncoderSettings(ospec, outputFileName, target);
+    if (writeMips) {
+        ospec.tile_width  = 64;
+        ospec.tile_height = 64;
+        ospec.tile_depth  = 1;
+        ospec.attribute("textureformat", "Plain Texture");
     }
-    applyEncoderSettings(ospec, outputFileName, settings);
 
     spdlog::info("Output file format: {}", formatText(ospec.format));
 
+    if (target.zeroCopy && canWriteMappedImage(outputFileName, ospec.nchannels, ospec.format)) {
+        const int first_channel = target.alphaMode == 2 && outputAlphaChannel >= 0 ? outputAlphaChannel : 0;
+        const char* pixels      = (const char*)out_buf.localpixels() + first_channel * out_format.size();
+        spdlog::info("Writing {} through a mapped file", outputFileName);
+        if (writeMappedImage(outputFileName, ospec.width, ospec.height, ospec.nchannels, ospec.format, out_format,
+                             pixels, out_buf.pixel_stride(), out_buf.scanline_stride())) {
+            spdlog::info("File processing time : {}", g_timer.nowText());
+            reportProgress(progressCallback, 1.0f,
+                           "Written: " + std::filesystem::path(outputFileName).filename().string());
+            return true;
+        }
+        spdlog::warn("Mapped write of {} failed, using OIIO writer", outputFileName);
+    }
+
     auto out = ImageOutput::create(outputFileName);
     if (!out) {
         spdlog::error("Could not create output file: {}", outputFileName);
@@ -660,7 +1442,7 @@ solidify_main(const std::string& inputFileName, const std::string& outputFileNam
     writeCtx.scale          = 0.35f;
     void* writeProgressData = progressCallback ? &writeCtx : nullptr;
 
-    if (settings.alphaMode != 2) {
+    if (target.alphaMode != 2) {
         ok = out->write_image(out_format, out_buf.localpixels(), out_buf.pixel_stride(), out_buf.scanline_stride(),
                               out_buf.z_stride(), m_progress_callback, writeProgressData);
     } else {
@@ -676,6 +1458,10 @@ solidify_main(const std::string& inputFileName, const std::string& outputFileNam
                               out_buf.z_stride(),                // z stride
                               m_progress_callback, writeProgressData);
     }
+    if (ok && writeMips) {
+        const int first_channel = target.alphaMode == 2 && outputAlphaChannel >= 0 ? outputAlphaChannel : 0;
+        ok = writeMipLevels(*out, outputFileName, ospec, *mip_levels, first_channel);
+    }
 
     if (!ok) {
         spdlog::error("Error writing {}", outputFileName);
@@ -691,3 +1477,226 @@ solidify_main(const std::string& inputFileName, const std::string& outputFileNam
 
     return true;
 }
+
+std::string
+distanceFieldFileName(const std::string& outputFileName)
+{
+    std::filesystem::path path(outputFileName);
+    path.replace_filename(path.stem().string() + "_distance.exr");
+    return path.string();
+}
+
+// Writes the distance field of a dilation fill next to outputFileName. Images without one write nothing.
+static bool
+writeDistanceField(const SolidifyResult& image, const std::string& outputFileName)
+{
+    if (!image.distance.initialized()) {
+        return true;
+    }
+    const std::filesystem::path path(distanceFieldFileName(outputFileName));
+    if (!image.distance.write(path.string())) {
+        spdlog::error("Error writing {}", path.string());
+        spdlog::error("{}", image.distance.geterror());
+        return false;
+    }
+    spdlog::info("Distance field written to {}", path.string());
+    return true;
+}
+
+// Reader configuration shared by every in-memory input.
+static ImageSpec
+inputConfig()
+{
+    ImageSpec config;
+    config["raw:user_flip"] = settings.rawRot;
+    //config["oiio:reorient"] = 0;
+
+    config["oiio:UnassociatedAlpha"] = 1;
+    config["tiff:UnassociatedAlpha"] = 0;
+    config["oiio:ColorSpace"]        = "Linear";
+    return config;
+}
+
+bool
+solidify_main(const std::string& inputFileName, const std::string& outputFileName,
+              const MaskBuffers& maskBuffers, const SolidifyProgressCallback& progressCallback, SolidifyStats* stats)
+{
+    VTimer g_timer;
+
+    ImageSpec config = inputConfig();
+
+    // Declared before input_buf: a mapped input wraps pixels owned by this mapping.
+    std::unique_ptr<MappedImage> input_mapping;
+    ImageBuf input_buf(inputFileName, 0, 0, nullptr, &config, nullptr);
+
+    if (!input_buf.init_spec(inputFileName, 0, 0)) {
+        spdlog::error("Error reading {}", inputFileName);
+        spdlog::error("{}", input_buf.geterror());
+        reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+        return false;
+    }
+
+    //   // check EXIF rotation
+    //   int orientation = 1;
+    //   auto& tspec = input_buf.spec();
+    //   auto& extspec = tspec.extra_attribs;
+    //   for (auto& attr : extspec) {
+    //	std::string name = attr.name().string();
+    //	std::string value = attr.get_string();
+    //	spdlog::info) << name << " : " << value << std::endl;
+    //}
+
+    spdlog::info("File bith depth: {}", formatText(input_buf.spec().format));
+
+    //ImageBuf::ImageBuf(config, input_buf);
+
+    bool external_alpha = false;
+
+    if (!settings.useAlpha && maskBuffers.alpha.initialized()) {
+        external_alpha = true;
+    }
+
+    if (canStreamAlphaExport(input_buf.spec(), external_alpha)) {
+        const int alphaChannel = input_buf.nchannels() - 1;
+        spdlog::info("Mask export, streaming alpha channel {} only", alphaChannel);
+        return streamConvert(inputFileName, outputFileName, config, alphaChannel, alphaChannel + 1,
+                             progressCallback);
+    }
+    if (canStreamConvert(input_buf.spec(), inputFileName, external_alpha)) {
+        spdlog::info("Conversion only, streaming scanlines without a full image buffer");
+        return streamConvert(inputFileName, outputFileName, config, 0, streamConvertChannels(input_buf.spec()),
+                             progressCallback);
+    }
+
+    const int nsubimages = input_buf.nsubimages();
+    if (nsubimages > 1) {
+        if (canSolidifySubimages(inputFileName, outputFileName, external_alpha)) {
+            if (settings.mipmapOutput) {
+                spdlog::info("Subimage output is written without MIP levels");
+            }
+            return solidifySubimages(inputFileName, outputFileName, config, progressCallback);
+        }
+        spdlog::info("{} has {} subimages, only subimage 0 is processed", inputFileName, nsubimages);
+    }
+
+    if (settings.outOfCore) {
+        if (canSolidifyOutOfCore(input_buf.spec(), inputFileName, external_alpha)) {
+            if (settings.mipmapOutput) {
+                spdlog::info("Out-of-core output is written without MIP levels");
+            }
+            return solidifyOutOfCore(inputFileName, outputFileName, config, input_buf.spec(), progressCallback);
+        }
+        spdlog::info("Out-of-core push-pull needs embedded alpha and no post-fill passes, using in-memory path");
+    }
+
+    const bool pyramidMipLevels = usesPyramidMipLevels(inputFileName, settings) && canWriteMipmapped(outputFileName);
+    SolidifyResult image;
+    const Settings* normalTarget = normalizesFill(inputFileName, settings) ? &settings : nullptr;
+    if (!loadSolidifyResult(input_buf, &input_mapping, inputFileName, external_alpha, maskBuffers,
+                            settings.alphaMode != 0, pyramidMipLevels, normalTarget, &image, progressCallback)) {
+        return false;
+    }
+    input_buf.clear();
+    const bool ok = writeSolidifyTarget(image, inputFileName, outputFileName, settings, g_timer, progressCallback,
+                                        &image.result)
+                    && writeDistanceField(image, outputFileName);
+    spdlog::debug("Whole-image copies for {}: {} bytes", inputFileName, image.copiedBytes.load());
+    if (stats) {
+        stats->copiedBytes = image.copiedBytes.load();
+    }
+    return ok;
+}
+
+bool
+solidify_single_output(const std::string& inputFileName, const std::string& outputFileName, bool external_alpha)
+{
+    ImageSpec config = inputConfig();
+    auto in          = ImageInput::open(inputFileName, &config);
+    if (!in) {
+        // solidify_outputs reports the read error.
+        return false;
+    }
+    const ImageSpec spec = in->spec();
+    const bool subimages = in->seek_subimage(1, 0);
+    in->close();
+
+    if (subimages && canSolidifySubimages(inputFileName, outputFileName, external_alpha)) {
+        spdlog::warn("{} has several subimages, writing every one to {} and skipping the [[Outputs]] tables",
+                     inputFileName, outputFileName);
+        return true;
+    }
+    if (settings.outOfCore && canSolidifyOutOfCore(spec, inputFileName, external_alpha)) {
+        spdlog::warn("{} is filled out-of-core, writing {} and skipping the [[Outputs]] tables", inputFileName,
+                     outputFileName);
+        return true;
+    }
+    return false;
+}
+
+bool
+solidify_outputs(const std::string& inputFileName, const std::vector<SolidifyTarget>& targets,
+                 const MaskBuffers& maskBuffers, const SolidifyProgressCallback& progressCallback)
+{
+    VTimer g_timer;
+
+    ImageSpec config = inputConfig();
+
+    // Declared before input_buf: a mapped input wraps pixels owned by this mapping.
+    std::unique_ptr<MappedImage> input_mapping;
+    ImageBuf input_buf(inputFileName, 0, 0, nullptr, &config, nullptr);
+    if (!input_buf.init_spec(inputFileName, 0, 0)) {
+        spdlog::error("Error reading {}", inputFileName);
+        spdlog::error("{}", input_buf.geterror());
+        reportProgress(progressCallback, 0.0f, "Error! Check console for details");
+        return false;
+    }
+
+    if (input_buf.nsubimages() > 1) {
+        spdlog::info("{} has {} subimages, only subimage 0 is processed", inputFileName, input_buf.nsubimages());
+    }
+
+    const bool external_alpha    = !settings.useAlpha && maskBuffers.alpha.initialized();
+    bool keepAlpha               = false;
+    bool pyramidMipLevels        = false;
+    const Settings* normalTarget = targets.empty() ? nullptr : &targets.front().settings;
+    for (const SolidifyTarget& target : targets) {
+        keepAlpha        = keepAlpha || target.settings.alphaMode != 0;
+        pyramidMipLevels = pyramidMipLevels
+                           || (usesPyramidMipLevels(inputFileName, target.settings)
+                               && canWriteMipmapped(target.outputFileName));
+        // The fill can only come back normalized when every target would normalize it to the same range.
+        if (normalTarget
+            && (!normalizesFill(inputFileName, target.settings)
+                || target.settings.rangeMode != normalTarget->rangeMode)) {
+            normalTarget = nullptr;
+        }
+    }
+
+    spdlog::info("Decoding and filling {} once for {} outputs", inputFileName, targets.size());
+    SolidifyResult image;
+    if (!loadSolidifyResult(input_buf, &input_mapping, inputFileName, external_alpha, maskBuffers, keepAlpha,
+                            pyramidMipLevels, normalTarget, &image, progressCallback)) {
+        return false;
+    }
+    input_buf.clear();
+
+    // Every target only reads the shared result, so the post-fill passes and encoders run side by side.
+    std::vector<std::future<bool>> writes;
+    writes.reserve(targets.size());
+    for (const SolidifyTarget& target : targets) {
+        auto write = [&image, &inputFileName, &target, &progressCallback, g_timer]() {
+            return writeSolidifyTarget(image, inputFileName, target.outputFileName, target.settings, g_timer,
+                                       progressCallback);
+        };
+        writes.push_back(std::async(std::launch::async, write));
+    }
+    bool ok = true;
+    for (std::future<bool>& write : writes) {
+        ok = write.get() && ok;
+    }
+    for (const SolidifyTarget& target : targets) {
+        ok = writeDistanceField(image, target.outputFileName) && ok;
+    }
+    spdlog::debug("Whole-image copies for {}: {} bytes", inputFileName, image.copiedBytes.load());
+    return ok;
+}
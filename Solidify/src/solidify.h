@@ -20,13 +20,46 @@
 
 #include "imageio.h"
 #include "processing.h"
+#include "settings.h"
 
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/imageio.h>
 
+#include <string>
+#include <vector>
+
 using namespace OIIO;
 
+// Counters of one solidify_main run, filled in when the input goes through the in-memory path.
+struct SolidifyStats {
+    size_t copiedBytes = 0;  // Bytes of whole-image copies made after the input was loaded
+};
+
 bool
 solidify_main(const std::string& inputFileName, const std::string& outputFileName,
-              const MaskBuffers& maskBuffers, const SolidifyProgressCallback& progressCallback);
+              const MaskBuffers& maskBuffers, const SolidifyProgressCallback& progressCallback,
+              SolidifyStats* stats = nullptr);
+
+// One output of solidify_outputs: the file to write and the settings that pick its alpha mode, post-fill passes,
+// format, bit depth and encoder.
+struct SolidifyTarget {
+    std::string outputFileName;
+    Settings settings;
+};
+
+// <output stem>_distance.exr next to outputFileName, where a dilation fill with DilateDistance set writes its distance
+// field.
+std::string
+distanceFieldFileName(const std::string& outputFileName);
+
+// True when inputFileName takes a path of solidify_main that writes every subimage or fills out-of-core into
+// outputFileName. solidify_outputs decodes subimage 0 into memory, so such inputs get a single output instead.
+bool
+solidify_single_output(const std::string& inputFileName, const std::string& outputFileName, bool external_alpha);
+
+// Decodes and fills inputFileName once with the global settings, then writes every target from that one result in
+// parallel.
+bool
+solidify_outputs(const std::string& inputFileName, const std::vector<SolidifyTarget>& targets,
+                 const MaskBuffers& maskBuffers, const SolidifyProgressCallback& progressCallback);
@@ -17,14 +17,20 @@
  */
 
 #include "imageops.h"
+#include "mappedimage.h"
 
+#include <OpenImageIO/half.h>
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include <cstdint>
+#include <filesystem>
 #include <iostream>
 #include <limits>
+#include <vector>
 
 namespace {
 
@@ -151,6 +157,363 @@ static void testGrayscaleU16()
     EXPECT_TRUE(arbitraryPixels[1] == std::numeric_limits<uint16_t>::max());
 }
 
+static void testAlphaPreprocessU16()
+{
+    const int width = 37;
+    OIIO::ImageSpec spec(width, 2, 4, OIIO::TypeDesc::UINT16);
+    spec.alpha_channel = 3;
+    OIIO::ImageBuf image(spec);
+    uint16_t* pixels = static_cast<uint16_t*>(image.localpixels());
+    for (int i = 0; i < width * 2; ++i) {
+        pixels[i * 4 + 0] = static_cast<uint16_t>(65535 - i * 811);
+        pixels[i * 4 + 1] = static_cast<uint16_t>(i * 977);
+        pixels[i * 4 + 2] = 40000;
+        pixels[i * 4 + 3] = static_cast<uint16_t>(i * 887);
+    }
+    const OIIO::ImageBuf input = image.copy();
+
+    OIIO::ImageBuf original;
+    EXPECT_TRUE(applyAlphaPreprocess(image, 2.2f, true, &original, 1));
+    EXPECT_TRUE(original.nchannels() == 1 && original.spec().format == OIIO::TypeDesc::UINT16);
+
+    const uint16_t* in   = u16Pixels(input);
+    const uint16_t* out  = u16Pixels(image);
+    const uint16_t* orig = u16Pixels(original);
+    for (int i = 0; i < width * 2; ++i) {
+        const double shaped = std::floor(std::pow(in[i * 4 + 3] / 65535.0, 1.0 / 2.2) * 65535.0 + 0.5);
+        EXPECT_TRUE(orig[i] == in[i * 4 + 3]);
+        EXPECT_TRUE(out[i * 4 + 3] == static_cast<uint16_t>(shaped));
+        for (int c = 0; c < 3; ++c) {
+            const double expected = std::floor(in[i * 4 + c] * shaped / 65535.0 + 0.5);
+            EXPECT_TRUE(out[i * 4 + c] == static_cast<uint16_t>(expected));
+        }
+    }
+}
+
+static void testAlphaPreprocessFloat()
+{
+    OIIO::ImageSpec spec(5, 1, 2, OIIO::TypeDesc::FLOAT);
+    spec.alpha_channel = 1;
+    OIIO::ImageBuf image(spec);
+    float* pixels            = static_cast<float*>(image.localpixels());
+    const float alphas[5]    = { -0.5f, 0.0f, 0.25f, 1.0f, 1.5f };
+    for (int i = 0; i < 5; ++i) {
+        pixels[i * 2 + 0] = 0.8f;
+        pixels[i * 2 + 1] = alphas[i];
+    }
+    OIIO::ImageBuf unshaped = image.copy();
+
+    EXPECT_TRUE(applyAlphaPreprocess(image, 2.0f, true, nullptr, 1));
+    const float* out = f32Pixels(image);
+    for (int i = 0; i < 5; ++i) {
+        const float shaped = std::sqrt(std::min(std::max(alphas[i], 0.0f), 1.0f));
+        EXPECT_NEAR_VALUE(out[i * 2 + 1], shaped, 0.00001f, "shaped float alpha");
+        EXPECT_NEAR_VALUE(out[i * 2 + 0], 0.8f * shaped, 0.00001f, "premultiplied float gray");
+    }
+
+    // Gamma 1 leaves alpha unclamped, as the multi-pass path did.
+    EXPECT_TRUE(applyAlphaPreprocess(unshaped, 1.0f, true, nullptr, 1));
+    out = f32Pixels(unshaped);
+    EXPECT_NEAR_VALUE(out[9], 1.5f, 0.00001f, "unshaped float alpha");
+    EXPECT_NEAR_VALUE(out[8], 1.2f, 0.00001f, "premultiplied by raw alpha");
+
+    OIIO::ImageBuf rgb(OIIO::ImageSpec(2, 1, 3, OIIO::TypeDesc::FLOAT));
+    EXPECT_TRUE(!applyAlphaPreprocess(rgb, 2.2f, true, nullptr, 1));
+    EXPECT_TRUE(rgb.has_error());
+}
+
+// Reference math of ImageBufAlgo::normalize and recalc_normal, one pixel at a time.
+static void normalizeReference(float c[3], float inCenter, float outCenter, float scale)
+{
+    const float x      = c[0] - inCenter;
+    const float y      = c[1] - inCenter;
+    const float z      = c[2] - inCenter;
+    const float length = std::sqrt(x * x + y * y + z * z);
+    const float s      = length > 0.0f ? scale / length : 0.0f;
+    c[0]               = x * s + outCenter;
+    c[1]               = y * s + outCenter;
+    c[2]               = z * s + outCenter;
+}
+
+static void recalcReference(float c[3], int channel, int sign, float inCenter, float outCenter, float scale)
+{
+    float t[3];
+    for (int i = 0; i < 3; ++i) {
+        t[i] = i == channel ? 0.0f : (c[i] - inCenter) / scale;
+    }
+    const bool isZero  = std::fabs(t[0]) + std::fabs(t[1]) + std::fabs(t[2]) == 0.0f;
+    const float recomp = isZero ? 0.0f : std::sqrt(std::max(0.0f, 1.0f - (t[0] * t[0] + t[1] * t[1] + t[2] * t[2])));
+    t[channel]         = sign * recomp;
+    const float length = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+    const float s      = length > 0.0f ? scale / length : scale;
+    for (int i = 0; i < 3; ++i) {
+        c[i] = t[i] * s + outCenter;
+    }
+}
+
+static int codeDistance(uint16_t actual, float expected)
+{
+    const float code = std::min(std::max(expected * 65535.0f + 0.5f, 0.0f), 65535.0f);
+    return std::abs(static_cast<int>(actual) - static_cast<int>(code));
+}
+
+static void testNormalizeU16InPlace()
+{
+    const int width = 19;
+    OIIO::ImageSpec spec(width, 1, 4, OIIO::TypeDesc::UINT16);
+    OIIO::ImageBuf image(spec);
+    uint16_t* pixels = static_cast<uint16_t*>(image.localpixels());
+    for (int i = 0; i < width; ++i) {
+        pixels[i * 4 + 0] = static_cast<uint16_t>(1000 + i * 3100);
+        pixels[i * 4 + 1] = static_cast<uint16_t>(60000 - i * 2900);
+        pixels[i * 4 + 2] = static_cast<uint16_t>(40000 + i * 1000);
+        pixels[i * 4 + 3] = static_cast<uint16_t>(i * 3000);
+    }
+    const OIIO::ImageBuf input = image.copy();
+
+    EXPECT_TRUE(applyNormalize(image, image, 0.5f, 0.5f, 0.5f, 1));
+    const uint16_t* in  = u16Pixels(input);
+    const uint16_t* out = u16Pixels(image);
+    for (int i = 0; i < width; ++i) {
+        float c[3] = { in[i * 4 + 0] / 65535.0f, in[i * 4 + 1] / 65535.0f, in[i * 4 + 2] / 65535.0f };
+        normalizeReference(c, 0.5f, 0.5f, 0.5f);
+        for (int ch = 0; ch < 3; ++ch) {
+            EXPECT_TRUE(codeDistance(out[i * 4 + ch], c[ch]) <= 1);
+        }
+        EXPECT_TRUE(out[i * 4 + 3] == in[i * 4 + 3]);
+    }
+}
+
+static void testNormalizeFloatSigned()
+{
+    OIIO::ImageSpec spec(3, 1, 3, OIIO::TypeDesc::FLOAT);
+    OIIO::ImageBuf src(spec);
+    float* pixels        = static_cast<float*>(src.localpixels());
+    const float values[] = { 0.0f, 0.0f, 0.0f, 0.3f, -0.4f, 0.0f, -2.0f, 1.0f, 2.0f };
+    std::copy(values, values + 9, pixels);
+
+    OIIO::ImageBuf dst;
+    EXPECT_TRUE(applyNormalize(dst, src, 0.0f, 0.0f, 1.0f, 1));
+    const float* out = f32Pixels(dst);
+    for (int i = 0; i < 3; ++i) {
+        float c[3] = { values[i * 3 + 0], values[i * 3 + 1], values[i * 3 + 2] };
+        normalizeReference(c, 0.0f, 0.0f, 1.0f);
+        for (int ch = 0; ch < 3; ++ch) {
+            EXPECT_NEAR_VALUE(out[i * 3 + ch], c[ch], 0.00001f, "normalized float channel");
+        }
+    }
+}
+
+static void testNormalRecalcU8()
+{
+    const int width = 41;
+    OIIO::ImageSpec spec(width, 1, 3, OIIO::TypeDesc::UINT8);
+    OIIO::ImageBuf src(spec);
+    uint8_t* pixels = static_cast<uint8_t*>(src.localpixels());
+    for (int i = 0; i < width; ++i) {
+        pixels[i * 3 + 0] = static_cast<uint8_t>(i * 6);
+        pixels[i * 3 + 1] = static_cast<uint8_t>(255 - i * 5);
+        pixels[i * 3 + 2] = static_cast<uint8_t>(i * 37);
+    }
+    pixels[0] = pixels[1] = 128;
+
+    for (int sign : { 1, -1 }) {
+        OIIO::ImageBuf dst;
+        EXPECT_TRUE(applyNormalRecalc(dst, src, 2, sign, 0.5f, 0.5f, 0.5f, 1));
+        const uint8_t* out = static_cast<const uint8_t*>(dst.localpixels());
+        for (int i = 0; i < width; ++i) {
+            float c[3] = { pixels[i * 3] / 255.0f, pixels[i * 3 + 1] / 255.0f, pixels[i * 3 + 2] / 255.0f };
+            recalcReference(c, 2, sign, 0.5f, 0.5f, 0.5f);
+            for (int ch = 0; ch < 3; ++ch) {
+                const float code = std::min(std::max(c[ch] * 255.0f + 0.5f, 0.0f), 255.0f);
+                EXPECT_TRUE(std::abs(static_cast<int>(out[i * 3 + ch]) - static_cast<int>(code)) <= 1);
+            }
+        }
+    }
+    OIIO::ImageBuf dst;
+    EXPECT_TRUE(!applyNormalRecalc(dst, src, 3, 1, 0.5f, 0.5f, 0.5f, 1));
+}
+
+static void testRangeRemapHalfAndU16()
+{
+    OIIO::ImageSpec halfSpec(7, 1, 2, OIIO::TypeDesc::HALF);
+    OIIO::ImageBuf halfImage(halfSpec);
+    half* halfPixels = static_cast<half*>(halfImage.localpixels());
+    for (int i = 0; i < 14; ++i) {
+        halfPixels[i] = half(-1.0f + i * 0.15f);
+    }
+    EXPECT_TRUE(applyRangeRemap(halfImage, halfImage, 0.5f, 0.5f, 1));
+    for (int i = 0; i < 14; ++i) {
+        EXPECT_NEAR_VALUE(static_cast<float>(halfPixels[i]), (-1.0f + i * 0.15f) * 0.5f + 0.5f, 0.001f,
+                          "signed to unsigned half");
+    }
+
+    OIIO::ImageSpec u16Spec(11, 1, 3, OIIO::TypeDesc::UINT16);
+    OIIO::ImageBuf src(u16Spec);
+    uint16_t* pixels = static_cast<uint16_t*>(src.localpixels());
+    for (int i = 0; i < 33; ++i) {
+        pixels[i] = static_cast<uint16_t>(i * 1985);
+    }
+    OIIO::ImageBuf dst;
+    EXPECT_TRUE(applyRangeRemap(dst, src, 2.0f, -1.0f, 1));
+    const uint16_t* out = u16Pixels(dst);
+    for (int i = 0; i < 33; ++i) {
+        EXPECT_TRUE(codeDistance(out[i], pixels[i] / 65535.0f * 2.0f - 1.0f) <= 1);
+    }
+}
+
+static void testPostFillChainU16()
+{
+    const int width  = 37;
+    const int height = 3;
+    OIIO::ImageSpec spec(width, height, 4, OIIO::TypeDesc::UINT16);
+    spec.alpha_channel = 3;
+    OIIO::ImageBuf src(spec);
+    uint16_t* pixels = static_cast<uint16_t*>(src.localpixels());
+    for (int i = 0; i < width * height; ++i) {
+        pixels[i * 4 + 0] = static_cast<uint16_t>(500 + i * 1700);
+        pixels[i * 4 + 1] = static_cast<uint16_t>(65000 - i * 1300);
+        pixels[i * 4 + 2] = static_cast<uint16_t>(30000 + i * 300);
+        pixels[i * 4 + 3] = 777;
+    }
+
+    // The alpha window covers only part of each row, so blocks straddle its edges.
+    OIIO::ImageSpec alphaSpec(21, 2, 1, OIIO::TypeDesc::UINT16);
+    alphaSpec.x = 7;
+    alphaSpec.y = 1;
+    OIIO::ImageBuf alpha(alphaSpec);
+    uint16_t* alphaPixels = static_cast<uint16_t*>(alpha.localpixels());
+    for (int i = 0; i < 21 * 2; ++i) {
+        alphaPixels[i] = static_cast<uint16_t>(i * 1500);
+    }
+
+    std::vector<PostFillOp> ops(4);
+    ops[0].kind          = PostFillOp::ReplaceAlpha;
+    ops[0].alpha         = &alpha;
+    ops[0].clearOutside  = true;
+    ops[1].kind          = PostFillOp::Normalize;
+    ops[2].kind          = PostFillOp::SwapInvert;
+    ops[2].basis         = 3;
+    ops[2].invertMask    = 5;
+    ops[3].kind          = PostFillOp::Grayscale;
+    ops[3].mode          = 5;
+    ops[3].preserveAlpha = true;
+
+    OIIO::ImageBuf fused;
+    EXPECT_TRUE(applyPostFillOps(fused, src, ops, 2));
+
+    OIIO::ImageBuf expected  = src.copy();
+    uint16_t* expectedPixels = static_cast<uint16_t*>(expected.localpixels());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const bool inside = x >= 7 && x < 28 && y >= 1 && y < 3;
+            expectedPixels[(y * width + x) * 4 + 3] = inside ? alphaPixels[(y - 1) * 21 + x - 7] : 0;
+        }
+    }
+    const float weights[3] = { 0.2126f, 0.7152f, 0.0722f };
+    EXPECT_TRUE(applyNormalize(expected, expected, 0.5f, 0.5f, 0.5f, 1));
+    EXPECT_TRUE(applyChannelSwapInvert(expected, expected, 3, 5, false, 1));
+    EXPECT_TRUE(applyGrayscale(expected, expected, 5, weights, true, 1));
+
+    EXPECT_TRUE(fused.nchannels() == 2);
+    EXPECT_TRUE(fused.spec().alpha_channel == 1);
+    const uint16_t* out = u16Pixels(fused);
+    const uint16_t* ref = u16Pixels(expected);
+    for (int i = 0; i < width * height * 2; ++i) {
+        EXPECT_TRUE(std::abs(static_cast<int>(out[i]) - static_cast<int>(ref[i])) <= 1);
+    }
+
+    // A grayscale step on an image without alpha cannot take the mask mode; the chain is refused untouched.
+    OIIO::ImageBuf rgb(OIIO::ImageSpec(4, 1, 3, OIIO::TypeDesc::UINT16));
+    std::vector<PostFillOp> maskOps(1);
+    maskOps[0].kind = PostFillOp::Grayscale;
+    maskOps[0].mode = 4;
+    EXPECT_TRUE(!applyPostFillOps(rgb, rgb, maskOps, 1));
+    EXPECT_TRUE(rgb.nchannels() == 3);
+}
+
+static void testMappedPfmRoundTrip()
+{
+    // RGBA source, written as three-channel PFM through the alpha-skipping stride.
+    const float src[2 * 2 * 4] = { 0.1f, 0.2f, 0.3f, 1.0f, 0.4f, 0.5f, 0.6f, 1.0f,
+                                   0.7f, 0.8f, 0.9f, 1.0f, 1.5f, -2.0f, 4.0f, 1.0f };
+    const std::string path = (std::filesystem::temp_directory_path() / "solidify_mapped_test.pfm").string();
+    EXPECT_TRUE(canWriteMappedImage(path, 3, OIIO::TypeDesc::FLOAT));
+    EXPECT_TRUE(writeMappedImage(path, 2, 2, 3, OIIO::TypeDesc::FLOAT, OIIO::TypeDesc::FLOAT, src,
+                                 4 * sizeof(float), 2 * 4 * sizeof(float)));
+
+    OIIO::ImageBuf written(path);
+    EXPECT_TRUE(written.read(0, 0, 0, -1, true, OIIO::TypeDesc::FLOAT));
+    if (written.initialized() && written.nchannels() == 3) {
+        const float* pixels = f32Pixels(written);
+        for (int i = 0; i < 4; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                EXPECT_NEAR_VALUE(pixels[i * 3 + c], src[i * 4 + c], 0.0f, "mapped pfm sample");
+            }
+        }
+    }
+
+    // PFM rows are stored bottom-up, so the file is read, not mapped.
+    EXPECT_TRUE(mapImageFile(path, OIIO::ImageSpec(2, 2, 3, OIIO::TypeDesc::FLOAT)) == nullptr);
+    written.clear();
+    std::filesystem::remove(path);
+}
+
+static void testMappedPpmU16RoundTrip()
+{
+    const uint16_t src[3 * 1 * 3] = { 0, 1, 256, 4660, 32768, 65535, 258, 65280, 12345 };
+    const std::string path = (std::filesystem::temp_directory_path() / "solidify_mapped_test.ppm").string();
+    EXPECT_TRUE(!canWriteMappedImage(path, 3, OIIO::TypeDesc::HALF));
+    EXPECT_TRUE(writeMappedImage(path, 3, 1, 3, OIIO::TypeDesc::UINT16, OIIO::TypeDesc::UINT16, src,
+                                 OIIO::AutoStride, OIIO::AutoStride));
+
+    OIIO::ImageBuf written(path);
+    EXPECT_TRUE(written.read(0, 0, 0, -1, true, OIIO::TypeDesc::UINT16));
+    if (written.initialized() && written.nchannels() == 3) {
+        const uint16_t* pixels = u16Pixels(written);
+        for (int i = 0; i < 9; ++i) {
+            EXPECT_TRUE(pixels[i] == src[i]);
+        }
+    }
+
+    // PPM stores 16-bit samples big-endian, which only a big-endian host can wrap as they are.
+    std::unique_ptr<MappedImage> mapped = mapImageFile(path, OIIO::ImageSpec(3, 1, 3, OIIO::TypeDesc::UINT16));
+    EXPECT_TRUE((mapped != nullptr) == (std::endian::native == std::endian::big));
+    if (mapped) {
+        const uint16_t* pixels = u16Pixels(mapped->buf);
+        for (int i = 0; i < 9; ++i) {
+            EXPECT_TRUE(pixels[i] == src[i]);
+        }
+    }
+    mapped.reset();
+    written.clear();
+    std::filesystem::remove(path);
+}
+
+static void testMappedTiffWrapsPixels()
+{
+    const float src[3 * 2 * 2] = { 0.1f, 1.0f, 0.2f, 0.5f, 0.3f, 0.0f, 0.4f, 1.0f, -1.5f, 0.25f, 8.0f, 1.0f };
+    const std::string path = (std::filesystem::temp_directory_path() / "solidify_mapped_test.tif").string();
+    OIIO::ImageSpec spec(3, 2, 2, OIIO::TypeDesc::FLOAT);
+    spec.attribute("compression", "none");
+    OIIO::ImageBuf image(spec, const_cast<float*>(src));
+    EXPECT_TRUE(image.write(path));
+
+    std::unique_ptr<MappedImage> mapped = mapImageFile(path, spec);
+    EXPECT_TRUE(mapped != nullptr);
+    if (mapped) {
+        const float* pixels = f32Pixels(mapped->buf);
+        for (int i = 0; i < 12; ++i) {
+            EXPECT_NEAR_VALUE(pixels[i], src[i], 0.0f, "mapped tiff sample");
+        }
+    }
+
+    OIIO::ImageSpec wrongSize(3, 3, 2, OIIO::TypeDesc::FLOAT);
+    EXPECT_TRUE(mapImageFile(path, wrongSize) == nullptr);
+    mapped.reset();
+    std::filesystem::remove(path);
+}
+
 }  // namespace
 
 int main()
@@ -158,6 +521,16 @@ int main()
     testSwapInvertU16();
     testSwapInvertSignedFloat();
     testGrayscaleU16();
+    testAlphaPreprocessU16();
+    testAlphaPreprocessFloat();
+    testNormalizeU16InPlace();
+    testNormalizeFloatSigned();
+    testNormalRecalcU8();
+    testRangeRemapHalfAndU16();
+    testPostFillChainU16();
+    testMappedPfmRoundTrip();
+    testMappedPpmU16RoundTrip();
+    testMappedTiffWrapsPixels();
 
     if (g_failures != 0) {
         std::cerr << g_failures << " test expectation(s) failed.\n";
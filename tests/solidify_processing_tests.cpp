@@ -16,9 +16,11 @@
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include "batchcache.h"
 #include "processing.h"
 #include "imageio.h"
 #include "settings.h"
+#include "solidify.h"
 
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imageio.h>
@@ -26,7 +28,9 @@
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <vector>
 
 namespace {
 
@@ -106,6 +110,73 @@ static bool writeFloatRgba(const fs::path& path, float r, float g, float b, floa
     return image.write(path.string());
 }
 
+// Value of the known pixels of page of a multi-page test file: 0.25 on the first page up to 0.75 on the last.
+static float pageValue(int page, int pages)
+{
+    return 0.25f + 0.5f * static_cast<float>(page) / static_cast<float>(pages - 1);
+}
+
+// Writes pages 4x4 RGBA float pages with a hole at pixel 5, each data window at (x, y) inside a fullSize square
+// display window.
+static bool writeMultiPage(const fs::path& path, int pages, int x = 0, int y = 0, int fullSize = 4)
+{
+    OIIO::ImageSpec spec(4, 4, 4, OIIO::TypeDesc::FLOAT);
+    spec.channelnames[3] = "A";
+    spec.alpha_channel   = 3;
+    spec.x               = x;
+    spec.y               = y;
+    spec.full_width      = fullSize;
+    spec.full_height     = fullSize;
+    std::vector<OIIO::ImageSpec> specs(static_cast<size_t>(pages), spec);
+    for (int page = 0; page < pages; ++page) {
+        specs[static_cast<size_t>(page)]["oiio:subimagename"] = "page" + std::to_string(page);
+    }
+
+    auto out = OIIO::ImageOutput::create(path.string());
+    if (!out || !out->open(path.string(), pages, specs.data())) {
+        return false;
+    }
+    float pixels[4 * 4 * 4] = {};
+    for (int page = 0; page < pages; ++page) {
+        const float value = pageValue(page, pages);
+        for (int i = 0; i < 16; ++i) {
+            const bool hole   = i == 5;
+            pixels[i * 4 + 0] = hole ? 0.0f : value;
+            pixels[i * 4 + 1] = hole ? 0.0f : value;
+            pixels[i * 4 + 2] = hole ? 0.0f : value;
+            pixels[i * 4 + 3] = hole ? 0.0f : 1.0f;
+        }
+        if (page > 0
+            && !out->open(path.string(), specs[static_cast<size_t>(page)], OIIO::ImageOutput::AppendSubimage)) {
+            return false;
+        }
+        if (!out->write_image(OIIO::TypeDesc::FLOAT, pixels)) {
+            return false;
+        }
+    }
+    return out->close();
+}
+
+// Expects two written images to hold the same size, channels, pixel format and pixels.
+static void expectSameImage(const fs::path& actualPath, const fs::path& expectedPath, const char* label)
+{
+    OIIO::ImageBuf actual(actualPath.string());
+    OIIO::ImageBuf expected(expectedPath.string());
+    const OIIO::ImageSpec& spec = expected.spec();
+    EXPECT_TRUE(actual.spec().width == spec.width && actual.spec().height == spec.height);
+    EXPECT_TRUE(actual.nchannels() == spec.nchannels && actual.spec().format == spec.format);
+    if (actual.spec().image_pixels() != spec.image_pixels() || actual.nchannels() != spec.nchannels) {
+        return;
+    }
+    std::vector<float> actualPixels(spec.image_pixels() * static_cast<size_t>(spec.nchannels));
+    std::vector<float> expectedPixels(actualPixels.size());
+    EXPECT_TRUE(actual.get_pixels(actual.roi(), OIIO::TypeDesc::FLOAT, actualPixels.data()));
+    EXPECT_TRUE(expected.get_pixels(expected.roi(), OIIO::TypeDesc::FLOAT, expectedPixels.data()));
+    for (size_t i = 0; i < actualPixels.size(); ++i) {
+        EXPECT_NEAR_VALUE(actualPixels[i], expectedPixels[i], 0.0f, label);
+    }
+}
+
 static void configureProcessing(bool useAlpha)
 {
     settings.reSettings();
@@ -143,23 +214,17 @@ static void testMaskGammaUsesImageAppConventionAndPreservesOriginal()
     settings.alphaMode  = 1;
     settings.alphaGamma = 2.0f;
 
-    MaskBuffers mask = mask_load(maskPath.string(), nullptr);
+    MaskBuffers mask = mask_load(maskPath.string(), true, nullptr);
     EXPECT_TRUE(mask.alpha.initialized());
-    EXPECT_TRUE(mask.rgbAlpha.initialized());
     EXPECT_TRUE(mask.originalAlpha.initialized());
 
     float gammaAlpha[1] = {};
     float originalAlpha[1] = {};
-    float rgbAlpha[3] = {};
     mask.alpha.getpixel(0, 0, gammaAlpha, 1);
     mask.originalAlpha.getpixel(0, 0, originalAlpha, 1);
-    mask.rgbAlpha.getpixel(0, 0, rgbAlpha, 3);
 
     EXPECT_NEAR_VALUE(gammaAlpha[0], 0.5f, 0.001f, "gamma alpha");
     EXPECT_NEAR_VALUE(originalAlpha[0], 0.25f, 0.001f, "original alpha");
-    EXPECT_NEAR_VALUE(rgbAlpha[0], 0.5f, 0.001f, "rgb alpha R");
-    EXPECT_NEAR_VALUE(rgbAlpha[1], 0.5f, 0.001f, "rgb alpha G");
-    EXPECT_NEAR_VALUE(rgbAlpha[2], 0.5f, 0.001f, "rgb alpha B");
 
     fs::remove_all(testDir, ec);
 }
@@ -236,6 +301,521 @@ static void testUseAlphaProcessesTextureNamedMask()
     fs::remove_all(testDir, ec);
 }
 
+static void testMultiPageTiffFillsEverySubimage()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_subimage_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    // More pages than are filled at a time, so earlier pages are written and released while later ones fill.
+    constexpr int pages       = 5;
+    const fs::path inputPath  = testDir / "pages.tif";
+    const fs::path outputPath = testDir / "pages_fill.tif";
+    EXPECT_TRUE(writeMultiPage(inputPath, pages));
+
+    configureProcessing(true);
+    EXPECT_TRUE(solidify_main(inputPath.string(), outputPath.string(), MaskBuffers(), nullptr));
+
+    auto in = OIIO::ImageInput::open(outputPath.string());
+    EXPECT_TRUE(in != nullptr);
+    if (in) {
+        for (int page = 0; page < pages; ++page) {
+            EXPECT_TRUE(in->seek_subimage(page, 0));
+            EXPECT_TRUE(in->spec().nchannels == 3);
+            float pixels[4 * 4 * 3] = {};
+            EXPECT_TRUE(in->read_image(page, 0, 0, 3, OIIO::TypeDesc::FLOAT, pixels));
+            EXPECT_NEAR_VALUE(pixels[5 * 3], pageValue(page, pages), 0.001f, "filled subimage hole");
+        }
+        EXPECT_TRUE(!in->seek_subimage(pages, 0));
+        in->close();
+    }
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testMultiPartExrFillsGrownDataWindows()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_subimage_margin_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    // 4x4 data windows at (2, 2) of an 8x8 display window, grown by a one pixel margin to 6x6 at (1, 1).
+    constexpr int pages       = 2;
+    const fs::path inputPath  = testDir / "parts.exr";
+    const fs::path outputPath = testDir / "parts_fill.exr";
+    EXPECT_TRUE(writeMultiPage(inputPath, pages, 2, 2, 8));
+
+    configureProcessing(true);
+    settings.fillMargin = 1;
+    EXPECT_TRUE(solidify_main(inputPath.string(), outputPath.string(), MaskBuffers(), nullptr));
+    settings.fillMargin = 0;
+
+    auto in = OIIO::ImageInput::open(outputPath.string());
+    EXPECT_TRUE(in != nullptr);
+    if (in) {
+        for (int page = 0; page < pages; ++page) {
+            EXPECT_TRUE(in->seek_subimage(page, 0));
+            const OIIO::ImageSpec& spec = in->spec();
+            EXPECT_TRUE(spec.x == 1 && spec.y == 1 && spec.width == 6 && spec.height == 6);
+            EXPECT_TRUE(spec.full_width == 8 && spec.full_height == 8 && spec.nchannels == 3);
+            float pixels[6 * 6 * 3] = {};
+            EXPECT_TRUE(in->read_image(page, 0, 0, 3, OIIO::TypeDesc::FLOAT, pixels));
+            for (int i = 0; i < 6 * 6; ++i) {
+                EXPECT_NEAR_VALUE(pixels[i * 3], pageValue(page, pages), 0.001f, "filled grown data window");
+            }
+        }
+        in->close();
+    }
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testStreamedConvertMatchesInMemory()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_stream_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    const fs::path inputPath    = testDir / "texture.png";
+    const fs::path streamedPath = testDir / "streamed.png";
+    const fs::path memoryPath   = testDir / "memory.png";
+    EXPECT_TRUE(writeRgbaPng(inputPath));
+
+    // A conversion to 16 bits without the fill streams. PNG outputs ignore MipMap, which only keeps the same job on
+    // the in-memory path.
+    configureProcessing(true);
+    settings.isSolidify = false;
+    settings.bitDepth   = 1;
+    for (const int alphaMode : { 0, 1 }) {
+        settings.alphaMode = alphaMode;
+        EXPECT_TRUE(solidify_main(inputPath.string(), streamedPath.string(), MaskBuffers(), nullptr));
+        settings.mipmapOutput = true;
+        EXPECT_TRUE(solidify_main(inputPath.string(), memoryPath.string(), MaskBuffers(), nullptr));
+        settings.mipmapOutput = false;
+        expectSameImage(streamedPath, memoryPath, "streamed conversion");
+    }
+    settings.alphaMode = 0;
+    settings.bitDepth  = -1;
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testStreamedAlphaExportMatchesInMemory()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_alpha_stream_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    const fs::path inputPath    = testDir / "texture.png";
+    const fs::path streamedPath = testDir / "streamed.png";
+    const fs::path memoryPath   = testDir / "memory.png";
+    EXPECT_TRUE(writeRgbaPng(inputPath));
+
+    // Mask export decodes only the alpha channel, with or without the fill and with or without alpha gamma. MipMap
+    // keeps the reference on the in-memory path.
+    configureProcessing(true);
+    settings.alphaMode = 2;
+    settings.bitDepth  = 1;
+    for (const float gamma : { 1.0f, 2.2f }) {
+        settings.alphaGamma = gamma;
+        for (const bool solidify : { false, true }) {
+            settings.isSolidify = solidify;
+            EXPECT_TRUE(solidify_main(inputPath.string(), streamedPath.string(), MaskBuffers(), nullptr));
+            settings.mipmapOutput = true;
+            EXPECT_TRUE(solidify_main(inputPath.string(), memoryPath.string(), MaskBuffers(), nullptr));
+            settings.mipmapOutput = false;
+            expectSameImage(streamedPath, memoryPath, "streamed alpha export");
+            OIIO::ImageBuf streamed(streamedPath.string());
+            EXPECT_TRUE(streamed.nchannels() == 1);
+        }
+    }
+    settings.alphaGamma = 1.0f;
+    settings.alphaMode  = 0;
+    settings.bitDepth   = -1;
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testMipmappedTiffFromPyramid()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_mipmap_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    const fs::path inputPath  = testDir / "texture.png";
+    const fs::path outputPath = testDir / "texture_fill.tif";
+    EXPECT_TRUE(writeRgbaPng(inputPath));
+
+    configureProcessing(true);
+    settings.mipmapOutput = true;
+    EXPECT_TRUE(solidify_main(inputPath.string(), outputPath.string(), MaskBuffers(), nullptr));
+    settings.mipmapOutput = false;
+
+    auto in = OIIO::ImageInput::open(outputPath.string());
+    EXPECT_TRUE(in != nullptr);
+    if (in) {
+        EXPECT_TRUE(in->spec().tile_width == 64);
+        int size = 8;
+        for (int mip = 0; mip < 4; ++mip, size /= 2) {
+            EXPECT_TRUE(in->seek_subimage(0, mip));
+            EXPECT_TRUE(in->spec().width == size && in->spec().height == size && in->spec().nchannels == 3);
+        }
+        EXPECT_TRUE(!in->seek_subimage(0, 4));
+        float pixel[3] = {};
+        EXPECT_TRUE(in->read_image(0, 3, 0, 3, OIIO::TypeDesc::FLOAT, pixel));
+        EXPECT_NEAR_VALUE(pixel[0], 90.0f / 255.0f, 0.01f, "1x1 MIP level R");
+        in->close();
+    }
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testOutputScaleWritesPyramidLevel()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_scale_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    const fs::path inputPath  = testDir / "texture.png";
+    const fs::path outputPath = testDir / "texture_fill.exr";
+    EXPECT_TRUE(writeRgbaPng(inputPath));
+
+    configureProcessing(true);
+    settings.outputScale = 1;
+    settings.alphaMode   = 1;
+    EXPECT_TRUE(solidify_main(inputPath.string(), outputPath.string(), MaskBuffers(), nullptr));
+    settings.outputScale = 0;
+    settings.alphaMode   = 0;
+
+    OIIO::ImageBuf output(outputPath.string());
+    EXPECT_TRUE(output.spec().width == 4 && output.spec().height == 4 && output.nchannels() == 4);
+    float pixel[4] = {};
+    output.getpixel(1, 1, pixel, 4);
+    EXPECT_NEAR_VALUE(pixel[0], 90.0f / 255.0f, 0.01f, "half-resolution filled R");
+    EXPECT_NEAR_VALUE(pixel[3], 0.75f, 0.01f, "half-resolution box-filtered alpha");
+
+    // A kept external mask comes at the level from the mask's variant cache, pulled like the fill.
+    const fs::path maskedPath = testDir / "texture_masked.exr";
+    configureProcessing(false);
+    settings.outputScale   = 1;
+    settings.alphaMode     = 1;
+    const MaskBuffers mask = mask_load(inputPath.string(), true, nullptr);
+    EXPECT_TRUE(solidify_main(inputPath.string(), maskedPath.string(), mask, nullptr));
+    settings.outputScale = 0;
+    settings.alphaMode   = 0;
+
+    OIIO::ImageBuf masked(maskedPath.string());
+    EXPECT_TRUE(masked.spec().width == 4 && masked.spec().height == 4 && masked.nchannels() == 4);
+    masked.getpixel(1, 1, pixel, 4);
+    EXPECT_NEAR_VALUE(pixel[3], 0.75f * 90.0f / 255.0f, 0.01f, "half-resolution external mask level");
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testFillsWithoutPostPassesMakeNoImageCopies()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_copy_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    const fs::path inputPath = testDir / "texture.png";
+    EXPECT_TRUE(writeRgbaPng(inputPath));
+
+    // Embedded alpha is filled over the decoded input, which is then written as is.
+    configureProcessing(true);
+    SolidifyStats inPlace;
+    inPlace.copiedBytes = 1;
+    EXPECT_TRUE(solidify_main(inputPath.string(), (testDir / "in_place.png").string(), MaskBuffers(), nullptr,
+                              &inPlace));
+    EXPECT_TRUE(inPlace.copiedBytes == 0);
+
+    // An external mask fills into a new buffer, and a target without post-fill passes writes that buffer directly.
+    configureProcessing(false);
+    const MaskBuffers mask = mask_load(inputPath.string(), false, nullptr);
+    SolidifyStats masked;
+    masked.copiedBytes = 1;
+    EXPECT_TRUE(solidify_main(inputPath.string(), (testDir / "masked.png").string(), mask, nullptr, &masked));
+    EXPECT_TRUE(masked.copiedBytes == 0);
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testOutputsShareOneDecodeAndFill()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_outputs_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    const fs::path inputPath = testDir / "texture.png";
+    EXPECT_TRUE(writeRgbaPng(inputPath));
+
+    configureProcessing(true);
+    Settings fill  = settings;
+    fill.outSuffix = "_fill";
+    fill.alphaMode = 1;
+    Settings mask  = settings;
+    mask.outSuffix = "_mask";
+    mask.alphaMode = 2;
+
+    const std::string fillName = getOutName(inputPath.string(), &fill);
+    const std::string maskName = getOutName(inputPath.string(), &mask);
+    EXPECT_TRUE(fs::path(fillName).filename() == "texture_fill.png");
+    EXPECT_TRUE(fs::path(maskName).filename() == "texture_mask.png");
+
+    const fs::path fillPath = testDir / "texture_fill.exr";
+    const std::vector<SolidifyTarget> targets = { { fillPath.string(), fill }, { maskName, mask } };
+    EXPECT_TRUE(solidify_outputs(inputPath.string(), targets, MaskBuffers(), nullptr));
+
+    OIIO::ImageBuf filled(fillPath.string());
+    EXPECT_TRUE(filled.nchannels() == 4);
+    float pixel[4] = {};
+    filled.getpixel(3, 3, pixel, 4);
+    EXPECT_NEAR_VALUE(pixel[0], 90.0f / 255.0f, 0.01f, "fan-out filled R");
+    EXPECT_NEAR_VALUE(pixel[3], 0.0f, 0.01f, "fan-out source alpha");
+
+    OIIO::ImageBuf masked(maskName);
+    EXPECT_TRUE(masked.nchannels() == 1);
+    float alpha = 1.0f;
+    masked.getpixel(3, 3, &alpha, 1);
+    EXPECT_NEAR_VALUE(alpha, 0.0f, 0.01f, "fan-out mask hole");
+    masked.getpixel(0, 0, &alpha, 1);
+    EXPECT_NEAR_VALUE(alpha, 1.0f, 0.01f, "fan-out mask solid");
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testOutputsLeaveMultiPageInputsToTheSingleOutput()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_outputs_subimage_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    constexpr int pages = 2;
+    EXPECT_TRUE(writeMultiPage(testDir / "pages.tif", pages));
+    EXPECT_TRUE(writeRgbaPng(testDir / "texture.png"));
+
+    configureProcessing(true);
+    Settings variant  = settings;
+    variant.outSuffix = "_variant";
+    settings.outputs.push_back(variant);
+    EXPECT_TRUE(doProcessing({ testDir.string() }, nullptr));
+
+    // The multi-page input writes every page to the single output; the single-page one still fans out.
+    EXPECT_TRUE(!fs::exists(testDir / "pages_variant.tif"));
+    EXPECT_TRUE(fs::exists(testDir / "texture_variant.png"));
+    EXPECT_TRUE(!fs::exists(testDir / "texture_fill.png"));
+    auto in = OIIO::ImageInput::open((testDir / "pages_fill.tif").string());
+    EXPECT_TRUE(in != nullptr);
+    if (in) {
+        EXPECT_TRUE(in->seek_subimage(pages - 1, 0));
+        in->close();
+    }
+    settings.outputs.clear();
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testIncrementalBatchSkipsUnchangedAndDuplicates()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_incremental_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    const fs::path firstPath  = testDir / "first.png";
+    const fs::path secondPath = testDir / "second.png";
+    EXPECT_TRUE(writeRgbaPng(firstPath));
+    EXPECT_TRUE(writeRgbaPng(secondPath));
+    const std::vector<std::string> inputs = { firstPath.string(), secondPath.string() };
+
+    configureProcessing(true);
+    settings.incremental = true;
+    EXPECT_TRUE(doProcessing(inputs, nullptr));
+    EXPECT_TRUE(fs::exists(testDir / "first_fill.png"));
+    EXPECT_TRUE(fs::exists(testDir / "second_fill.png"));
+    EXPECT_TRUE(fs::exists(testDir / BatchCache::kManifestName));
+
+    const auto firstTime  = fs::last_write_time(testDir / "first_fill.png", ec);
+    const auto secondTime = fs::last_write_time(testDir / "second_fill.png", ec);
+    EXPECT_TRUE(doProcessing(inputs, nullptr));
+    EXPECT_TRUE(fs::last_write_time(testDir / "first_fill.png", ec) == firstTime);
+    EXPECT_TRUE(fs::last_write_time(testDir / "second_fill.png", ec) == secondTime);
+
+    settings.bitDepth = 1;
+    EXPECT_TRUE(doProcessing(inputs, nullptr));
+    for (const char* name : { "first_fill.png", "second_fill.png" }) {
+        auto in = OIIO::ImageInput::open((testDir / name).string());
+        EXPECT_TRUE(in != nullptr && in->spec().format == OIIO::TypeDesc::UINT16);
+    }
+    settings.bitDepth    = -1;
+    settings.incremental = false;
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testIncrementalBatchTracksDistanceFields()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_distance_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    EXPECT_TRUE(writeRgbaPng(testDir / "first.png"));
+    EXPECT_TRUE(writeRgbaPng(testDir / "second.png"));
+
+    // The duplicate gets the distance field copied with its output, and a rerun over the directory neither treats
+    // the distance fields as inputs nor rewrites them.
+    configureProcessing(true);
+    settings.incremental    = true;
+    settings.fillEngine     = FillEngine_Dilate;
+    settings.dilateDistance = true;
+    EXPECT_TRUE(doProcessing({ testDir.string() }, nullptr));
+    EXPECT_TRUE(fs::exists(testDir / "first_fill_distance.exr"));
+    EXPECT_TRUE(fs::exists(testDir / "second_fill_distance.exr"));
+
+    const auto firstTime  = fs::last_write_time(testDir / "first_fill_distance.exr", ec);
+    const auto secondTime = fs::last_write_time(testDir / "second_fill_distance.exr", ec);
+    EXPECT_TRUE(doProcessing({ testDir.string() }, nullptr));
+    EXPECT_TRUE(fs::last_write_time(testDir / "first_fill_distance.exr", ec) == firstTime);
+    EXPECT_TRUE(fs::last_write_time(testDir / "second_fill_distance.exr", ec) == secondTime);
+    for (const fs::directory_entry& entry : fs::directory_iterator(testDir, ec)) {
+        EXPECT_TRUE(entry.path().filename().string().find("_distance_") == std::string::npos);
+    }
+    settings.fillEngine     = FillEngine_PushPull;
+    settings.dilateDistance = false;
+    settings.incremental    = false;
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testPlannerSkipsSidecarsAndRejectsCollisions()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_planner_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir / "nested", ec);
+    EXPECT_TRUE(!ec);
+
+    EXPECT_TRUE(writeRgbaPng(testDir / "nested" / "albedo.png"));
+    std::ofstream(testDir / "nested" / "albedo.txt") << "sidecar";
+    std::ofstream(testDir / "broken.png") << "not a png";
+
+    configureProcessing(true);
+    EXPECT_TRUE(doProcessing({ testDir.string() }, nullptr));
+    EXPECT_TRUE(fs::exists(testDir / "nested" / "albedo_fill.png"));
+    EXPECT_TRUE(!fs::exists(testDir / "broken_fill.png"));
+
+    fs::remove(testDir / "broken.png", ec);
+    ec.clear();
+    fs::remove(testDir / "nested" / "albedo_fill.png", ec);
+    ec.clear();
+    EXPECT_TRUE(writeRgbaPng(testDir / "nested" / "albedo.tif"));
+    EXPECT_TRUE(!doProcessing({ testDir.string() }, nullptr));
+    EXPECT_TRUE(fs::exists(testDir / "nested" / "albedo_fill.png"));
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testRerunOverProcessedDirectory()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_rerun_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    EXPECT_TRUE(writeRgbaPng(testDir / "albedo.png"));
+    EXPECT_TRUE(writeRgbaPng(testDir / "roughness.png"));
+
+    // The second and third runs see last run's outputs next to the inputs and leave them to be rewritten.
+    configureProcessing(true);
+    EXPECT_TRUE(doProcessing({ testDir.string() }, nullptr));
+    EXPECT_TRUE(fs::exists(testDir / "albedo_fill.png"));
+    EXPECT_TRUE(doProcessing({ testDir.string() }, nullptr));
+    EXPECT_TRUE(!fs::exists(testDir / "albedo_fill_fill.png"));
+
+    settings.incremental = true;
+    EXPECT_TRUE(doProcessing({ testDir.string() }, nullptr));
+    const auto firstTime = fs::last_write_time(testDir / "albedo_fill.png", ec);
+    EXPECT_TRUE(doProcessing({ testDir.string() }, nullptr));
+    EXPECT_TRUE(fs::last_write_time(testDir / "albedo_fill.png", ec) == firstTime);
+    EXPECT_TRUE(!fs::exists(testDir / "roughness_fill_fill.png"));
+    settings.incremental = false;
+
+    fs::remove_all(testDir, ec);
+}
+
+static void testMaskVariantsAreSharedAndFollowThePullPyramid()
+{
+    const fs::path testDir = fs::temp_directory_path() / "solidify_processing_mask_variant_tests";
+    std::error_code ec;
+    fs::remove_all(testDir, ec);
+    ec.clear();
+    fs::create_directories(testDir, ec);
+    EXPECT_TRUE(!ec);
+
+    const fs::path maskPath = testDir / "cloth_mask.png";
+    EXPECT_TRUE(writeRgbaPng(maskPath));
+
+    settings.reSettings();
+    MaskBuffers mask = mask_load(maskPath.string(), false, nullptr);
+    EXPECT_TRUE(mask.variants != nullptr);
+
+    MaskView full;
+    EXPECT_TRUE(maskVariant(mask, OIIO::TypeDesc::FLOAT, 8, 8, &full));
+    EXPECT_TRUE(full.alpha == &mask.alpha);
+
+    MaskView half, again;
+    EXPECT_TRUE(maskVariant(mask, OIIO::TypeDesc::UINT8, 4, 4, &half));
+    EXPECT_TRUE(maskVariant(mask, OIIO::TypeDesc::UINT8, 4, 4, &again));
+    EXPECT_TRUE(half.alpha == again.alpha);
+    if (half.alpha) {
+        EXPECT_TRUE(half.alpha->spec().width == 4 && half.alpha->spec().format == OIIO::TypeDesc::UINT8);
+        float alpha = 0.0f;
+        half.alpha->getpixel(1, 1, &alpha, 1);
+        EXPECT_NEAR_VALUE(alpha, 0.75f * 90.0f / 255.0f, 0.01f, "pull pyramid mask level");
+    }
+
+    MaskView resampled;
+    EXPECT_TRUE(maskVariant(mask, OIIO::TypeDesc::UINT16, 6, 5, &resampled));
+    EXPECT_TRUE(resampled.alpha && resampled.alpha->spec().width == 6 && resampled.alpha->spec().height == 5);
+
+    fs::remove_all(testDir, ec);
+}
+
 }  // namespace
 
 int main()
@@ -243,6 +823,20 @@ int main()
     testMaskGammaUsesImageAppConventionAndPreservesOriginal();
     testEmbeddedAlphaGammaAndPremultiplySwitch();
     testUseAlphaProcessesTextureNamedMask();
+    testMultiPageTiffFillsEverySubimage();
+    testMultiPartExrFillsGrownDataWindows();
+    testStreamedConvertMatchesInMemory();
+    testStreamedAlphaExportMatchesInMemory();
+    testMipmappedTiffFromPyramid();
+    testOutputScaleWritesPyramidLevel();
+    testFillsWithoutPostPassesMakeNoImageCopies();
+    testOutputsShareOneDecodeAndFill();
+    testOutputsLeaveMultiPageInputsToTheSingleOutput();
+    testIncrementalBatchSkipsUnchangedAndDuplicates();
+    testIncrementalBatchTracksDistanceFields();
+    testPlannerSkipsSidecarsAndRejectsCollisions();
+    testRerunOverProcessedDirectory();
+    testMaskVariantsAreSharedAndFollowThePullPyramid();
 
     if (g_failures != 0) {
         std::cerr << g_failures << " processing test expectation(s) failed.\n";
@@ -16,6 +16,7 @@
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include "imagememory.h"
 #include "pushpull.h"
 
 #include <OpenImageIO/imagebuf.h>
@@ -211,12 +212,15 @@ static bool benchNative(const char* label, const OIIO::ImageBuf& src, const int
 {
     for (int i = 0; i < repeats; ++i) {
         OIIO::ImageBuf dst;
+        const size_t faults = processPageFaults();
         const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
         if (!applyPushPullFill(dst, src, 0)) {
             std::cerr << label << " native failed: " << dst.geterror() << '\n';
             return false;
         }
-        std::cout << label << " native pass " << (i + 1) << ": " << secondsSince(start) << " s\n";
+        const double seconds = secondsSince(start);
+        std::cout << label << " native pass " << (i + 1) << ": " << seconds << " s, "
+                  << processPageFaults() - faults << " page faults\n";
     }
     return true;
 }
@@ -225,12 +229,15 @@ static bool benchOiio(const char* label, const OIIO::ImageBuf& src, const int re
 {
     for (int i = 0; i < repeats; ++i) {
         OIIO::ImageBuf dst;
+        const size_t faults = processPageFaults();
         const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
         if (!OIIO::ImageBufAlgo::fillholes_pushpull(dst, src)) {
             std::cerr << label << " OIIO failed: " << dst.geterror() << '\n';
             return false;
         }
-        std::cout << label << " OIIO pass " << (i + 1) << ": " << secondsSince(start) << " s\n";
+        const double seconds = secondsSince(start);
+        std::cout << label << " OIIO pass " << (i + 1) << ": " << seconds << " s, "
+                  << processPageFaults() - faults << " page faults\n";
     }
     return true;
 }
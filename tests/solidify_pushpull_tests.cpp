@@ -23,11 +23,14 @@
 #include <OpenImageIO/half.h>
 #include <OpenImageIO/imageio.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
 #include <iostream>
 #include <limits>
+#include <string>
+#include <vector>
 
 namespace {
 
@@ -368,6 +371,654 @@ static void testUint16FormatPreserved()
     EXPECT_TRUE(out[center + 2] > 29000u && out[center + 2] < 31000u);
 }
 
+static void expectBandedMatchesInMemory(const OIIO::ImageBuf& src, const int bandHeight, const size_t residentBytes,
+                                        const char* label)
+{
+    const OIIO::ImageSpec& spec = src.spec();
+    std::vector<float> srcPixels;
+    EXPECT_TRUE(readFloatPixels(src, &srcPixels));
+    const size_t rowFloats = static_cast<size_t>(spec.width) * static_cast<size_t>(spec.nchannels);
+
+    std::vector<float> banded(srcPixels.size(), -1.0f);
+    PushPullBandSource source;
+    source.width    = spec.width;
+    source.height   = spec.height;
+    source.channels = spec.nchannels;
+    source.readRows = [&](int ybegin, int yend, float* pixels) {
+        if (ybegin < 0 || yend > spec.height || ybegin >= yend) {
+            return false;
+        }
+        std::copy(srcPixels.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(ybegin) * rowFloats),
+                  srcPixels.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(yend) * rowFloats), pixels);
+        return true;
+    };
+    PushPullBandSink sink;
+    sink.bandHeight    = bandHeight;
+    sink.residentBytes = residentBytes;
+    sink.writeRows     = [&](int ybegin, int yend, const float* pixels) {
+        std::copy(pixels, pixels + static_cast<size_t>(yend - ybegin) * rowFloats,
+                  banded.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(ybegin) * rowFloats));
+        return true;
+    };
+    std::string error;
+    EXPECT_TRUE(applyPushPullFillBanded(source, sink, 1, &error));
+
+    OIIO::ImageBuf inMemory;
+    EXPECT_TRUE(applyPushPullFill(inMemory, src, 1));
+    std::vector<float> expected;
+    EXPECT_TRUE(readFloatPixels(inMemory, &expected));
+    float maxError = 0.0f;
+    for (size_t i = 0; i < expected.size() && i < banded.size(); ++i) {
+        maxError = std::max(maxError, std::fabs(banded[i] - expected[i]));
+    }
+    if (maxError > 1e-6f) {
+        ++g_failures;
+        std::cerr << label << " banded push-pull differs from in-memory by " << maxError << '\n';
+    }
+}
+
+static void testBandedMatchesInMemory()
+{
+    const size_t resident = PushPullBandSink().residentBytes;
+    expectBandedMatchesInMemory(makeRgbaFloatHole(), 4, resident, "even RGBA");
+    expectBandedMatchesInMemory(makeCanonicalRgbaFloatHole(), 8, resident, "odd RGBA");
+    expectBandedMatchesInMemory(makeGrayFloatHole(), 64, resident, "single band gray");
+    // With no budget every level but the 1x1 top is streamed.
+    expectBandedMatchesInMemory(makeRgbaFloatHole(), 4, 0, "streamed even RGBA");
+    expectBandedMatchesInMemory(makeCanonicalRgbaFloatHole(), 3, 0, "streamed odd RGBA");
+    expectBandedMatchesInMemory(makeGrayFloatHole(), 64, 0, "streamed single band gray");
+}
+
+static void testDataWindowRegionAndMargin()
+{
+    // The hole image as a small data window inside a larger display window.
+    OIIO::ImageBuf centered = makeRgbaFloatHole();
+    OIIO::ImageSpec spec    = centered.spec();
+    spec.x                  = 100;
+    spec.y                  = 40;
+    spec.full_x             = 0;
+    spec.full_y             = 0;
+    spec.full_width         = 128;
+    spec.full_height        = 64;
+    OIIO::ImageBuf src(spec);
+    EXPECT_TRUE(src.set_pixels(src.roi(), OIIO::TypeDesc::FLOAT, centered.localpixels()));
+
+    OIIO::ImageBuf filled;
+    EXPECT_TRUE(applyPushPullFill(filled, src, 1));
+    EXPECT_TRUE(filled.xbegin() == 100 && filled.ybegin() == 40);
+    EXPECT_TRUE(filled.spec().width == 16 && filled.spec().height == 16);
+    EXPECT_TRUE(filled.spec().full_width == 128 && filled.spec().full_height == 64);
+    OIIO::ImageBuf atOrigin;
+    EXPECT_TRUE(applyPushPullFill(atOrigin, centered, 1));
+    OIIO::ImageBuf expected(spec);
+    EXPECT_TRUE(expected.set_pixels(expected.roi(), OIIO::TypeDesc::FLOAT, atOrigin.localpixels()));
+    expectImageClose(filled, expected, 1e-6f, "offset data window");
+
+    PushPullOptions options;
+    options.nthreads = 1;
+    options.margin   = 3;
+    OIIO::ImageBuf padded;
+    EXPECT_TRUE(applyPushPullFill(padded, src, options));
+    EXPECT_TRUE(padded.xbegin() == 97 && padded.ybegin() == 37);
+    EXPECT_TRUE(padded.spec().width == 22 && padded.spec().height == 22);
+    float corner[4] = {};
+    padded.getpixel(97, 37, corner, 4);
+    EXPECT_NEAR_VALUE(corner[0], 0.25f, 0.01f, "margin R");
+    EXPECT_TRUE(corner[3] > 0.99f);
+
+    // The margin is clamped to the display window.
+    options.margin = 50;
+    EXPECT_TRUE(applyPushPullFill(padded, src, options));
+    EXPECT_TRUE(padded.xbegin() == 50 && padded.xend() == 128 && padded.ybegin() == 0 && padded.yend() == 64);
+
+    options.margin = -1;
+    EXPECT_TRUE(applyPushPullFill(padded, src, options));
+    EXPECT_TRUE(padded.xbegin() == 0 && padded.spec().width == 128 && padded.spec().height == 64);
+
+    options.margin = 0;
+    options.roi    = OIIO::ROI(104, 112, 44, 52);
+    EXPECT_TRUE(applyPushPullFill(padded, src, options));
+    EXPECT_TRUE(padded.xbegin() == 104 && padded.spec().width == 8 && padded.spec().height == 8);
+}
+
+static void testPyramidMipLevels()
+{
+    OIIO::ImageBuf src = makeRgbaFloatHole();
+    std::vector<OIIO::ImageBuf> mipLevels;
+    PushPullOptions options;
+    options.nthreads  = 1;
+    options.mipLevels = &mipLevels;
+    OIIO::ImageBuf filled;
+    EXPECT_TRUE(applyPushPullFill(filled, src, options));
+    EXPECT_TRUE(mipLevels.size() == 4u);
+
+    int size = 16;
+    for (const OIIO::ImageBuf& level : mipLevels) {
+        size /= 2;
+        EXPECT_TRUE(level.spec().width == size && level.spec().height == size);
+        EXPECT_TRUE(level.spec().format == OIIO::TypeDesc::FLOAT && level.spec().alpha_channel == 3);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                float pixel[4] = {};
+                level.getpixel(x, y, pixel, 4);
+                EXPECT_NEAR_VALUE(pixel[0], 0.25f, 1e-5f, "MIP R");
+                EXPECT_NEAR_VALUE(pixel[1], 0.50f, 1e-5f, "MIP G");
+                EXPECT_NEAR_VALUE(pixel[2], 0.75f, 1e-5f, "MIP B");
+                EXPECT_NEAR_VALUE(pixel[3], 1.0f, 1e-6f, "MIP A");
+            }
+        }
+    }
+}
+
+static void testResultAtPyramidLevel()
+{
+    OIIO::ImageBuf src = makeRgbaFloatHole();
+    PushPullOptions options;
+    options.nthreads = 1;
+    options.level    = 1;
+    OIIO::ImageBuf halved;
+    EXPECT_TRUE(applyPushPullFill(halved, src, options));
+    EXPECT_TRUE(halved.spec().width == 8 && halved.spec().height == 8);
+    EXPECT_TRUE(halved.spec().full_width == 8 && halved.spec().full_height == 8);
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            float pixel[4] = {};
+            halved.getpixel(x, y, pixel, 4);
+            EXPECT_NEAR_VALUE(pixel[0], 0.25f, 1e-5f, "level 1 R");
+            EXPECT_NEAR_VALUE(pixel[2], 0.75f, 1e-5f, "level 1 B");
+            EXPECT_NEAR_VALUE(pixel[3], 1.0f, 1e-6f, "level 1 A");
+        }
+    }
+
+    // Levels past the coarsest one clamp to the 1x1 level.
+    options.level = 10;
+    OIIO::ImageBuf coarsest;
+    EXPECT_TRUE(applyPushPullFill(coarsest, src, options));
+    EXPECT_TRUE(coarsest.spec().width == 1 && coarsest.spec().height == 1);
+
+    // Offset data windows scale with the level.
+    OIIO::ImageSpec spec = src.spec();
+    spec.x               = 100;
+    spec.y               = 40;
+    spec.full_width      = 128;
+    spec.full_height     = 64;
+    OIIO::ImageBuf offset(spec);
+    EXPECT_TRUE(offset.set_pixels(offset.roi(), OIIO::TypeDesc::FLOAT, src.localpixels()));
+    options.level = 2;
+    OIIO::ImageBuf quarter;
+    EXPECT_TRUE(applyPushPullFill(quarter, offset, options));
+    EXPECT_TRUE(quarter.xbegin() == 25 && quarter.ybegin() == 10);
+    EXPECT_TRUE(quarter.spec().width == 4 && quarter.spec().height == 4);
+    EXPECT_TRUE(quarter.spec().full_width == 32 && quarter.spec().full_height == 16);
+}
+
+static void testCoveragePlaneMatchesRgba()
+{
+    const OIIO::ImageBuf rgba = makeRgbaFloatHole();
+    OIIO::ImageBuf expected;
+    EXPECT_TRUE(applyPushPullFill(expected, rgba, 1));
+
+    // Unpremultiplied color with garbage under the hole; premultiplying by coverage must clear it.
+    OIIO::ImageBuf color(OIIO::ImageSpec(16, 16, 3, OIIO::TypeDesc::FLOAT));
+    OIIO::ImageBuf coverage(OIIO::ImageSpec(16, 16, 1, OIIO::TypeDesc::FLOAT));
+    float* colorPixels    = static_cast<float*>(color.localpixels());
+    float* coveragePixels = static_cast<float*>(coverage.localpixels());
+    const float* source   = static_cast<const float*>(rgba.localpixels());
+    for (size_t i = 0; i < 16u * 16u; ++i) {
+        const float alpha     = source[i * 4u + 3u];
+        coveragePixels[i]       = alpha;
+        colorPixels[i * 3u]     = alpha > 0.0f ? 0.25f : 9.0f;
+        colorPixels[i * 3u + 1] = alpha > 0.0f ? 0.50f : 9.0f;
+        colorPixels[i * 3u + 2] = alpha > 0.0f ? 0.75f : 9.0f;
+    }
+
+    PushPullOptions options;
+    options.nthreads = 2;
+    OIIO::ImageBuf filled;
+    EXPECT_TRUE(applyPushPullFill(filled, color, coverage, options, true));
+    expectImageClose(filled, expected, 1e-6f, "coverage plane");
+    EXPECT_TRUE(filled.spec().alpha_channel == 3 && filled.spec().channelnames[3] == "A");
+
+    const int rgb[]              = { 0, 1, 2 };
+    OIIO::ImageBuf premultiplied = OIIO::ImageBufAlgo::channels(rgba, 3, rgb);
+    OIIO::ImageBuf unscaled;
+    EXPECT_TRUE(applyPushPullFill(unscaled, premultiplied, coverage, options, false));
+    expectImageClose(unscaled, expected, 1e-6f, "coverage plane without premultiply");
+
+    OIIO::ImageBuf wrongCoverage(OIIO::ImageSpec(16, 16, 2, OIIO::TypeDesc::FLOAT));
+    OIIO::ImageBuf rejected;
+    EXPECT_TRUE(!applyPushPullFill(rejected, color, wrongCoverage, options, true));
+}
+
+static void testCoverageBitsMatchPlane()
+{
+    // Wider than two 64-pixel words, with fully covered, empty and mixed runs.
+    constexpr int width  = 150;
+    constexpr int height = 6;
+    OIIO::ImageBuf color(OIIO::ImageSpec(width, height, 3, OIIO::TypeDesc::FLOAT));
+    OIIO::ImageBuf coverage(OIIO::ImageSpec(width, height, 1, OIIO::TypeDesc::FLOAT));
+    float* colorPixels    = static_cast<float*>(color.localpixels());
+    float* coveragePixels = static_cast<float*>(coverage.localpixels());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const size_t i          = static_cast<size_t>(y) * width + static_cast<size_t>(x);
+            const bool covered      = x < 64 || (x >= 128 && (x + y) % 3 != 0);
+            coveragePixels[i]       = covered ? 1.0f : 0.0f;
+            colorPixels[i * 3u]     = covered ? 0.01f * static_cast<float>(x) : 9.0f;
+            colorPixels[i * 3u + 1] = covered ? 0.10f * static_cast<float>(y) : 9.0f;
+            colorPixels[i * 3u + 2] = 0.5f;
+        }
+    }
+
+    PushPullCoverageBits bits;
+    EXPECT_TRUE(packCoverageBits(coverage, &bits, 2));
+    EXPECT_TRUE(bits.wordsPerRow == 3u && bits.words.size() == 3u * height);
+
+    PushPullOptions options;
+    options.nthreads = 2;
+    for (const bool premultiply : { true, false }) {
+        OIIO::ImageBuf expected;
+        OIIO::ImageBuf filled;
+        EXPECT_TRUE(applyPushPullFill(expected, color, coverage, options, premultiply));
+        EXPECT_TRUE(applyPushPullFill(filled, color, bits, options, premultiply));
+        expectImageClose(filled, expected, 0.0f, premultiply ? "coverage bits" : "coverage bits without premultiply");
+    }
+
+    coveragePixels[7] = 0.5f;
+    PushPullCoverageBits partial;
+    EXPECT_TRUE(!packCoverageBits(coverage, &partial));
+    EXPECT_TRUE(partial.words.empty());
+}
+
+static void testNormalMapFill()
+{
+    // Unsigned normal map: two tilted halves with a hole across their seam, color premultiplied by alpha.
+    constexpr int width  = 16;
+    constexpr int height = 16;
+    OIIO::ImageSpec spec(width, height, 4, OIIO::TypeDesc::FLOAT);
+    spec.alpha_channel = 3;
+    OIIO::ImageBuf src(spec);
+    float* pixels = static_cast<float*>(src.localpixels());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const bool hole   = x >= 5 && x <= 10 && y >= 4 && y <= 11;
+            const float alpha = hole ? 0.0f : 1.0f;
+            const float n[3]  = { x < 8 ? 0.6f : 0.0f, x < 8 ? 0.0f : -0.6f, 0.8f };
+            float* pixel      = pixels + (static_cast<size_t>(y) * width + static_cast<size_t>(x)) * 4u;
+            for (int c = 0; c < 3; ++c) {
+                pixel[c] = (n[c] * 0.5f + 0.5f) * alpha;
+            }
+            pixel[3] = alpha;
+        }
+    }
+
+    PushPullOptions options;
+    options.nthreads  = 2;
+    options.normalMap = true;
+    OIIO::ImageBuf filled;
+    EXPECT_TRUE(applyPushPullFill(filled, src, options));
+    EXPECT_TRUE(filled.nchannels() == 4 && filled.spec().format == OIIO::TypeDesc::FLOAT);
+
+    const float* out = static_cast<const float*>(filled.localpixels());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const size_t base = (static_cast<size_t>(y) * width + static_cast<size_t>(x)) * 4u;
+            float n[3];
+            for (int c = 0; c < 3; ++c) {
+                n[c] = (out[base + c] - 0.5f) * 2.0f;
+            }
+            EXPECT_NEAR_VALUE(std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]), 1.0f, 1e-4f, "filled normal length");
+            EXPECT_NEAR_VALUE(out[base + 3], 1.0f, 0.0f, "filled normal alpha");
+            EXPECT_TRUE(n[0] >= -1e-4f && n[1] <= 1e-4f && n[2] > 0.7f);
+            if (pixels[base + 3] > 0.0f) {
+                for (int c = 0; c < 3; ++c) {
+                    EXPECT_NEAR_VALUE(out[base + c], pixels[base + c], 1e-5f, "covered normal");
+                }
+            }
+        }
+    }
+
+    // The same fill written as uint16, and from straight RGB plus a coverage plane.
+    OIIO::ImageBuf src16 = src.copy(OIIO::TypeDesc::UINT16);
+    OIIO::ImageBuf filled16;
+    EXPECT_TRUE(applyPushPullFill(filled16, src16, options));
+    EXPECT_TRUE(filled16.spec().format == OIIO::TypeDesc::UINT16);
+    std::vector<float> wide;
+    EXPECT_TRUE(readFloatPixels(filled16, &wide));
+    for (size_t i = 0; i < wide.size() && i < static_cast<size_t>(width * height * 4); ++i) {
+        EXPECT_NEAR_VALUE(wide[i], out[i], 2.0f / 65535.0f, "uint16 normal fill");
+    }
+
+    OIIO::ImageBuf color(OIIO::ImageSpec(width, height, 3, OIIO::TypeDesc::FLOAT));
+    OIIO::ImageBuf coverage(OIIO::ImageSpec(width, height, 1, OIIO::TypeDesc::FLOAT));
+    float* colorPixels    = static_cast<float*>(color.localpixels());
+    float* coveragePixels = static_cast<float*>(coverage.localpixels());
+    for (size_t i = 0; i < static_cast<size_t>(width * height); ++i) {
+        const float alpha = pixels[i * 4u + 3u];
+        coveragePixels[i] = alpha;
+        for (int c = 0; c < 3; ++c) {
+            colorPixels[i * 3u + c] = alpha > 0.0f ? pixels[i * 4u + c] : 9.0f;
+        }
+    }
+    OIIO::ImageBuf fromCoverage;
+    EXPECT_TRUE(applyPushPullFill(fromCoverage, color, coverage, options, true));
+    expectImageClose(fromCoverage, filled, 1e-6f, "normal fill from coverage plane");
+
+    // Covered pixels come back as the unit vector of what was stored, including the folded lower hemisphere.
+    const float vectors[4][3] = { { 0.18f, 0.24f, -0.4f }, { -0.9f, 0.1f, -0.2f }, { 0.0f, 0.0f, -1.0f },
+                                  { 0.3f, -0.3f, 0.1f } };
+    OIIO::ImageBuf row(OIIO::ImageSpec(4, 1, 4, OIIO::TypeDesc::FLOAT));
+    float* rowPixels = static_cast<float*>(row.localpixels());
+    for (int i = 0; i < 4; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            rowPixels[i * 4 + c] = vectors[i][c] * 0.5f + 0.5f;
+        }
+        rowPixels[i * 4 + 3] = 1.0f;
+    }
+    OIIO::ImageBuf rowFilled;
+    EXPECT_TRUE(applyPushPullFill(rowFilled, row, options));
+    const float* rowOut = static_cast<const float*>(rowFilled.localpixels());
+    for (int i = 0; i < 4; ++i) {
+        const float* v  = vectors[i];
+        const float len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        for (int c = 0; c < 3; ++c) {
+            EXPECT_NEAR_VALUE(rowOut[i * 4 + c], v[c] / len * 0.5f + 0.5f, 1e-5f, "renormalized covered normal");
+        }
+    }
+
+    OIIO::ImageBuf rejected;
+    EXPECT_TRUE(!applyPushPullFill(rejected, makeGrayFloatHole(), options));
+}
+
+static void testInPlaceFill()
+{
+    // Level 0 fills write over the source pixels and match a fill into a separate result.
+    const OIIO::ImageBuf sources[] = { makeRgbaFloatHole(), makeRgbaHalfHole(), makeGrayHalfHole(),
+                                       makeRgbaFloatHole().copy(OIIO::TypeDesc::UINT8) };
+    for (const OIIO::ImageBuf& source : sources) {
+        OIIO::ImageBuf expected;
+        EXPECT_TRUE(applyPushPullFill(expected, source, 1));
+        OIIO::ImageBuf image     = source;
+        const void* sourcePixels = image.localpixels();
+        EXPECT_TRUE(applyPushPullFill(image, image, 1));
+        EXPECT_TRUE(image.localpixels() == sourcePixels);
+        EXPECT_TRUE(image.spec().format == source.spec().format);
+        expectImageClose(image, expected, 0.0f, "in-place fill");
+    }
+
+    // Reduced results do not fit the source pixels and replace them.
+    OIIO::ImageBuf image = makeRgbaFloatHole();
+    PushPullOptions options;
+    options.nthreads = 1;
+    options.level    = 1;
+    OIIO::ImageBuf expected;
+    EXPECT_TRUE(applyPushPullFill(expected, image, options));
+    EXPECT_TRUE(applyPushPullFill(image, image, options));
+    EXPECT_TRUE(image.spec().width == 8 && image.spec().height == 8);
+    expectImageClose(image, expected, 0.0f, "in-place level 1 fill");
+}
+
+static void testSparseTopLevelMatchesDense()
+{
+    // 5x4 tiles of 64 pixels where only two islands hold data, one across a tile corner.
+    constexpr int width  = 320;
+    constexpr int height = 256;
+    OIIO::ImageSpec spec(width, height, 4, OIIO::TypeDesc::FLOAT);
+    spec.alpha_channel = 3;
+    OIIO::ImageBuf canvas(spec);
+    float* pixels = static_cast<float*>(canvas.localpixels());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const bool island = (x >= 60 && x < 70 && y >= 58 && y < 72)
+                                || (x >= 200 && x < 230 && y >= 150 && y < 190);
+            const float alpha = island ? 1.0f : 0.0f;
+            float* pixel      = pixels + (static_cast<size_t>(y) * width + static_cast<size_t>(x)) * 4u;
+            pixel[0]          = alpha * static_cast<float>(x) / width;
+            pixel[1]          = alpha * static_cast<float>(y) / height;
+            pixel[2]          = alpha * 0.5f;
+            pixel[3]          = alpha;
+        }
+    }
+
+    PushPullOptions dense;
+    dense.nthreads       = 2;
+    dense.sparseTopLevel = false;
+    PushPullOptions sparse;
+    sparse.nthreads = 2;
+    for (const OIIO::TypeDesc format : { OIIO::TypeDesc::FLOAT, OIIO::TypeDesc::UINT16, OIIO::TypeDesc::HALF }) {
+        const OIIO::ImageBuf source = format == OIIO::TypeDesc::FLOAT ? canvas : canvas.copy(format);
+        OIIO::ImageBuf expected;
+        OIIO::ImageBuf filled;
+        EXPECT_TRUE(applyPushPullFill(expected, source, dense));
+        EXPECT_TRUE(applyPushPullFill(filled, source, sparse));
+        EXPECT_TRUE(filled.spec().format == format);
+        expectImageClose(filled, expected, format == OIIO::TypeDesc::FLOAT ? 0.0f : 1e-3f, "sparse top level");
+    }
+
+    OIIO::ImageBuf expected;
+    EXPECT_TRUE(applyPushPullFill(expected, canvas, dense));
+    const void* canvasPixels = canvas.localpixels();
+    EXPECT_TRUE(applyPushPullFill(canvas, canvas, sparse));
+    EXPECT_TRUE(canvas.localpixels() == canvasPixels);
+    expectImageClose(canvas, expected, 0.0f, "in-place sparse top level");
+}
+
+static void testScatteredSamples()
+{
+    // One sample per four pixels starts at the top level and matches the fill of the splatted image.
+    constexpr int size = 32;
+    OIIO::ImageSpec spec(size, size, 4, OIIO::TypeDesc::FLOAT);
+    spec.alpha_channel = 3;
+    OIIO::ImageBuf splat(spec);
+    float* pixels = static_cast<float*>(splat.localpixels());
+    std::fill_n(pixels, static_cast<size_t>(size) * size * 4u, 0.0f);
+    std::vector<PushPullSample> samples;
+    for (int y = 0; y < size; y += 2) {
+        for (int x = 0; x < size; x += 2) {
+            PushPullSample& sample = samples.emplace_back();
+            sample.x               = static_cast<float>(x) + 0.5f;
+            sample.y               = static_cast<float>(y) + 0.5f;
+            sample.color[0]        = static_cast<float>(x) / size;
+            sample.color[1]        = static_cast<float>(y) / size;
+            sample.color[2]        = 0.25f;
+            float* pixel           = pixels + (static_cast<size_t>(y) * size + static_cast<size_t>(x)) * 4u;
+            std::copy_n(sample.color, 3, pixel);
+            pixel[3] = 1.0f;
+        }
+    }
+    PushPullOptions options;
+    options.nthreads = 2;
+    OIIO::ImageBuf expected;
+    OIIO::ImageBuf filled;
+    EXPECT_TRUE(applyPushPullFill(expected, splat, options));
+    EXPECT_TRUE(applyPushPullFillSamples(filled, samples, size, size, 3, options));
+    expectImageClose(filled, expected, 0.0f, "top-level samples");
+
+    // Two samples in a 256x256 target start at the 2x2 level and are averaged by weight over the whole result.
+    std::vector<PushPullSample> sparse(2);
+    sparse[0].x        = 40.0f;
+    sparse[0].y        = 90.0f;
+    sparse[1].x        = 41.0f;
+    sparse[1].y        = 91.0f;
+    sparse[1].color[0] = 1.0f;
+    sparse[1].weight   = 3.0f;
+    OIIO::ImageBuf gray;
+    EXPECT_TRUE(applyPushPullFillSamples(gray, sparse, 256, 256, 1, options));
+    EXPECT_TRUE(gray.spec().width == 256 && gray.spec().height == 256 && gray.nchannels() == 2);
+    EXPECT_TRUE(gray.spec().alpha_channel == 1 && gray.spec().channelnames[0] == "Y");
+    std::vector<float> grayPixels;
+    EXPECT_TRUE(readFloatPixels(gray, &grayPixels));
+    for (size_t i = 0; i < grayPixels.size(); i += 2) {
+        EXPECT_NEAR_VALUE(grayPixels[i], 0.75f, 1e-5f, "weighted sample mean");
+        EXPECT_NEAR_VALUE(grayPixels[i + 1], 1.0f, 0.0f, "sample fill alpha");
+    }
+
+    options.level = 1;
+    OIIO::ImageBuf half;
+    EXPECT_TRUE(applyPushPullFillSamples(half, sparse, 256, 256, 1, options));
+    EXPECT_TRUE(half.spec().width == 128 && half.spec().height == 128);
+
+    OIIO::ImageBuf rejected;
+    EXPECT_TRUE(!applyPushPullFillSamples(rejected, sparse, 256, 256, 2, options));
+    EXPECT_TRUE(!applyPushPullFillSamples(rejected, sparse, 0, 256, 1, options));
+}
+
+static void testMembraneFill()
+{
+    // Known strips at both ends of a 64x64 image: the membrane solution across the hole between them is the linear
+    // ramp from the last pixel of one strip to the first of the other, with the known pixels kept.
+    constexpr int size = 64;
+    OIIO::ImageSpec spec(size, size, 4, OIIO::TypeDesc::FLOAT);
+    spec.alpha_channel = 3;
+    OIIO::ImageBuf image(spec);
+    float* pixels = static_cast<float*>(image.localpixels());
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float* pixel     = pixels + (static_cast<size_t>(y) * size + static_cast<size_t>(x)) * 4u;
+            const bool known = x < 8 || x >= 56;
+            pixel[0]         = known && x >= 56 ? 1.0f : 0.0f;
+            pixel[1]         = pixel[0];
+            pixel[2]         = known ? 0.5f : 0.0f;
+            pixel[3]         = known ? 1.0f : 0.0f;
+        }
+    }
+
+    PushPullOptions options;
+    options.nthreads = 2;
+    OIIO::ImageBuf pushed;
+    EXPECT_TRUE(applyPushPullFill(pushed, image, options));
+    options.engine = FillEngine::Membrane;
+    OIIO::ImageBuf membrane;
+    EXPECT_TRUE(applyPushPullFill(membrane, image, options));
+
+    std::vector<float> pushedPixels;
+    std::vector<float> membranePixels;
+    EXPECT_TRUE(readFloatPixels(pushed, &pushedPixels));
+    EXPECT_TRUE(readFloatPixels(membrane, &membranePixels));
+    const size_t floats = static_cast<size_t>(size) * size * 4u;
+    if (membranePixels.size() != floats || pushedPixels.size() != floats) {
+        EXPECT_TRUE(false);
+        return;
+    }
+    float pushedError   = 0.0f;
+    float membraneError = 0.0f;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const size_t base = (static_cast<size_t>(y) * size + static_cast<size_t>(x)) * 4u;
+            const float ramp  = std::clamp((static_cast<float>(x) - 7.0f) / 49.0f, 0.0f, 1.0f);
+            pushedError       = std::max(pushedError, std::fabs(pushedPixels[base] - ramp));
+            membraneError     = std::max(membraneError, std::fabs(membranePixels[base] - ramp));
+            EXPECT_NEAR_VALUE(membranePixels[base + 2], 0.5f, 1e-4f, "membrane constant channel");
+            EXPECT_NEAR_VALUE(membranePixels[base + 3], 1.0f, 0.0f, "membrane alpha");
+            if (x < 8 || x >= 56) {
+                EXPECT_NEAR_VALUE(membranePixels[base], pixels[base], 0.0f, "membrane known pixel");
+            }
+        }
+    }
+    EXPECT_TRUE(membraneError < 0.03f);
+    EXPECT_TRUE(membraneError < pushedError * 0.5f);
+
+    // Levels below the result and the normal-map encoding run through the same solve.
+    options.level = 1;
+    OIIO::ImageBuf half;
+    EXPECT_TRUE(applyPushPullFill(half, image, options));
+    EXPECT_TRUE(half.spec().width == size / 2 && half.spec().height == size / 2);
+    options.level     = 0;
+    options.normalMap = true;
+    OIIO::ImageBuf normals;
+    EXPECT_TRUE(applyPushPullFill(normals, image, options));
+}
+
+static void testDilateFill()
+{
+    // Two covered pixels on an empty 32x32 image: every other pixel takes the color of the nearer one, and the
+    // distance field holds the distance to it.
+    constexpr int size = 32;
+    const int seedX[]  = { 4, 27 };
+    const int seedY[]  = { 4, 20 };
+    const float red[]  = { 1.0f, 0.2f };
+    OIIO::ImageSpec spec(size, size, 4, OIIO::TypeDesc::FLOAT);
+    spec.alpha_channel = 3;
+    OIIO::ImageBuf image(spec);
+    OIIO::ImageBuf color(OIIO::ImageSpec(size, size, 3, OIIO::TypeDesc::FLOAT));
+    OIIO::ImageBuf coverage(OIIO::ImageSpec(size, size, 1, OIIO::TypeDesc::FLOAT));
+    float* pixels         = static_cast<float*>(image.localpixels());
+    float* colorPixels    = static_cast<float*>(color.localpixels());
+    float* coveragePixels = static_cast<float*>(coverage.localpixels());
+    std::fill_n(pixels, static_cast<size_t>(size) * size * 4u, 0.0f);
+    std::fill_n(colorPixels, static_cast<size_t>(size) * size * 3u, 9.0f);
+    std::fill_n(coveragePixels, static_cast<size_t>(size) * size, 0.0f);
+    for (int i = 0; i < 2; ++i) {
+        const size_t index          = static_cast<size_t>(seedY[i]) * size + static_cast<size_t>(seedX[i]);
+        pixels[index * 4u]          = red[i];
+        pixels[index * 4u + 1]      = 0.5f;
+        pixels[index * 4u + 3]      = 1.0f;
+        colorPixels[index * 3u]     = red[i];
+        colorPixels[index * 3u + 1] = 0.5f;
+        colorPixels[index * 3u + 2] = 0.0f;
+        coveragePixels[index]       = 1.0f;
+    }
+
+    PushPullOptions options;
+    options.nthreads = 2;
+    options.engine   = FillEngine::Dilate;
+    OIIO::ImageBuf distance;
+    options.distance = &distance;
+    OIIO::ImageBuf dilated;
+    EXPECT_TRUE(applyPushPullFill(dilated, image, options));
+    OIIO::ImageBuf planeDistance;
+    options.distance = &planeDistance;
+    OIIO::ImageBuf fromPlane;
+    EXPECT_TRUE(applyPushPullFill(fromPlane, color, coverage, options, true));
+    options.dilateRadius = 6;
+    options.distance     = nullptr;
+    OIIO::ImageBuf limited;
+    EXPECT_TRUE(applyPushPullFill(limited, image, options));
+
+    std::vector<float> dilatedPixels;
+    std::vector<float> planePixels;
+    std::vector<float> limitedPixels;
+    std::vector<float> distances;
+    EXPECT_TRUE(readFloatPixels(dilated, &dilatedPixels));
+    EXPECT_TRUE(readFloatPixels(fromPlane, &planePixels));
+    EXPECT_TRUE(readFloatPixels(limited, &limitedPixels));
+    EXPECT_TRUE(readFloatPixels(distance, &distances));
+    const size_t count = static_cast<size_t>(size) * size;
+    if (dilatedPixels.size() != count * 4u || planePixels.size() != count * 4u || limitedPixels.size() != count * 4u
+        || distances.size() != count) {
+        EXPECT_TRUE(false);
+        return;
+    }
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float nearest[2];
+            for (int i = 0; i < 2; ++i) {
+                const float dx = static_cast<float>(seedX[i] - x);
+                const float dy = static_cast<float>(seedY[i] - y);
+                nearest[i]     = std::sqrt(dx * dx + dy * dy);
+            }
+            const size_t index = static_cast<size_t>(y) * size + static_cast<size_t>(x);
+            const int seed     = nearest[0] <= nearest[1] ? 0 : 1;
+            const float dist   = nearest[seed];
+            EXPECT_NEAR_VALUE(distances[index], dist, 1e-4f, "dilation distance");
+            EXPECT_NEAR_VALUE(dilatedPixels[index * 4u + 3], 1.0f, 0.0f, "dilation alpha");
+            EXPECT_NEAR_VALUE(dilatedPixels[index * 4u + 1], 0.5f, 1e-6f, "dilation constant channel");
+            EXPECT_NEAR_VALUE(planePixels[index * 4u + 3], 1.0f, 0.0f, "coverage plane dilation alpha");
+            // Pixels about as far from both covered pixels may take either.
+            if (std::fabs(nearest[0] - nearest[1]) > 1.0f) {
+                EXPECT_NEAR_VALUE(dilatedPixels[index * 4u], red[seed], 1e-6f, "dilation nearest color");
+                EXPECT_NEAR_VALUE(planePixels[index * 4u], red[seed], 1e-6f, "coverage plane nearest color");
+            }
+            EXPECT_NEAR_VALUE(limitedPixels[index * 4u + 3], dist <= 6.0f ? 1.0f : 0.0f, 0.0f,
+                              "dilation radius alpha");
+            if (dist > 6.0f) {
+                EXPECT_NEAR_VALUE(limitedPixels[index * 4u], 0.0f, 0.0f, "dilation radius color");
+            }
+        }
+    }
+    EXPECT_TRUE(planeDistance.spec().width == size && planeDistance.nchannels() == 1);
+}
+
 }  // namespace
 
 int main()
@@ -379,6 +1030,18 @@ int main()
     testRgbaHalfPushPull();
     testGrayHalfPushPull();
     testUint16FormatPreserved();
+    testBandedMatchesInMemory();
+    testDataWindowRegionAndMargin();
+    testPyramidMipLevels();
+    testResultAtPyramidLevel();
+    testCoveragePlaneMatchesRgba();
+    testCoverageBitsMatchPlane();
+    testNormalMapFill();
+    testInPlaceFill();
+    testSparseTopLevelMatchesDense();
+    testScatteredSamples();
+    testMembraneFill();
+    testDilateFill();
 
     if (g_failures != 0) {
         std::cerr << g_failures << " push-pull test expectation(s) failed.\n";
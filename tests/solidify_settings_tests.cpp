@@ -58,8 +58,13 @@ static void expectConfigA(const Settings& value)
     EXPECT_TRUE(value.conEnable == false);
     EXPECT_TRUE(value.numThreads == 8);
     EXPECT_TRUE(value.queueLimit == 5);
+    EXPECT_TRUE(value.incremental == true);
     EXPECT_TRUE(value.verbosity == 5);
     EXPECT_TRUE(value.alphaGamma == 2.5f);
+    EXPECT_TRUE(value.fillMargin == 16);
+    EXPECT_TRUE(value.fillEngine == FillEngine_Membrane);
+    EXPECT_TRUE(value.dilateRadius == 12);
+    EXPECT_TRUE(value.dilateDistance == true);
     EXPECT_TRUE(value.mask_substr.size() == 1 && value.mask_substr[0] == "_maskA");
     EXPECT_TRUE(value.normMode == 2);
     EXPECT_TRUE(value.normNames.size() == 1 && value.normNames[0] == "normalA");
@@ -74,6 +79,9 @@ static void expectConfigA(const Settings& value)
     EXPECT_TRUE(value.fileFormat == 6);
     EXPECT_TRUE(value.defBDepth == 5);
     EXPECT_TRUE(value.bitDepth == 4);
+    EXPECT_TRUE(value.outputScale == 2);
+    EXPECT_TRUE(value.mipmapOutput == true);
+    EXPECT_TRUE(value.mipFilter == "lanczos3");
     EXPECT_TRUE(value.tiffCompression == TiffCompression_Lzw);
     EXPECT_TRUE(value.tiffZipLevel == 9);
     EXPECT_TRUE(value.exrCompression == ExrCompression_Piz);
@@ -89,6 +97,28 @@ static void expectConfigA(const Settings& value)
     EXPECT_TRUE(value.jpegxlEffort == 4);
     EXPECT_TRUE(value.jpegxlSpeed == 2);
     EXPECT_TRUE(value.rawRot == 6);
+    EXPECT_TRUE(value.outOfCore == true);
+    EXPECT_TRUE(value.cacheSizeMB == 512);
+    EXPECT_TRUE(value.zeroCopy == true);
+    EXPECT_TRUE(value.outSuffix.empty());
+    EXPECT_TRUE(value.outputs.size() == 2);
+    if (value.outputs.size() == 2) {
+        const Settings& mask = value.outputs[0];
+        EXPECT_TRUE(mask.outSuffix == "_mask");
+        EXPECT_TRUE(mask.fileFormat == 2);
+        EXPECT_TRUE(mask.bitDepth == 0);
+        EXPECT_TRUE(mask.alphaMode == 2);
+        EXPECT_TRUE(mask.pngCompressionLevel == 9);
+        EXPECT_TRUE(mask.jpegQuality == 77);
+        EXPECT_TRUE(mask.outputs.empty());
+
+        const Settings& fill = value.outputs[1];
+        EXPECT_TRUE(fill.outSuffix == "_fill");
+        EXPECT_TRUE(fill.fileFormat == 6);
+        EXPECT_TRUE(fill.exrCompression == ExrCompression_Dwaa);
+        EXPECT_TRUE(fill.mipmapOutput == false);
+        EXPECT_TRUE(fill.outputScale == 2);
+    }
 }
 
 static void expectConfigB(const Settings& value)
@@ -100,8 +130,13 @@ static void expectConfigB(const Settings& value)
     EXPECT_TRUE(value.conEnable == true);
     EXPECT_TRUE(value.numThreads == 2);
     EXPECT_TRUE(value.queueLimit == 1);
+    EXPECT_TRUE(value.incremental == false);
     EXPECT_TRUE(value.verbosity == 1);
     EXPECT_TRUE(value.alphaGamma == 1.0f);
+    EXPECT_TRUE(value.fillMargin == -1);
+    EXPECT_TRUE(value.fillEngine == FillEngine_Dilate);
+    EXPECT_TRUE(value.dilateRadius == 0);
+    EXPECT_TRUE(value.dilateDistance == false);
     EXPECT_TRUE(value.mask_substr.size() == 2 && value.mask_substr[0] == "_maskB" && value.mask_substr[1] == "_alphaB");
     EXPECT_TRUE(value.normMode == 0);
     EXPECT_TRUE(value.normNames.size() == 2 && value.normNames[0] == "normalB" && value.normNames[1] == "worldB");
@@ -116,6 +151,9 @@ static void expectConfigB(const Settings& value)
     EXPECT_TRUE(value.fileFormat == -1);
     EXPECT_TRUE(value.defBDepth == 1);
     EXPECT_TRUE(value.bitDepth == -1);
+    EXPECT_TRUE(value.outputScale == 16);
+    EXPECT_TRUE(value.mipmapOutput == false);
+    EXPECT_TRUE(value.mipFilter.empty());
     EXPECT_TRUE(value.tiffCompression == TiffCompression_PackBits);
     EXPECT_TRUE(value.tiffZipLevel == 1);
     EXPECT_TRUE(value.exrCompression == ExrCompression_Dwab);
@@ -131,6 +169,10 @@ static void expectConfigB(const Settings& value)
     EXPECT_TRUE(value.jpegxlEffort == 9);
     EXPECT_TRUE(value.jpegxlSpeed == 4);
     EXPECT_TRUE(value.rawRot == 3);
+    EXPECT_TRUE(value.outOfCore == false);
+    EXPECT_TRUE(value.cacheSizeMB == 64);
+    EXPECT_TRUE(value.zeroCopy == false);
+    EXPECT_TRUE(value.outputs.empty());
 }
 
 static void testReloadUpdatesSettingsAndDefaults()
@@ -145,8 +187,13 @@ MaskNames = ["_maskA"]
 Console = false
 Threads = 8
 QueueLimit = 5
+Incremental = true
 Verbosity = 5
 AlphaGamma = 2.5
+FillMargin = 16
+FillEngine = 1
+DilateRadius = 12
+DilateDistance = true
 
 [Normalize]
 NormalizeMode = 2
@@ -166,6 +213,9 @@ DefaultFormat = 7
 FileFormat = 6
 DefaultBit = 5
 BitDepth = 4
+OutputScale = 2
+MipMap = true
+MipFilter = "lanczos3"
 
 [Encoding]
 TiffCompression = "lzw"
@@ -185,6 +235,23 @@ JpegXLSpeed = 2
 
 [CameraRaw]
 RawRotation = 6
+
+[Memory]
+OutOfCore = true
+CacheSizeMB = 512
+ZeroCopy = true
+
+[[Outputs]]
+Suffix = "_mask"
+FileFormat = 2
+BitDepth = 0
+ExportAlpha = 2
+PngLevel = 12
+
+[[Outputs]]
+Suffix = "_fill"
+OpenEXRCompression = "dwaa"
+MipMap = false
 )toml";
 
     static constexpr const char* kConfigB = R"toml(
@@ -199,6 +266,9 @@ Threads = 2
 QueueLimit = 1
 Verbosity = 1
 AlphaGamma = 1.0
+FillMargin = -5
+FillEngine = 7
+DilateRadius = -3
 
 [Normalize]
 NormalizeMode = 0
@@ -218,6 +288,8 @@ DefaultFormat = 2
 FileFormat = -1
 DefaultBit = 1
 BitDepth = -1
+OutputScale = 40
+MipMap = false
 
 [Encoding]
 TiffCompression = "packbits"
@@ -237,6 +309,11 @@ JpegXLSpeed = 4
 
 [CameraRaw]
 RawRotation = 3
+
+[Memory]
+OutOfCore = false
+CacheSizeMB = 16
+ZeroCopy = false
 )toml";
 
     const fs::path testDir = fs::temp_directory_path() / "solidify_settings_tests";